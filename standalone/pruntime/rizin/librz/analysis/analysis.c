@@ -105,6 +105,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	analysis->cpp_abi = RZ_ANALYSIS_CPP_ABI_ITANIUM;
 	analysis->opt.depth = 32;
 	analysis->opt.noncode = false; // do not analyze data by default
+	analysis->opt.op_arena = true;
 	rz_spaces_init(&analysis->meta_spaces, "CS");
 	rz_event_hook(analysis->meta_spaces.event, RZ_SPACE_EVENT_UNSET, meta_unset_for, NULL);
 	rz_event_hook(analysis->meta_spaces.event, RZ_SPACE_EVENT_COUNT, meta_count_for, NULL);
@@ -202,6 +203,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	rz_list_free(a->imports);
 	rz_str_constpool_fini(&a->constpool);
 	ht_pp_free(a->ht_global_var);
+	rz_arena_free(a->op_arena);
 	free(a);
 	return NULL;
 }
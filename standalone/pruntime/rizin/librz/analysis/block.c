@@ -200,8 +200,14 @@ RZ_API void rz_analysis_block_set_size(RzAnalysisBlock *block, ut64 size) {
 	RzAnalysisFunction *fcn;
 	RzListIter *iter;
 	rz_list_foreach (block->fcns, iter, fcn) {
-		if (fcn->meta._min != UT64_MAX && fcn->meta._max == block->addr + block->size) {
+		if (fcn->meta._min == UT64_MAX) {
+			continue;
+		}
+		if (block->addr + size > fcn->meta._max) {
 			fcn->meta._max = block->addr + size;
+		} else if (fcn->meta._max == block->addr + block->size) {
+			// we were the maximum before, but another block may end after us now
+			fcn->meta._min = UT64_MAX;
 		}
 	}
 
@@ -234,7 +240,7 @@ RZ_API bool rz_analysis_block_relocate(RzAnalysisBlock *block, ut64 addr, ut64 s
 				fcn->meta._min = UT64_MAX;
 				continue;
 			}
-			if (block->addr < fcn->meta._min) {
+			if (addr < fcn->meta._min) {
 				// less than the minimum, we know that we are the minimum afterwards.
 				fcn->meta._min = addr;
 			} else if (block->addr == fcn->meta._min && addr != block->addr) {
@@ -360,6 +366,8 @@ RZ_API bool rz_analysis_block_merge(RzAnalysisBlock *a, RzAnalysisBlock *b) {
 
 	// kill b completely
 	rz_rbtree_aug_delete(&a->analysis->bb_tree, &b->addr, __bb_addr_cmp, NULL, __block_free_rb, NULL, __max_end);
+	// a grew, so the maximum ends on its path must be updated as well
+	rz_rbtree_aug_update_sum(a->analysis->bb_tree, &a->addr, &a->_rb, __bb_addr_cmp, NULL, __max_end);
 
 	// invalidate ranges of a's functions
 	rz_list_foreach (a->fcns, iter, fcn) {
@@ -96,6 +96,12 @@ RZ_API RzAnalysisCond *rz_analysis_cond_new_from_op(RzAnalysisOp *op) {
 	}
 	//v->reg[0] = op->src[0];
 	//v->reg[1] = op->src[1];
+	if (op->arena) {
+		// the values are dropped together with the arena, the cond needs its own
+		cond->arg[0] = op->src[0] ? rz_analysis_value_copy(op->src[0]) : NULL;
+		cond->arg[1] = op->src[1] ? rz_analysis_value_copy(op->src[1]) : NULL;
+		return cond;
+	}
 	cond->arg[0] = op->src[0];
 	op->src[0] = NULL;
 	cond->arg[1] = op->src[1];
@@ -5,6 +5,7 @@
 #include <rz_analysis.h>
 #include <rz_util.h>
 #include <rz_diff.h>
+#include <rz_msg_digest.h>
 
 RZ_API RzAnalysisDiff *rz_analysis_diff_new(void) {
 	RzAnalysisDiff *diff = RZ_NEW0(RzAnalysisDiff);
@@ -172,110 +173,438 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 	return true;
 }
 
-RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
-	RzAnalysisFunction *fcn, *fcn2, *mfcn, *mfcn2;
-	RzListIter *iter, *iter2;
-	double t, ot, sizes_div;
+/*
+ * Functions are matched in stages so that the expensive distance is computed
+ * only for likely pairs:
+ *  1. functions with the same name, or without a name as before
+ *  2. functions with the same fingerprint and number of blocks
+ *  3. functions whose fingerprints share a MinHash band, or every function of
+ *     similar size when there are only a few of them
+ * The distances of every stage are computed in parallel, while the pairs are
+ * assigned in the order of fcns1 as before.
+ */
 
-	if (!analysis) {
-		return false;
+#define DIFF_SHINGLE_SIZE   4
+#define DIFF_MINHASH_ROWS   2
+#define DIFF_MINHASH_BANDS  8
+#define DIFF_MINHASH_SIZE   (DIFF_MINHASH_ROWS * DIFF_MINHASH_BANDS)
+#define DIFF_BRUTE_WINDOW   32 ///< similar sized functions compared in full when there are no more than these
+#define DIFF_MAX_CANDIDATES 64 ///< most similar candidates kept for each function
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	ut32 minhash[DIFF_MINHASH_SIZE];
+	bool has_minhash;
+	bool taken;
+} DiffFcn;
+
+typedef struct {
+	DiffFcn *df;
+	double t;
+} DiffCandidate;
+
+typedef struct {
+	DiffFcn *df; ///< function of fcns1
+	RzVector /*<DiffCandidate>*/ candidates; ///< sorted by decreasing similarity
+} DiffQuery;
+
+typedef struct {
+	DiffFcn *fcns2; ///< eligible functions of fcns2
+	size_t n_fcns2;
+	DiffFcn **by_size; ///< fcns2 sorted by fingerprint size
+	HtUP *bands[DIFF_MINHASH_BANDS]; ///< band value => RzPVector<DiffFcn *>
+	DiffQuery *queries;
+} DiffMatcher;
+
+static double diff_fcn_similarity(RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2) {
+	double t = 0;
+	if (!fcn->fingerprint || !fcn2->fingerprint) {
+		return 0;
 	}
-	if (analysis->cur && analysis->cur->diff_fcn) {
-		return (analysis->cur->diff_fcn(analysis, fcns1, fcns2));
+	rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
+		fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
+	return t;
+}
+
+static bool diff_fcn_sizes_match(RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2) {
+	double sizes_div;
+	if (fcn->fingerprint_size > fcn2->fingerprint_size) {
+		sizes_div = fcn2->fingerprint_size;
+		sizes_div /= fcn->fingerprint_size;
+	} else {
+		sizes_div = fcn->fingerprint_size;
+		sizes_div /= fcn2->fingerprint_size;
 	}
-	/* Compare functions with the same name */
-	rz_list_foreach (fcns1, iter, fcn) {
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn->name && fcn2->name && strcmp(fcn->name, fcn2->name)) {
-				continue;
+	return sizes_div >= RZ_ANALYSIS_DIFF_THRESHOLD;
+}
+
+static bool diff_fcn_is_candidate(RzAnalysisFunction *fcn) {
+	return fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL && fcn->fingerprint && fcn->fingerprint_size &&
+		(fcn->type == RZ_ANALYSIS_FCN_TYPE_FCN || fcn->type == RZ_ANALYSIS_FCN_TYPE_SYM);
+}
+
+static void diff_fcn_set(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2, double t, int type) {
+	fcn->diff->type = fcn2->diff->type = type;
+	fcn->diff->dist = fcn2->diff->dist = t;
+	RZ_FREE(fcn->fingerprint);
+	RZ_FREE(fcn2->fingerprint);
+	fcn->diff->addr = fcn2->addr;
+	fcn2->diff->addr = fcn->addr;
+	fcn->diff->size = fcn2->fingerprint_size;
+	fcn2->diff->size = fcn->fingerprint_size;
+	RZ_FREE(fcn->diff->name);
+	if (fcn2->name) {
+		fcn->diff->name = strdup(fcn2->name);
+	}
+	RZ_FREE(fcn2->diff->name);
+	if (fcn->name) {
+		fcn2->diff->name = strdup(fcn->name);
+	}
+	rz_analysis_diff_bb(analysis, fcn, fcn2);
+}
+
+static inline ut32 diff_mix(ut32 h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static void diff_minhash(void *user, size_t i) {
+	DiffFcn *df = (DiffFcn *)user + i;
+	RzAnalysisFunction *fcn = df->fcn;
+	size_t j, k;
+	if (fcn->fingerprint_size < DIFF_SHINGLE_SIZE) {
+		return;
+	}
+	for (k = 0; k < DIFF_MINHASH_SIZE; k++) {
+		df->minhash[k] = UT32_MAX;
+	}
+	for (j = 0; j + DIFF_SHINGLE_SIZE <= fcn->fingerprint_size; j++) {
+		ut32 shingle = rz_read_le32(fcn->fingerprint + j);
+		for (k = 0; k < DIFF_MINHASH_SIZE; k++) {
+			ut32 h = diff_mix(shingle ^ (ut32)((k + 1) * 0x9e3779b9));
+			if (h < df->minhash[k]) {
+				df->minhash[k] = h;
 			}
-			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size,
-				fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			/* Set flag in matched functions */
-			fcn->diff->type = fcn2->diff->type = (t >= RZ_ANALYSIS_DIFF_THRESHOLD)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			fcn->diff->dist = fcn2->diff->dist = t;
-			RZ_FREE(fcn->fingerprint);
-			RZ_FREE(fcn2->fingerprint);
-			fcn->diff->addr = fcn2->addr;
-			fcn2->diff->addr = fcn->addr;
-			fcn->diff->size = fcn2->fingerprint_size;
-			fcn2->diff->size = fcn->fingerprint_size;
-			RZ_FREE(fcn->diff->name);
-			if (fcn2->name) {
-				fcn->diff->name = strdup(fcn2->name);
+		}
+	}
+	df->has_minhash = true;
+}
+
+static inline ut64 diff_band_key(const DiffFcn *df, int band) {
+	const ut32 *rows = df->minhash + band * DIFF_MINHASH_ROWS;
+	return (ut64)rows[0] << 32 | rows[1];
+}
+
+static void diff_band_free(HtUPKv *kv) {
+	rz_pvector_free(kv->value);
+}
+
+static int diff_fcn_size_cmp(const void *a, const void *b) {
+	const RzAnalysisFunction *fa = (*(DiffFcn **)a)->fcn, *fb = (*(DiffFcn **)b)->fcn;
+	return fa->fingerprint_size < fb->fingerprint_size ? -1 : fa->fingerprint_size > fb->fingerprint_size;
+}
+
+static int diff_candidate_cmp(const void *a, const void *b) {
+	const DiffCandidate *ca = a, *cb = b;
+	return ca->t > cb->t ? -1 : ca->t < cb->t;
+}
+
+// index of the first function of by_size that is at least size bytes long
+static size_t diff_size_lower_bound(DiffMatcher *m, ut64 size) {
+	size_t lo = 0, hi = m->n_fcns2;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (m->by_size[mid]->fcn->fingerprint_size < size) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static void diff_candidate_add(DiffQuery *q, HtUP *seen, DiffFcn *df2) {
+	if (df2->taken || !diff_fcn_sizes_match(q->df->fcn, df2->fcn) || !ht_up_insert(seen, (ut64)(size_t)df2, NULL)) {
+		return;
+	}
+	DiffCandidate *c = rz_vector_push(&q->candidates, NULL);
+	if (c) {
+		c->df = df2;
+		c->t = diff_fcn_similarity(q->df->fcn, df2->fcn);
+	}
+}
+
+static void diff_query(void *user, size_t i) {
+	DiffMatcher *m = user;
+	DiffQuery *q = &m->queries[i];
+	RzAnalysisFunction *fcn = q->df->fcn;
+	HtUP *seen = ht_up_new0();
+	if (!seen) {
+		return;
+	}
+	size_t from = diff_size_lower_bound(m, (fcn->fingerprint_size + 1) / 2);
+	size_t to = diff_size_lower_bound(m, (ut64)fcn->fingerprint_size * 2 + 1);
+	if (to - from <= DIFF_BRUTE_WINDOW) {
+		for (; from < to; from++) {
+			diff_candidate_add(q, seen, m->by_size[from]);
+		}
+	} else if (q->df->has_minhash) {
+		int band;
+		for (band = 0; band < DIFF_MINHASH_BANDS; band++) {
+			RzPVector *bucket = ht_up_find(m->bands[band], diff_band_key(q->df, band), NULL);
+			void **it;
+			if (!bucket) {
+				continue;
 			}
-			RZ_FREE(fcn2->diff->name);
-			if (fcn->name) {
-				fcn2->diff->name = strdup(fcn->name);
+			rz_pvector_foreach (bucket, it) {
+				diff_candidate_add(q, seen, *it);
 			}
-			rz_analysis_diff_bb(analysis, fcn, fcn2);
+		}
+	}
+	ht_up_free(seen);
+	// the best ones are kept, whatever the bucket or size order they were found in
+	qsort(q->candidates.a, q->candidates.len, sizeof(DiffCandidate), diff_candidate_cmp);
+	if (rz_vector_len(&q->candidates) > DIFF_MAX_CANDIDATES) {
+		rz_vector_remove_range(&q->candidates, DIFF_MAX_CANDIDATES, rz_vector_len(&q->candidates) - DIFF_MAX_CANDIDATES, NULL);
+	}
+}
+
+typedef struct {
+	RzAnalysisFunction *fcn, *fcn2;
+	bool again; ///< fcn2 was paired before, its fingerprint is gone by then
+	double t;
+} DiffPair;
+
+static void diff_pair_similarity(void *user, size_t i) {
+	DiffPair *pair = rz_vector_index_ptr(user, i);
+	pair->t = pair->again ? 0 : diff_fcn_similarity(pair->fcn, pair->fcn2);
+}
+
+/*
+ * Compare functions with the same name. As with a linear scan of fcns2, a
+ * function is paired with the first one that has its name, or with the
+ * first one at all when either has no name, even if it was paired before.
+ */
+static void diff_fcn_by_name(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	RzAnalysisFunction *fcn, *fcn2, *unnamed = NULL;
+	RzListIter *iter;
+	RzVector pairs;
+	rz_vector_init(&pairs, sizeof(DiffPair), NULL, NULL);
+	HtPP *names = ht_pp_new0();
+	HtUP *paired = ht_up_new0();
+	if (!names || !paired) {
+		goto beach;
+	}
+	rz_list_foreach (fcns2, iter, fcn2) {
+		if (!fcn2->name) {
+			// the functions after it are never reached
+			unnamed = fcn2;
 			break;
 		}
+		// the first function wins
+		ht_pp_insert(names, fcn2->name, fcn2);
 	}
-	/* Compare remaining functions */
 	rz_list_foreach (fcns1, iter, fcn) {
-		if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-			continue;
-		} else if (!fcn->fingerprint_size) {
-			continue;
-		} else if (fcn->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
+		if (!fcn->name) {
+			fcn2 = rz_list_first(fcns2);
+		} else if (!(fcn2 = ht_pp_find(names, fcn->name, NULL))) {
+			fcn2 = unnamed;
+		}
+		if (!fcn2) {
 			continue;
 		}
-		ot = 0.0;
-		mfcn = mfcn2 = NULL;
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				continue;
-			} else if (!fcn2->fingerprint_size) {
-				continue;
-			} else if (fcn2->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn2->type != RZ_ANALYSIS_FCN_TYPE_SYM) {
+		DiffPair *pair = rz_vector_push(&pairs, NULL);
+		if (pair) {
+			pair->fcn = fcn;
+			pair->fcn2 = fcn2;
+			pair->again = !ht_up_insert(paired, (ut64)(size_t)fcn2, NULL);
+		}
+	}
+	rz_th_parallel_for(rz_vector_len(&pairs), diff_pair_similarity, &pairs);
+	DiffPair *pair;
+	rz_vector_foreach(&pairs, pair) {
+		diff_fcn_set(analysis, pair->fcn, pair->fcn2, pair->t,
+			pair->t >= RZ_ANALYSIS_DIFF_THRESHOLD ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH);
+	}
+beach:
+	ht_up_free(paired);
+	ht_pp_free(names);
+	rz_vector_fini(&pairs);
+}
+
+static ut64 diff_fcn_exact_key(RzAnalysisFunction *fcn) {
+	return (ut64)rz_hash_xxhash(fcn->fingerprint, fcn->fingerprint_size) << 32 | rz_list_length(fcn->bbs);
+}
+
+static bool diff_fcn_exact_match(RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2) {
+	return fcn->fingerprint_size == fcn2->fingerprint_size && rz_list_length(fcn->bbs) == rz_list_length(fcn2->bbs) &&
+		!memcmp(fcn->fingerprint, fcn2->fingerprint, fcn->fingerprint_size);
+}
+
+/* Match the remaining functions with identical fingerprints */
+static void diff_fcn_exact(RzAnalysis *analysis, DiffMatcher *m, DiffFcn *fcns1, size_t n_fcns1) {
+	HtUP *exact = ht_up_new(NULL, diff_band_free, NULL);
+	size_t i;
+	if (!exact) {
+		return;
+	}
+	for (i = 0; i < m->n_fcns2; i++) {
+		ut64 key = diff_fcn_exact_key(m->fcns2[i].fcn);
+		RzPVector *bucket = ht_up_find(exact, key, NULL);
+		if (!bucket) {
+			bucket = rz_pvector_new(NULL);
+			if (!bucket || !ht_up_insert(exact, key, bucket)) {
+				rz_pvector_free(bucket);
 				continue;
 			}
-			if (fcn->fingerprint_size > fcn2->fingerprint_size) {
-				sizes_div = fcn2->fingerprint_size;
-				sizes_div /= fcn->fingerprint_size;
-			} else {
-				sizes_div = fcn->fingerprint_size;
-				sizes_div /= fcn2->fingerprint_size;
+		}
+		rz_pvector_push(bucket, &m->fcns2[i]);
+	}
+	for (i = 0; i < n_fcns1; i++) {
+		RzPVector *bucket = ht_up_find(exact, diff_fcn_exact_key(fcns1[i].fcn), NULL);
+		void **it;
+		if (!bucket) {
+			continue;
+		}
+		rz_pvector_foreach (bucket, it) {
+			DiffFcn *df2 = *it;
+			if (!df2->taken && diff_fcn_exact_match(fcns1[i].fcn, df2->fcn)) {
+				df2->taken = fcns1[i].taken = true;
+				diff_fcn_set(analysis, fcns1[i].fcn, df2->fcn, 1.0, RZ_ANALYSIS_DIFF_TYPE_MATCH);
+				break;
 			}
-			if (sizes_div < RZ_ANALYSIS_DIFF_THRESHOLD) {
+		}
+	}
+	ht_up_free(exact);
+}
+
+static DiffFcn *diff_fcns_new(RzList *fcns, size_t *n) {
+	DiffFcn *r = RZ_NEWS0(DiffFcn, RZ_MAX(rz_list_length(fcns), 1));
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	*n = 0;
+	if (!r) {
+		return NULL;
+	}
+	rz_list_foreach (fcns, iter, fcn) {
+		if (diff_fcn_is_candidate(fcn)) {
+			r[(*n)++].fcn = fcn;
+		}
+	}
+	return r;
+}
+
+static size_t diff_fcns_compact(DiffFcn *fcns, size_t n) {
+	size_t i, r = 0;
+	for (i = 0; i < n; i++) {
+		if (!fcns[i].taken) {
+			fcns[r++] = fcns[i];
+		}
+	}
+	return r;
+}
+
+/* Compare remaining functions */
+static void diff_fcn_similar(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	DiffMatcher m = { 0 };
+	size_t i, n_fcns1 = 0, n_queries = 0;
+	int band;
+	DiffFcn *df1 = diff_fcns_new(fcns1, &n_fcns1);
+	m.fcns2 = diff_fcns_new(fcns2, &m.n_fcns2);
+	if (!df1 || !m.fcns2 || !n_fcns1 || !m.n_fcns2) {
+		goto beach;
+	}
+	diff_fcn_exact(analysis, &m, df1, n_fcns1);
+
+	// the exact matches are out, keep only what is left on both sides
+	n_fcns1 = diff_fcns_compact(df1, n_fcns1);
+	m.n_fcns2 = diff_fcns_compact(m.fcns2, m.n_fcns2);
+	m.by_size = RZ_NEWS(DiffFcn *, RZ_MAX(m.n_fcns2, 1));
+	m.queries = RZ_NEWS0(DiffQuery, RZ_MAX(n_fcns1, 1));
+	if (!m.by_size || !m.queries) {
+		goto beach;
+	}
+	for (; n_queries < n_fcns1; n_queries++) {
+		m.queries[n_queries].df = &df1[n_queries];
+		rz_vector_init(&m.queries[n_queries].candidates, sizeof(DiffCandidate), NULL, NULL);
+	}
+	for (i = 0; i < m.n_fcns2; i++) {
+		m.by_size[i] = &m.fcns2[i];
+	}
+	qsort(m.by_size, m.n_fcns2, sizeof(DiffFcn *), diff_fcn_size_cmp);
+
+	rz_th_parallel_for(n_fcns1, diff_minhash, df1);
+	rz_th_parallel_for(m.n_fcns2, diff_minhash, m.fcns2);
+	for (band = 0; band < DIFF_MINHASH_BANDS; band++) {
+		m.bands[band] = ht_up_new(NULL, diff_band_free, NULL);
+		if (!m.bands[band]) {
+			goto beach;
+		}
+		for (i = 0; i < m.n_fcns2; i++) {
+			DiffFcn *df2 = &m.fcns2[i];
+			if (!df2->has_minhash) {
 				continue;
 			}
-			rz_diff_levenstein_distance(fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			if (t > ot) {
-				ot = t;
-				mfcn = fcn;
-				mfcn2 = fcn2;
-				if (ot >= RZ_ANALYSIS_DIFF_THRESHOLD) {
-					break;
+			ut64 key = diff_band_key(df2, band);
+			RzPVector *bucket = ht_up_find(m.bands[band], key, NULL);
+			if (!bucket) {
+				bucket = rz_pvector_new(NULL);
+				if (!bucket || !ht_up_insert(m.bands[band], key, bucket)) {
+					rz_pvector_free(bucket);
+					continue;
 				}
 			}
+			rz_pvector_push(bucket, df2);
 		}
-		if (mfcn && mfcn2) {
-			mfcn->diff->dist = mfcn2->diff->dist = ot;
-			/* Set flag in matched functions */
-			mfcn->diff->type = mfcn2->diff->type = (ot > RZ_ANALYSIS_DIFF_THRESHOLD)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			RZ_FREE(mfcn->fingerprint);
-			RZ_FREE(mfcn2->fingerprint);
-			mfcn->diff->addr = mfcn2->addr;
-			mfcn2->diff->addr = mfcn->addr;
-			mfcn->diff->size = mfcn2->fingerprint_size;
-			mfcn2->diff->size = mfcn->fingerprint_size;
-			RZ_FREE(mfcn->diff->name);
-			if (mfcn2->name) {
-				mfcn->diff->name = strdup(mfcn2->name);
+	}
+
+	rz_th_parallel_for(n_queries, diff_query, &m);
+	for (i = 0; i < n_queries; i++) {
+		DiffQuery *q = &m.queries[i];
+		DiffCandidate *c;
+		rz_vector_foreach(&q->candidates, c) {
+			if (c->t <= 0) {
+				break;
 			}
-			RZ_FREE(mfcn2->diff->name);
-			if (mfcn->name) {
-				mfcn2->diff->name = strdup(mfcn->name);
+			if (c->df->taken) {
+				continue;
 			}
-			rz_analysis_diff_bb(analysis, mfcn, mfcn2);
+			c->df->taken = true;
+			/* Set flag in matched functions */
+			diff_fcn_set(analysis, q->df->fcn, c->df->fcn, c->t,
+				c->t > RZ_ANALYSIS_DIFF_THRESHOLD ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH);
+			break;
+		}
+	}
+
+beach:
+	if (m.queries) {
+		for (i = 0; i < n_queries; i++) {
+			rz_vector_fini(&m.queries[i].candidates);
 		}
 	}
+	for (band = 0; band < DIFF_MINHASH_BANDS; band++) {
+		ht_up_free(m.bands[band]);
+	}
+	free(m.queries);
+	free(m.by_size);
+	free(m.fcns2);
+	free(df1);
+}
+
+RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns1, RzList *fcns2) {
+	if (!analysis) {
+		return false;
+	}
+	if (analysis->cur && analysis->cur->diff_fcn) {
+		return (analysis->cur->diff_fcn(analysis, fcns1, fcns2));
+	}
+	diff_fcn_by_name(analysis, fcns1, fcns2);
+	diff_fcn_similar(analysis, fcns1, fcns2);
 	return true;
 }
 
@@ -370,13 +370,25 @@ RZ_API int rz_analysis_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8
 }
 
 static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
-	RzRegItem *reg = rz_reg_get(esil->analysis->reg, regname, -1);
-	if (reg) {
+	RzReg *reg = esil->analysis->reg;
+	RzRegHandle h = rz_reg_handle(reg, regname);
+	if (h != RZ_REG_HANDLE_INVALID) {
 		if (size) {
-			*size = reg->size;
+			*size = rz_reg_handle_item(reg, h)->size;
 		}
 		if (num) {
-			*num = rz_reg_get_value(esil->analysis->reg, reg);
+			*num = rz_reg_handle_get_value(reg, h);
+		}
+		return true;
+	}
+	// no handles while the profile is being set up
+	RzRegItem *ri = reg->ht_handles ? NULL : rz_reg_get(reg, regname, -1);
+	if (ri) {
+		if (size) {
+			*size = ri->size;
+		}
+		if (num) {
+			*num = rz_reg_get_value(reg, ri);
 		}
 		return true;
 	}
@@ -385,9 +397,15 @@ static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut6
 
 static int internal_esil_reg_write(RzAnalysisEsil *esil, const char *regname, ut64 num) {
 	if (esil && esil->analysis) {
-		RzRegItem *reg = rz_reg_get(esil->analysis->reg, regname, -1);
-		if (reg) {
-			rz_reg_set_value(esil->analysis->reg, reg, num);
+		RzReg *reg = esil->analysis->reg;
+		RzRegHandle h = rz_reg_handle(reg, regname);
+		if (h != RZ_REG_HANDLE_INVALID) {
+			rz_reg_handle_set_value(reg, h, num);
+			return true;
+		}
+		RzRegItem *ri = reg->ht_handles ? NULL : rz_reg_get(reg, regname, -1);
+		if (ri) {
+			rz_reg_set_value(reg, ri, num);
 			return true;
 		}
 	}
@@ -1432,10 +1432,21 @@ RZ_API bool rz_analysis_task_item_new(RZ_NONNULL RzAnalysis *analysis, RZ_NONNUL
 RZ_API int rz_analysis_run_tasks(RZ_NONNULL RzVector *tasks) {
 	rz_return_val_if_fail(tasks, RZ_ANALYSIS_RET_ERROR);
 	int ret = RZ_ANALYSIS_RET_ERROR;
+	RzAnalysis *analysis = NULL;
+	RzArenaMark mark;
+	bool arena = false;
 	while (!rz_vector_empty(tasks)) {
 		RzAnalysisTaskItem item;
 		rz_vector_pop(tasks, &item);
+		if (!analysis) {
+			analysis = item.fcn->analysis;
+			arena = rz_analysis_op_arena_begin(analysis, &mark);
+		}
 		int r = run_basic_block_analysis(&item, tasks);
+		if (arena) {
+			// every op of the block has been finalized by now
+			rz_analysis_op_arena_release(analysis, &mark);
+		}
 		switch (r) {
 		case RZ_ANALYSIS_RET_NOP:
 		case RZ_ANALYSIS_RET_ERROR:
@@ -1454,6 +1465,9 @@ RZ_API int rz_analysis_run_tasks(RZ_NONNULL RzVector *tasks) {
 			break;
 		}
 	}
+	if (arena) {
+		rz_analysis_op_arena_end(analysis, &mark);
+	}
 	return ret;
 }
 
@@ -1628,24 +1642,12 @@ RZ_API int rz_analysis_fcn_del(RzAnalysis *a, ut64 addr) {
 }
 
 RZ_API RzAnalysisFunction *rz_analysis_get_fcn_in(RzAnalysis *analysis, ut64 addr, int type) {
-	RzList *list = rz_analysis_get_functions_in(analysis, addr);
-	RzAnalysisFunction *ret = NULL;
-	if (list && !rz_list_empty(list)) {
-		if (type == RZ_ANALYSIS_FCN_TYPE_ROOT) {
-			RzAnalysisFunction *fcn;
-			RzListIter *iter;
-			rz_list_foreach (list, iter, fcn) {
-				if (fcn->addr == addr) {
-					ret = fcn;
-					break;
-				}
-			}
-		} else {
-			ret = rz_list_first(list);
-		}
+	if (type == RZ_ANALYSIS_FCN_TYPE_ROOT) {
+		// only one function can start at addr, it must also have a block there
+		RzAnalysisFunction *fcn = rz_analysis_get_function_at(analysis, addr);
+		return fcn && rz_analysis_function_contains(fcn, addr) ? fcn : NULL;
 	}
-	rz_list_free(list);
-	return ret;
+	return rz_analysis_first_function_in(analysis, addr);
 }
 
 RZ_API RzAnalysisFunction *rz_analysis_get_fcn_in_bounds(RzAnalysis *analysis, ut64 addr, int type) {
@@ -2200,22 +2202,96 @@ static void free_ht_up(HtUPKv *kv) {
 	ht_up_free((HtUP *)kv->value);
 }
 
-static void update_varz_analysisysis(RzAnalysisFunction *fcn, int align, ut64 from, ut64 to) {
+/*
+ * Delete the xrefs going out of addr that function analysis creates again,
+ * the ones added by aar, aae or by the user are kept.
+ */
+static void del_fcn_xrefs_from(RzAnalysis *analysis, ut64 addr) {
+	rz_analysis_xrefs_del_from(analysis, addr, RZ_ANALYSIS_REF_TYPE_CODE);
+	rz_analysis_xrefs_del_from(analysis, addr, RZ_ANALYSIS_REF_TYPE_CALL);
+	rz_analysis_xrefs_del_from(analysis, addr, RZ_ANALYSIS_REF_TYPE_DATA);
+}
+
+static bool has_code_xrefs_from(RzAnalysis *analysis, ut64 addr) {
+	RzList *xrefs = rz_analysis_xrefs_get_from(analysis, addr);
+	RzListIter *it;
+	RzAnalysisXRef *xref;
+	bool ret = false;
+	rz_list_foreach (xrefs, it, xref) {
+		if (xref->type == RZ_ANALYSIS_REF_TYPE_CODE) {
+			ret = true;
+			break;
+		}
+	}
+	rz_list_free(xrefs);
+	return ret;
+}
+
+/*
+ * Replace the xrefs going out of a rewritten instruction, the same way
+ * rz_analysis_fcn_bb() creates them. Returns false if the block has to be
+ * reanalyzed instead: the instruction is or was a branch, whose edges and
+ * CODE xrefs only the block analysis restores, or it now calls a noreturn
+ * function, after which the block has to be split.
+ */
+static bool update_op_xrefs(RzAnalysis *analysis, RzAnalysisOp *op) {
+	switch (op->type & RZ_ANALYSIS_OP_TYPE_MASK) {
+	case RZ_ANALYSIS_OP_TYPE_JMP:
+	case RZ_ANALYSIS_OP_TYPE_UJMP:
+	case RZ_ANALYSIS_OP_TYPE_CJMP:
+	case RZ_ANALYSIS_OP_TYPE_UCJMP:
+	case RZ_ANALYSIS_OP_TYPE_RET:
+	case RZ_ANALYSIS_OP_TYPE_CRET:
+		return false;
+	default:
+		if (has_code_xrefs_from(analysis, op->addr)) {
+			return false;
+		}
+		break;
+	}
+	del_fcn_xrefs_from(analysis, op->addr);
+	if (op->ptr && op->ptr != UT64_MAX && op->ptr != UT32_MAX) {
+		rz_analysis_xrefs_set(analysis, op->addr, op->ptr, RZ_ANALYSIS_REF_TYPE_DATA);
+	}
+	switch (op->type & RZ_ANALYSIS_OP_TYPE_MASK) {
+	case RZ_ANALYSIS_OP_TYPE_UCALL:
+	case RZ_ANALYSIS_OP_TYPE_RCALL:
+	case RZ_ANALYSIS_OP_TYPE_ICALL:
+	case RZ_ANALYSIS_OP_TYPE_IRCALL:
+		rz_analysis_xrefs_set(analysis, op->addr, op->ptr, RZ_ANALYSIS_REF_TYPE_CALL);
+		return !rz_analysis_noreturn_at(analysis, op->ptr);
+	case RZ_ANALYSIS_OP_TYPE_CCALL:
+	case RZ_ANALYSIS_OP_TYPE_CALL:
+		rz_analysis_xrefs_set(analysis, op->addr, op->jump, RZ_ANALYSIS_REF_TYPE_CALL);
+		return !rz_analysis_noreturn_at(analysis, op->jump);
+	default:
+		break;
+	}
+	return true;
+}
+
+/*
+ * Re-extract the variables and xrefs of the instructions in [from, to).
+ * Returns false if the block containing them has to be reanalyzed instead.
+ */
+static bool update_varz_analysisysis(RzAnalysisFunction *fcn, int align, ut64 from, ut64 to) {
 	RzAnalysis *analysis = fcn->analysis;
 	ut64 cur_addr;
 	int opsz;
+	bool ok = true;
 	from = align ? from - (from % align) : from;
 	to = align ? RZ_ROUND(to, align) : to;
 	if (UT64_SUB_OVFCHK(to, from)) {
-		return;
+		return true;
 	}
 	ut64 len = to - from;
 	ut8 *buf = malloc(len);
 	if (!buf) {
-		return;
+		return true;
 	}
 	if (analysis->iob.read_at(analysis->iob.io, from, buf, len) < len) {
-		return;
+		free(buf);
+		return true;
 	}
 	for (cur_addr = from; cur_addr < to; cur_addr += opsz, len -= opsz) {
 		RzAnalysisOp op;
@@ -2226,9 +2302,11 @@ static void update_varz_analysisysis(RzAnalysisFunction *fcn, int align, ut64 fr
 		}
 		opsz = op.size;
 		rz_analysis_extract_vars(analysis, fcn, &op);
+		ok &= update_op_xrefs(analysis, &op);
 		rz_analysis_op_fini(&op);
 	}
 	free(buf);
+	return ok;
 }
 
 // Clear function variable acesses inside in a block
@@ -2303,6 +2381,11 @@ static void update_analysis(RzAnalysis *analysis, RzList *fcns, HtUP *reachable)
 
 static void calc_reachable_and_remove_block(RzList *fcns, RzAnalysisFunction *fcn, RzAnalysisBlock *bb, HtUP *reachable) {
 	clear_bb_vars(fcn, bb, bb->addr, bb->addr + bb->size);
+	// the xrefs of the block are created again when it gets reanalyzed
+	int i;
+	for (i = 0; i < bb->ninstr; i++) {
+		del_fcn_xrefs_from(fcn->analysis, rz_analysis_block_get_op_addr(bb, i));
+	}
 	if (!rz_list_contains(fcns, fcn)) {
 		rz_list_append(fcns, fcn);
 
@@ -2341,9 +2424,11 @@ RZ_API void rz_analysis_update_analysis_range(RzAnalysis *analysis, ut64 addr, i
 					// Special case when instructions are aligned and we don't
 					// need to worry about a write messing with the jump instructions
 					clear_bb_vars(fcn, bb, addr > bb->addr ? addr : bb->addr, end_write);
-					update_varz_analysisysis(fcn, align, addr > bb->addr ? addr : bb->addr, end_write);
+					bool ok = update_varz_analysisysis(fcn, align, addr > bb->addr ? addr : bb->addr, end_write);
 					rz_analysis_function_delete_unused_vars(fcn);
-					continue;
+					if (ok) {
+						continue;
+					}
 				}
 			}
 			calc_reachable_and_remove_block(fcns, fcn, bb, reachable);
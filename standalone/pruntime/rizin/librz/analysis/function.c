@@ -4,25 +4,97 @@
 
 #include <rz_analysis.h>
 
-static bool get_functions_block_cb(RzAnalysisBlock *block, void *user) {
-	RzList *list = user;
+// functions sharing an address that are remembered without allocating
+#define FCNS_IN_SEEN 8
+
+typedef struct {
+	RzAnalysisFunctionCb cb;
+	void *user;
+	RzAnalysisFunction *seen[FCNS_IN_SEEN];
+	size_t count;
+	RzPVector *more; ///< only allocated if even more functions share the address
+} FunctionsInCtx;
+
+static bool functions_in_seen(FunctionsInCtx *ctx, RzAnalysisFunction *fcn) {
+	size_t i;
+	for (i = 0; i < RZ_MIN(ctx->count, FCNS_IN_SEEN); i++) {
+		if (ctx->seen[i] == fcn) {
+			return true;
+		}
+	}
+	return ctx->more && rz_pvector_contains(ctx->more, fcn);
+}
+
+static bool functions_in_block_cb(RzAnalysisBlock *block, void *user) {
+	FunctionsInCtx *ctx = user;
 	RzListIter *iter;
 	RzAnalysisFunction *fcn;
 	rz_list_foreach (block->fcns, iter, fcn) {
-		if (rz_list_contains(list, fcn)) {
+		if (functions_in_seen(ctx, fcn)) {
 			continue;
 		}
-		rz_list_push(list, fcn);
+		if (ctx->count < FCNS_IN_SEEN) {
+			ctx->seen[ctx->count] = fcn;
+		} else {
+			if (!ctx->more) {
+				ctx->more = rz_pvector_new(NULL);
+			}
+			if (ctx->more) {
+				rz_pvector_push(ctx->more, fcn);
+			}
+		}
+		ctx->count++;
+		if (!ctx->cb(fcn, ctx->user)) {
+			return false;
+		}
 	}
 	return true;
 }
 
+/**
+ * \brief Call \p cb once for every function that has a basic block containing \p addr
+ *
+ * The functions are visited in the same order as rz_analysis_get_functions_in() returns
+ * them, but no list is built. Nothing is allocated unless more than a handful of
+ * functions share the address.
+ *
+ * \return false if \p cb returned false to stop the iteration
+ */
+RZ_API bool rz_analysis_functions_foreach_in(RzAnalysis *analysis, ut64 addr, RzAnalysisFunctionCb cb, void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	FunctionsInCtx ctx = { .cb = cb, .user = user };
+	bool ret = rz_analysis_blocks_foreach_in(analysis, addr, functions_in_block_cb, &ctx);
+	rz_pvector_free(ctx.more);
+	return ret;
+}
+
+static bool first_function_in_cb(RzAnalysisBlock *block, void *user) {
+	RzAnalysisFunction **ret = user;
+	*ret = rz_list_first(block->fcns);
+	return !*ret;
+}
+
+/**
+ * \brief Get the first function of rz_analysis_get_functions_in() without building the list
+ */
+RZ_API RZ_BORROW RzAnalysisFunction *rz_analysis_first_function_in(RzAnalysis *analysis, ut64 addr) {
+	rz_return_val_if_fail(analysis, NULL);
+	RzAnalysisFunction *ret = NULL;
+	rz_analysis_blocks_foreach_in(analysis, addr, first_function_in_cb, &ret);
+	return ret;
+}
+
+static bool get_functions_cb(RzAnalysisFunction *fcn, void *user) {
+	rz_list_push(user, fcn);
+	return true;
+}
+
 RZ_API RzList *rz_analysis_get_functions_in(RzAnalysis *analysis, ut64 addr) {
 	RzList *list = rz_list_new();
 	if (!list) {
 		return NULL;
 	}
-	rz_analysis_blocks_foreach_in(analysis, addr, get_functions_block_cb, list);
+	rz_analysis_functions_foreach_in(analysis, addr, get_functions_cb, list);
 	return list;
 }
 
@@ -359,6 +431,10 @@ static bool fcn_in_cb(RzAnalysisBlock *block, void *user) {
 }
 
 RZ_API bool rz_analysis_function_contains(RzAnalysisFunction *fcn, ut64 addr) {
+	if (fcn->meta._min != UT64_MAX && (addr < fcn->meta._min || addr >= fcn->meta._max)) {
+		// outside of the cached range, no need to look at the blocks
+		return false;
+	}
 	// fcn_in_cb breaks with false if it finds the fcn
 	return !rz_analysis_blocks_foreach_in(fcn->analysis, addr, fcn_in_cb, fcn);
 }
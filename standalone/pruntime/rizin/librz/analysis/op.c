@@ -34,25 +34,40 @@ RZ_API void rz_analysis_op_init(RzAnalysisOp *op) {
 	}
 }
 
+static inline bool in_op_arena(RzAnalysisOp *op, const void *p) {
+	return op->arena && p && rz_arena_contains(op->arena, p);
+}
+
+static void op_value_free(RzAnalysisOp *op, RzAnalysisValue *val) {
+	if (!in_op_arena(op, val)) {
+		rz_analysis_value_free(val);
+	}
+}
+
 RZ_API bool rz_analysis_op_fini(RzAnalysisOp *op) {
 	if (!op) {
 		return false;
 	}
-	rz_analysis_value_free(op->src[0]);
-	rz_analysis_value_free(op->src[1]);
-	rz_analysis_value_free(op->src[2]);
+	op_value_free(op, op->src[0]);
+	op_value_free(op, op->src[1]);
+	op_value_free(op, op->src[2]);
 	op->src[0] = NULL;
 	op->src[1] = NULL;
 	op->src[2] = NULL;
-	rz_analysis_value_free(op->dst);
+	op_value_free(op, op->dst);
 	op->dst = NULL;
-	rz_list_free(op->access);
+	if (!in_op_arena(op, op->access)) {
+		rz_list_free(op->access);
+	}
 	op->access = NULL;
 	rz_strbuf_fini(&op->opex);
 	rz_strbuf_fini(&op->esil);
 	rz_analysis_switch_op_free(op->switch_op);
 	op->switch_op = NULL;
-	RZ_FREE(op->mnemonic);
+	if (!in_op_arena(op, op->mnemonic)) {
+		free(op->mnemonic);
+	}
+	op->mnemonic = NULL;
 	return true;
 }
 
@@ -94,6 +109,9 @@ static int defaultCycles(RzAnalysisOp *op) {
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
 	rz_analysis_op_init(op);
 	rz_return_val_if_fail(analysis && op && len > 0, -1);
+	if (analysis->op_arena_depth > 0) {
+		op->arena = analysis->op_arena;
+	}
 
 	int ret = RZ_MIN(2, len);
 	if (len > 0 && analysis->cur && analysis->cur->op) {
@@ -147,6 +165,7 @@ RZ_API RzAnalysisOp *rz_analysis_op_copy(RzAnalysisOp *op) {
 		return NULL;
 	}
 	*nop = *op;
+	nop->arena = NULL;
 	if (op->mnemonic) {
 		nop->mnemonic = strdup(op->mnemonic);
 		if (!nop->mnemonic) {
@@ -648,8 +667,10 @@ RZ_API int rz_analysis_op_hint(RzAnalysisOp *op, RzAnalysisHint *hint) {
 		}
 		if (hint->opcode) {
 			/* XXX: this is not correct */
-			free(op->mnemonic);
-			op->mnemonic = strdup(hint->opcode);
+			if (!in_op_arena(op, op->mnemonic)) {
+				free(op->mnemonic);
+			}
+			op->mnemonic = rz_analysis_op_strdup(op, hint->opcode);
 			changes++;
 		}
 		if (hint->esil) {
@@ -682,3 +703,110 @@ RZ_API int rz_analysis_op_reg_delta(RzAnalysis *analysis, ut64 addr, const char
 	rz_analysis_op_fini(&op);
 	return delta;
 }
+
+/**
+ * \brief Let the rz_analysis_op() calls that follow allocate the op temporaries in an arena
+ * \param mark filled with the arena position to give to rz_analysis_op_arena_release/end()
+ * \return false if analysis.arena is disabled, then the release/end calls must be skipped
+ *
+ * The mnemonic, src/dst values and access list of the ops created in between are
+ * dropped all at once by rz_analysis_op_arena_release(), so those ops must have been
+ * finalized by then. Use rz_analysis_op_copy() to keep an op for longer.
+ * Scopes can be nested as long as they are closed in reverse order.
+ */
+RZ_API bool rz_analysis_op_arena_begin(RzAnalysis *analysis, RzArenaMark *mark) {
+	rz_return_val_if_fail(analysis && mark, false);
+	if (!analysis->opt.op_arena) {
+		return false;
+	}
+	if (!analysis->op_arena) {
+		analysis->op_arena = rz_arena_new(0);
+		if (!analysis->op_arena) {
+			return false;
+		}
+	}
+	analysis->op_arena_depth++;
+	*mark = rz_arena_mark(analysis->op_arena);
+	return true;
+}
+
+/**
+ * \brief Drop the temporaries of every op created since \p mark in O(1), e.g. between two instructions
+ */
+RZ_API void rz_analysis_op_arena_release(RzAnalysis *analysis, RzArenaMark *mark) {
+	rz_return_if_fail(analysis && analysis->op_arena && mark);
+	rz_arena_release(analysis->op_arena, *mark);
+}
+
+RZ_API void rz_analysis_op_arena_end(RzAnalysis *analysis, RzArenaMark *mark) {
+	rz_return_if_fail(analysis && analysis->op_arena && analysis->op_arena_depth > 0 && mark);
+	rz_arena_release(analysis->op_arena, *mark);
+	analysis->op_arena_depth--;
+}
+
+/**
+ * \brief Allocate a zeroed value owned by \p op, to be used for src, dst or access
+ */
+RZ_API RzAnalysisValue *rz_analysis_op_value_new(RzAnalysisOp *op) {
+	rz_return_val_if_fail(op, NULL);
+	return op->arena ? RZ_ARENA_NEW0(op->arena, RzAnalysisValue) : rz_analysis_value_new();
+}
+
+RZ_API char *rz_analysis_op_strdup(RzAnalysisOp *op, const char *s) {
+	rz_return_val_if_fail(op && s, NULL);
+	return op->arena ? rz_arena_strdup(op->arena, s) : strdup(s);
+}
+
+RZ_API char *rz_analysis_op_newf(RzAnalysisOp *op, const char *fmt, ...) {
+	rz_return_val_if_fail(op && fmt, NULL);
+	va_list ap, ap2;
+	va_start(ap, fmt);
+	char *r = NULL;
+	if (op->arena) {
+		r = rz_arena_vnewf(op->arena, fmt, ap);
+	} else {
+		va_copy(ap2, ap);
+		int len = vsnprintf(NULL, 0, fmt, ap);
+		if (len >= 0 && (r = malloc(len + 1))) {
+			vsnprintf(r, len + 1, fmt, ap2);
+		}
+		va_end(ap2);
+	}
+	va_end(ap);
+	return r;
+}
+
+/**
+ * \brief Append \p val, created with rz_analysis_op_value_new(), to the access list of \p op
+ */
+RZ_API bool rz_analysis_op_access_add(RzAnalysisOp *op, RzAnalysisValue *val) {
+	rz_return_val_if_fail(op && val, false);
+	if (!op->arena) {
+		if (!op->access) {
+			op->access = rz_list_newf((RzListFree)rz_analysis_value_free);
+		}
+		return op->access && rz_list_append(op->access, val);
+	}
+	// the list and its nodes live in the arena too, so nothing has to be freed
+	if (!op->access) {
+		op->access = RZ_ARENA_NEW0(op->arena, RzList);
+		if (!op->access) {
+			return false;
+		}
+	}
+	RzListIter *it = RZ_ARENA_NEW0(op->arena, RzListIter);
+	if (!it) {
+		return false;
+	}
+	it->data = val;
+	it->p = op->access->tail;
+	if (op->access->tail) {
+		op->access->tail->n = it;
+	} else {
+		op->access->head = it;
+	}
+	op->access->tail = it;
+	op->access->length++;
+	op->access->sorted = false;
+	return true;
+}
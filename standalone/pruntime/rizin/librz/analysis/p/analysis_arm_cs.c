@@ -3650,7 +3650,7 @@ jmp $$ + 4 + ( [delta] * 2 )
 	if (found) {
 		insn->detail->arm.cc = itcond;
 		insn->detail->arm.update_flags = 0;
-		op->mnemonic = rz_str_newf("%s%s%s%s",
+		op->mnemonic = rz_analysis_op_newf(op, "%s%s%s%s",
 			rz_analysis_optype_to_string(op->type),
 			cc_name(itcond),
 			insn->op_str[0] ? " " : "",
@@ -3793,10 +3793,10 @@ static void set_src_dst(RzAnalysisValue *val, RzReg *reg, csh *handle, cs_insn *
 }
 
 static void create_src_dst(RzAnalysisOp *op) {
-	op->src[0] = rz_analysis_value_new();
-	op->src[1] = rz_analysis_value_new();
-	op->src[2] = rz_analysis_value_new();
-	op->dst = rz_analysis_value_new();
+	op->src[0] = rz_analysis_op_value_new(op);
+	op->src[1] = rz_analysis_op_value_new(op);
+	op->src[2] = rz_analysis_op_value_new(op);
+	op->dst = rz_analysis_op_value_new(op);
 }
 
 static void op_fillval(RzAnalysis *analysis, RzAnalysisOp *op, csh handle, cs_insn *insn, int bits) {
@@ -3906,11 +3906,11 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = strdup("invalid");
+			op->mnemonic = rz_analysis_op_strdup(op, "invalid");
 		}
 	} else {
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = rz_str_newf("%s%s%s",
+			op->mnemonic = rz_analysis_op_newf(op, "%s%s%s",
 				insn->mnemonic,
 				insn->op_str[0] ? " " : "",
 				insn->op_str);
@@ -1324,7 +1324,7 @@ static void anop_esil(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf
 			break;
 		case X86_OP_REG: {
 			src = getarg(&gop, 0, 0, NULL, SRC_AR, NULL);
-			op->src[0] = rz_analysis_value_new();
+			op->src[0] = rz_analysis_op_value_new(op);
 			op->src[0]->reg = rz_reg_get(a->reg, src, RZ_REG_TYPE_GPR);
 			//XXX fallthrough
 		}
@@ -1896,17 +1896,12 @@ static void set_access_info(RzReg *reg, RzAnalysisOp *op, csh *handle, cs_insn *
 		sp = X86_REG_ESP;
 		break;
 	}
-	RzList *ret = rz_list_newf((RzListFree)rz_analysis_value_free);
-	if (!ret) {
-		return;
-	}
-
 	// PC register
-	val = rz_analysis_value_new();
+	val = rz_analysis_op_value_new(op);
 	val->type = RZ_ANALYSIS_VAL_REG;
 	val->access = RZ_ANALYSIS_ACC_W;
 	val->reg = cs_reg2reg(reg, handle, X86_REG_RIP);
-	rz_list_append(ret, val);
+	rz_analysis_op_access_add(op, val);
 
 #if CS_API_MAJOR >= 4
 	// Register access info
@@ -1915,20 +1910,20 @@ static void set_access_info(RzReg *reg, RzAnalysisOp *op, csh *handle, cs_insn *
 	if (cs_regs_access(*handle, insn, regs_read, &read_count, regs_write, &write_count) == 0) {
 		if (read_count > 0) {
 			for (i = 0; i < read_count; i++) {
-				val = rz_analysis_value_new();
+				val = rz_analysis_op_value_new(op);
 				val->type = RZ_ANALYSIS_VAL_REG;
 				val->access = RZ_ANALYSIS_ACC_R;
 				val->reg = cs_reg2reg(reg, handle, regs_read[i]);
-				rz_list_append(ret, val);
+				rz_analysis_op_access_add(op, val);
 			}
 		}
 		if (write_count > 0) {
 			for (i = 0; i < write_count; i++) {
-				val = rz_analysis_value_new();
+				val = rz_analysis_op_value_new(op);
 				val->type = RZ_ANALYSIS_VAL_REG;
 				val->access = RZ_ANALYSIS_ACC_W;
 				val->reg = cs_reg2reg(reg, handle, regs_write[i]);
-				rz_list_append(ret, val);
+				rz_analysis_op_access_add(op, val);
 			}
 		}
 	}
@@ -1936,70 +1931,70 @@ static void set_access_info(RzReg *reg, RzAnalysisOp *op, csh *handle, cs_insn *
 
 	switch (insn->id) {
 	case X86_INS_PUSH:
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -INSOP(0).size;
 		val->memref = INSOP(0).size;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_PUSHAW:
 		// AX, CX, DX, BX, SP, BP, SI, DI
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -16;
 		val->memref = 16;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_PUSHAL:
 		// EAX, ECX, EDX, EBX, EBP, ESP, EBP, ESI, EDI
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -32;
 		val->memref = 32;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_PUSHF:
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -2;
 		val->memref = 2;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_PUSHFD:
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -4;
 		val->memref = 4;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_PUSHFQ:
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -8;
 		val->memref = 8;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	case X86_INS_CALL:
 	case X86_INS_LCALL:
-		val = rz_analysis_value_new();
+		val = rz_analysis_op_value_new(op);
 		val->type = RZ_ANALYSIS_VAL_MEM;
 		val->access = RZ_ANALYSIS_ACC_W;
 		val->reg = cs_reg2reg(reg, handle, sp);
 		val->delta = -regsz;
 		val->memref = regsz;
-		rz_list_append(ret, val);
+		rz_analysis_op_access_add(op, val);
 		break;
 	default:
 		break;
@@ -2008,7 +2003,7 @@ static void set_access_info(RzReg *reg, RzAnalysisOp *op, csh *handle, cs_insn *
 	// Memory access info based on operands
 	for (i = 0; i < INSOPS; i++) {
 		if (INSOP(i).type == X86_OP_MEM) {
-			val = rz_analysis_value_new();
+			val = rz_analysis_op_value_new(op);
 			val->type = RZ_ANALYSIS_VAL_MEM;
 #if CS_API_MAJOR >= 4
 			switch (INSOP(i).access) {
@@ -2035,18 +2030,16 @@ static void set_access_info(RzReg *reg, RzAnalysisOp *op, csh *handle, cs_insn *
 			val->seg = cs_reg2reg(reg, handle, INSOP(i).mem.segment);
 			val->reg = cs_reg2reg(reg, handle, INSOP(i).mem.base);
 			val->regdelta = cs_reg2reg(reg, handle, INSOP(i).mem.index);
-			rz_list_append(ret, val);
+			rz_analysis_op_access_add(op, val);
 		}
 	}
-
-	op->access = ret;
 }
 
 #define CREATE_SRC_DST(op) \
-	(op)->src[0] = rz_analysis_value_new(); \
-	(op)->src[1] = rz_analysis_value_new(); \
-	(op)->src[2] = rz_analysis_value_new(); \
-	(op)->dst = rz_analysis_value_new();
+	(op)->src[0] = rz_analysis_op_value_new(op); \
+	(op)->src[1] = rz_analysis_op_value_new(op); \
+	(op)->src[2] = rz_analysis_op_value_new(op); \
+	(op)->dst = rz_analysis_op_value_new(op);
 
 static void set_src_dst(RzReg *reg, RzAnalysisValue *val, csh *handle, cs_insn *insn, int x) {
 	switch (INSOP(x).type) {
@@ -3177,11 +3170,11 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = strdup("invalid");
+			op->mnemonic = rz_analysis_op_strdup(op, "invalid");
 		}
 	} else {
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = rz_str_newf("%s%s%s",
+			op->mnemonic = rz_analysis_op_newf(op, "%s%s%s",
 				ctx->insn->mnemonic,
 				ctx->insn->op_str[0] ? " " : "",
 				ctx->insn->op_str);
@@ -1488,57 +1488,61 @@ static bool xrefs_load_cb(void *user, const char *k, const char *v) {
 		return false;
 	}
 
-	char *json_str = strdup(v);
-	if (!json_str) {
-		return true;
-	}
-	RzJson *json = rz_json_parse(json_str);
-	if (!json || json->type != RZ_JSON_ARRAY) {
-		free(json_str);
-		return false;
+	// [{"to":<ut64>, "type":"<char>"?}, ...], there are lots of them so no tree is built
+	RzJsonReader r;
+	rz_json_reader_init(&r, v);
+	bool ret = false;
+	if (rz_json_reader_next(&r) != RZ_JSON_EVENT_ARRAY) {
+		goto beach;
 	}
-
-	const RzJson *child;
-	for (child = json->children.first; child; child = child->next) {
-		if (child->type != RZ_JSON_OBJECT) {
-			goto error;
-		}
-		const RzJson *baby = rz_json_get(child, "to");
-		if (!baby || baby->type != RZ_JSON_INTEGER) {
-			goto error;
+	RzJsonEvent ev;
+	while ((ev = rz_json_reader_next(&r)) != RZ_JSON_EVENT_CLOSE) {
+		if (ev != RZ_JSON_EVENT_OBJECT) {
+			goto beach;
 		}
-		ut64 to = baby->num.u_value;
-
+		bool has_to = false, has_type = false;
+		ut64 to = 0;
 		RzAnalysisXRefType type = RZ_ANALYSIS_REF_TYPE_NULL;
-		baby = rz_json_get(child, "type");
-		if (baby) {
-			// must be a 1-char string
-			if (baby->type != RZ_JSON_STRING || !baby->str_value[0] || baby->str_value[1]) {
-				goto error;
-			}
-			switch (baby->str_value[0]) {
-			case RZ_ANALYSIS_REF_TYPE_CODE:
-			case RZ_ANALYSIS_REF_TYPE_CALL:
-			case RZ_ANALYSIS_REF_TYPE_DATA:
-			case RZ_ANALYSIS_REF_TYPE_STRING:
-				type = baby->str_value[0];
-				break;
-			default:
-				goto error;
+		while ((ev = rz_json_reader_next(&r)) != RZ_JSON_EVENT_CLOSE) {
+			if (ev == RZ_JSON_EVENT_ERROR) {
+				goto beach;
+			}
+			if (!has_to && rz_json_reader_key_eq(&r, "to")) {
+				if (r.type != RZ_JSON_INTEGER) {
+					goto beach;
+				}
+				to = rz_json_reader_num(&r);
+				has_to = true;
+			} else if (!has_type && rz_json_reader_key_eq(&r, "type")) {
+				// must be a 1-char string
+				if (r.type != RZ_JSON_STRING || r.value_len != 1) {
+					goto beach;
+				}
+				switch (r.value[0]) {
+				case RZ_ANALYSIS_REF_TYPE_CODE:
+				case RZ_ANALYSIS_REF_TYPE_CALL:
+				case RZ_ANALYSIS_REF_TYPE_DATA:
+				case RZ_ANALYSIS_REF_TYPE_STRING:
+					type = r.value[0];
+					break;
+				default:
+					goto beach;
+				}
+				has_type = true;
+			}
+			if (ev != RZ_JSON_EVENT_VALUE && !rz_json_reader_skip(&r)) {
+				goto beach;
 			}
 		}
-
+		if (!has_to) {
+			goto beach;
+		}
 		rz_analysis_xrefs_set(analysis, from, to, type);
 	}
-
-	rz_json_free(json);
-	free(json_str);
-
-	return true;
-error:
-	rz_json_free(json);
-	free(json_str);
-	return false;
+	ret = true;
+beach:
+	rz_json_reader_fini(&r);
+	return ret;
 }
 
 RZ_API bool rz_serialize_analysis_xrefs_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
@@ -2262,7 +2262,7 @@ RZ_API bool rz_sign_foreach(RzAnalysis *a, RzSignForeachCallback cb, void *user)
 RZ_API RzSignSearch *rz_sign_search_new(void) {
 	RzSignSearch *ret = RZ_NEW0(RzSignSearch);
 	if (ret) {
-		ret->search = rz_search_new(RZ_SEARCH_KEYWORD);
+		ret->search = rz_search_new(RZ_SEARCH_MULTI);
 		ret->items = rz_list_newf((RzListFree)rz_sign_item_free);
 	}
 	return ret;
@@ -2312,7 +2312,7 @@ RZ_API void rz_sign_search_init(RzAnalysis *a, RzSignSearch *ss, int minsz, RzSi
 	ss->cb = cb;
 	ss->user = user;
 	rz_list_purge(ss->items);
-	rz_search_reset(ss->search, RZ_SEARCH_KEYWORD);
+	rz_search_reset(ss->search, RZ_SEARCH_MULTI);
 	rz_sign_foreach_nofree(a, addSearchKwCB, &ctx);
 	rz_search_begin(ss->search);
 	rz_search_set_callback(ss->search, searchHitCB, ss);
@@ -393,23 +393,25 @@ RZ_API RZ_BORROW RzPVector *rz_analysis_function_get_vars_used_at(RzAnalysisFunc
 	return ht_up_find(fcn->inst_vars, (st64)op_addr - (st64)fcn->addr, NULL);
 }
 
-RZ_API RZ_DEPRECATE RzAnalysisVar *rz_analysis_get_used_function_var(RzAnalysis *analysis, ut64 addr) {
-	RzList *fcns = rz_analysis_get_functions_in(analysis, addr);
-	if (!fcns) {
-		return NULL;
-	}
-	RzAnalysisVar *var = NULL;
-	RzListIter *it;
-	RzAnalysisFunction *fcn;
-	rz_list_foreach (fcns, it, fcn) {
-		RzPVector *used_vars = rz_analysis_function_get_vars_used_at(fcn, addr);
-		if (used_vars && !rz_pvector_empty(used_vars)) {
-			var = rz_pvector_at(used_vars, 0);
-			break;
-		}
+typedef struct {
+	ut64 addr;
+	RzAnalysisVar *var;
+} UsedFunctionVarCtx;
+
+static bool used_function_var_cb(RzAnalysisFunction *fcn, void *user) {
+	UsedFunctionVarCtx *ctx = user;
+	RzPVector *used_vars = rz_analysis_function_get_vars_used_at(fcn, ctx->addr);
+	if (used_vars && !rz_pvector_empty(used_vars)) {
+		ctx->var = rz_pvector_at(used_vars, 0);
+		return false;
 	}
-	rz_list_free(fcns);
-	return var;
+	return true;
+}
+
+RZ_API RZ_DEPRECATE RzAnalysisVar *rz_analysis_get_used_function_var(RzAnalysis *analysis, ut64 addr) {
+	UsedFunctionVarCtx ctx = { addr, NULL };
+	rz_analysis_functions_foreach_in(analysis, addr, used_function_var_cb, &ctx);
+	return ctx.var;
 }
 
 RZ_API RzAnalysisVar *rz_analysis_var_get_dst_var(RzAnalysisVar *var) {
@@ -160,6 +160,40 @@ RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzA
 	return true;
 }
 
+typedef struct {
+	RzVector /*<ut64>*/ to;
+	RzAnalysisXRefType type;
+} XRefsDelFromCtx;
+
+static bool collect_xref_key(void *user, const ut64 k, const void *v) {
+	XRefsDelFromCtx *ctx = user;
+	const RzAnalysisXRef *xref = v;
+	if (ctx->type == RZ_ANALYSIS_REF_TYPE_NULL || xref->type == ctx->type) {
+		rz_vector_push(&ctx->to, (void *)&k);
+	}
+	return true;
+}
+
+/**
+ * \brief Delete the cross references going out of \p from
+ * \param type only delete the ones of this type, or all of them with RZ_ANALYSIS_REF_TYPE_NULL
+ */
+RZ_API void rz_analysis_xrefs_del_from(RzAnalysis *analysis, ut64 from, RzAnalysisXRefType type) {
+	rz_return_if_fail(analysis);
+	HtUP *ht = ht_up_find(analysis->ht_xrefs_from, from, NULL);
+	if (!ht) {
+		return;
+	}
+	XRefsDelFromCtx ctx = { .type = type };
+	rz_vector_init(&ctx.to, sizeof(ut64), NULL, NULL);
+	ht_up_foreach(ht, collect_xref_key, &ctx);
+	ut64 *addr;
+	rz_vector_foreach(&ctx.to, addr) {
+		rz_analysis_xrefs_deln(analysis, from, *addr, type);
+	}
+	rz_vector_fini(&ctx.to);
+}
+
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to) {
 	bool res = false;
 	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_REF_TYPE_NULL);
@@ -145,33 +145,13 @@ static inline void detected_string_to_bin_string(RzBinString *dst, RzDetectedStr
 	free(src);
 }
 
-static int string_scan_range(RzList *list, RzBinFile *bf, int min,
-	const ut64 from, const ut64 to, RzStrEnc type, int raw, RzBinSection *section) {
-
-	rz_return_val_if_fail(bf, -1);
-
+// Turn the strings found in [from, to) into RzBinStrings appended to list, or print them when list is NULL
+static void add_detected_strings(RzList *list, RzBinFile *bf, RzList /*<RzDetectedString>*/ *str_list,
+	const ut64 from, const ut64 to, int raw, RzBinSection *section) {
 	RzListIter *it;
 	RzDetectedString *str;
 	RzBinSection *s = NULL;
 
-	RzList *str_list = rz_list_new();
-	if (!str_list) {
-		return -1;
-	}
-
-	RzUtilStrScanOptions scan_opt = {
-		.buf_size = 2048,
-		.max_uni_blocks = 4,
-		.min_str_length = min,
-		.prefer_big_endian = false
-	};
-
-	int count = rz_scan_strings(bf->buf, str_list, &scan_opt, from, to, type);
-	if (count <= 0) {
-		rz_list_free(str_list);
-		return 0;
-	}
-
 	PJ *pj = NULL;
 	if (bf->strmode == RZ_MODE_JSON && !list) {
 		pj = pj_new();
@@ -224,9 +204,31 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 		}
 		pj_free(pj);
 	}
+}
+
+static int string_scan_range(RzList *list, RzBinFile *bf, int min,
+	const ut64 from, const ut64 to, RzStrEnc type, int raw, RzBinSection *section) {
+
+	rz_return_val_if_fail(bf, -1);
+
+	RzList *str_list = rz_list_new();
+	if (!str_list) {
+		return -1;
+	}
 
+	RzUtilStrScanOptions scan_opt = {
+		.buf_size = 2048,
+		.max_uni_blocks = 4,
+		.min_str_length = min,
+		.prefer_big_endian = false
+	};
+
+	int count = rz_scan_strings(bf->buf, str_list, &scan_opt, from, to, type);
+	if (count > 0) {
+		add_detected_strings(list, bf, str_list, from, to, raw, section);
+	}
 	rz_list_free(str_list);
-	return count;
+	return RZ_MAX(count, 0);
 }
 
 static bool __isDataSection(RzBinFile *a, RzBinSection *s) {
@@ -240,65 +242,157 @@ static bool __isDataSection(RzBinFile *a, RzBinSection *s) {
 	return strstr(s->name, "_const") != NULL;
 }
 
-static void get_strings_range(RzBinFile *bf, RzList *list, int min, int raw, ut64 from, ut64 to, RzBinSection *section) {
-	rz_return_if_fail(bf && bf->buf);
+// Check whether strings are searched at all in [from, *to) and with which length and encoding
+static bool get_strings_range_opts(RzBinFile *bf, int *min, int raw, ut64 from, ut64 *to, RzStrEnc *type) {
+	rz_return_val_if_fail(bf && bf->buf, false);
 
 	RzBinPlugin *plugin = rz_bin_file_cur_plugin(bf);
 
 	if (!raw && (!plugin || !plugin->info)) {
-		return;
+		return false;
 	}
-	if (!min) {
-		min = plugin ? plugin->minstrlen : 4;
+	if (!*min) {
+		*min = plugin ? plugin->minstrlen : 4;
 	}
 	/* Some plugins return zero, fix it up */
-	if (!min) {
-		min = 4;
+	if (!*min) {
+		*min = 4;
 	}
-	if (min < 0) {
-		return;
+	if (*min < 0) {
+		return false;
 	}
 	if (!bf->rbin->is_debugger) {
-		if (!to || to > rz_buf_size(bf->buf)) {
-			to = rz_buf_size(bf->buf);
+		if (!*to || *to > rz_buf_size(bf->buf)) {
+			*to = rz_buf_size(bf->buf);
 		}
-		if (!to) {
-			return;
+		if (!*to) {
+			return false;
 		}
 	}
 	if (raw != 2) {
-		ut64 size = to - from;
+		ut64 size = *to - from;
 		// in case of dump ignore here
 		if (bf->rbin->maxstrbuf && size && size > bf->rbin->maxstrbuf) {
 			if (bf->rbin->verbose) {
 				eprintf("WARNING: bin_strings buffer is too big (0x%08" PFMT64x "). Use -zzz or set bin.maxstrbuf (RZ_BIN_MAXSTRBUF) in rizin (rz_bin)\n",
 					size);
 			}
-			return;
+			return false;
 		}
 	}
 
-	RzStrEnc type;
 	const char *enc = bf->rbin->strenc;
 	if (!enc) {
-		type = RZ_STRING_ENC_GUESS;
+		*type = RZ_STRING_ENC_GUESS;
 	} else if (!strcmp(enc, "latin1")) {
-		type = RZ_STRING_ENC_LATIN1;
+		*type = RZ_STRING_ENC_LATIN1;
 	} else if (!strcmp(enc, "utf8")) {
-		type = RZ_STRING_ENC_UTF8;
+		*type = RZ_STRING_ENC_UTF8;
 	} else if (!strcmp(enc, "utf16le")) {
-		type = RZ_STRING_ENC_UTF16LE;
+		*type = RZ_STRING_ENC_UTF16LE;
 	} else if (!strcmp(enc, "utf32le")) {
-		type = RZ_STRING_ENC_UTF32LE;
+		*type = RZ_STRING_ENC_UTF32LE;
 	} else if (!strcmp(enc, "utf16be")) {
-		type = RZ_STRING_ENC_UTF16BE;
+		*type = RZ_STRING_ENC_UTF16BE;
 	} else if (!strcmp(enc, "utf32be")) {
-		type = RZ_STRING_ENC_UTF32BE;
+		*type = RZ_STRING_ENC_UTF32BE;
 	} else {
 		eprintf("ERROR: encoding %s not supported\n", enc);
+		return false;
+	}
+	return true;
+}
+
+static void get_strings_range(RzBinFile *bf, RzList *list, int min, int raw, ut64 from, ut64 to, RzBinSection *section) {
+	RzStrEnc type;
+	if (get_strings_range_opts(bf, &min, raw, from, &to, &type)) {
+		string_scan_range(list, bf, min, from, to, type, raw, section);
+	}
+}
+
+/* Data section whose strings are searched by one of the threads of get_sections_strings() */
+typedef struct {
+	RzBinSection *section;
+	ut64 from, to;
+	int min;
+	RzStrEnc type;
+	RzList /*<RzDetectedString>*/ *found;
+} SectionStrings;
+
+typedef struct {
+	RzBinFile *bf;
+	SectionStrings *ranges;
+	RzThreadLock *lock; ///< protects the reads from bf->buf
+} SectionStringsScan;
+
+static void scan_section_strings(void *user, size_t i) {
+	SectionStringsScan *scan = user;
+	SectionStrings *r = &scan->ranges[i];
+	// zeroed, as a short read (e.g. past the end of a debugger map) leaves the rest unset
+	ut8 *bytes = calloc(r->to - r->from, 1);
+	if (!bytes) {
+		return;
+	}
+	rz_th_lock_enter(scan->lock);
+	rz_buf_read_at(scan->bf->buf, r->from, bytes, r->to - r->from);
+	rz_th_lock_leave(scan->lock);
+	RzUtilStrScanOptions scan_opt = {
+		.buf_size = 2048,
+		.max_uni_blocks = 4,
+		.min_str_length = r->min,
+		.prefer_big_endian = false
+	};
+	r->found = rz_list_new();
+	if (r->found) {
+		rz_scan_strings_raw(bytes, r->found, &scan_opt, r->from, r->to, r->type);
+	}
+	free(bytes);
+}
+
+// Search the strings of the data sections in parallel, the result is the same as one section after the other
+static void get_sections_strings(RzBinFile *bf, RzList *list, int min, int raw) {
+	RzPVector *data = rz_pvector_new(NULL);
+	if (!data) {
 		return;
 	}
-	string_scan_range(list, bf, min, from, to, type, raw, section);
+	RzListIter *iter;
+	RzBinSection *section;
+	rz_list_foreach (bf->o->sections, iter, section) {
+		if (__isDataSection(bf, section)) {
+			rz_pvector_push(data, section);
+		}
+	}
+	SectionStringsScan scan = { .bf = bf };
+	scan.ranges = RZ_NEWS0(SectionStrings, rz_pvector_len(data));
+	scan.lock = rz_th_lock_new(false);
+	if (!scan.ranges || !scan.lock) {
+		goto beach;
+	}
+	size_t i, count = 0;
+	void **it;
+	rz_pvector_foreach (data, it) {
+		SectionStrings *r = &scan.ranges[count];
+		r->section = *it;
+		r->from = r->section->paddr;
+		r->to = r->section->paddr + r->section->size;
+		r->min = min;
+		if (get_strings_range_opts(bf, &r->min, raw, r->from, &r->to, &r->type) && r->from < r->to) {
+			count++;
+		}
+	}
+
+	rz_th_parallel_for(count, scan_section_strings, &scan);
+	for (i = 0; i < count; i++) {
+		SectionStrings *r = &scan.ranges[i];
+		if (r->found) {
+			add_detected_strings(list, bf, r->found, r->from, r->to, raw, r->section);
+			rz_list_free(r->found);
+		}
+	}
+beach:
+	rz_th_lock_free(scan.lock);
+	free(scan.ranges);
+	rz_pvector_free(data);
 }
 
 RZ_IPI RzBinFile *rz_bin_file_new(RzBin *bin, const char *file, ut64 file_sz, int rawstr, int fd, const char *xtrname, Sdb *sdb, bool steal_ptr) {
@@ -634,10 +728,14 @@ RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *bf, int min, int dump, int raw
 
 	if (!raw && bf && bf->o && bf->o->sections && !rz_list_empty(bf->o->sections)) {
 		RzBinObject *o = bf->o;
-		rz_list_foreach (o->sections, iter, section) {
-			if (__isDataSection(bf, section)) {
-				get_strings_range(bf, ret, min, raw, section->paddr,
-					section->paddr + section->size, section);
+		if (ret) {
+			get_sections_strings(bf, ret, min, raw);
+		} else {
+			rz_list_foreach (o->sections, iter, section) {
+				if (__isDataSection(bf, section)) {
+					get_strings_range(bf, ret, min, raw, section->paddr,
+						section->paddr + section->size, section);
+				}
 			}
 		}
 		rz_list_foreach (o->sections, iter, section) {
@@ -936,7 +936,7 @@ RZ_API RzBuffer *rz_bin_package(RzBin *bin, const char *type, const char *file,
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail(bin, NULL);
 	RzBinObject *o = rz_bin_cur_object(bin);
-	return o ? o->classes : NULL;
+	return o ? (RzList *)rz_bin_object_get_classes(o) : NULL;
 }
 
 RZ_API ut64 rz_bin_get_size(RzBin *bin) {
@@ -371,6 +371,80 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+static void object_load_strings(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	int minlen = (bin->minstrlen > 0) ? bin->minstrlen : p->minstrlen;
+	o->strings = p->strings
+		? p->strings(bf)
+		: rz_bin_file_get_strings(bf, minlen, 0, bf->rawstr);
+	if (bin->debase64) {
+		rz_bin_object_filter_strings(o);
+	}
+	REBASE_PADDR(o, o->strings, RzBinString);
+}
+
+// Returns true if the classes come from a swift binary
+static bool object_load_classes(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	bool isSwift = false;
+	if (p->classes) {
+		RzList *classes = p->classes(bf);
+		if (classes) {
+			// XXX we should probably merge them instead
+			rz_list_free(o->classes);
+			o->classes = classes;
+			rz_bin_object_rebuild_classes_ht(o);
+		}
+		isSwift = rz_bin_lang_swift(bf);
+		if (isSwift) {
+			o->classes = classes_from_symbols(bf);
+		}
+	} else {
+		RzList *classes = classes_from_symbols(bf);
+		if (classes) {
+			o->classes = classes;
+		}
+	}
+	if (bf->rbin->filter) {
+		filter_classes(bf, o->classes);
+	}
+	// cache addr=class+method
+	if (o->classes) {
+		RzList *klasses = o->classes;
+		RzListIter *iter, *iter2;
+		RzBinClass *klass;
+		RzBinSymbol *method;
+		if (!o->addrzklassmethod) {
+			// this is slow. must be optimized, but at least its cached
+			o->addrzklassmethod = ht_up_new0();
+			rz_list_foreach (klasses, iter, klass) {
+				rz_list_foreach (klass->methods, iter2, method) {
+					ht_up_insert(o->addrzklassmethod, method->vaddr, method);
+				}
+			}
+		}
+	}
+	return isSwift;
+}
+
+/**
+ * Compute the items of \p o deferred by bin.lazy the first time they are asked for.
+ * The flag is cleared first, so that the plugins can use the accessors while loading.
+ */
+static void object_load_lazy(RzBinObject *o, ut64 req) {
+	if (!(o->lazy_items & req) || !o->bf) {
+		return;
+	}
+	o->lazy_items &= ~req;
+	if (req & RZ_BIN_REQ_STRINGS) {
+		object_load_strings(o->bf, o);
+	}
+	if (req & RZ_BIN_REQ_CLASSES) {
+		object_load_classes(o->bf, o);
+	}
+}
+
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o && o->plugin, false);
 
@@ -378,8 +452,9 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	bool isSwift = false;
 	RzBin *bin = bf->rbin;
 	RzBinPlugin *p = o->plugin;
-	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
 	bf->o = o;
+	o->bf = bf;
+	o->lazy_items = 0;
 
 	if (p->file_type) {
 		int type = p->file_type(bf);
@@ -480,51 +555,19 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 		}
 	}
 	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
-		o->strings = p->strings
-			? p->strings(bf)
-			: rz_bin_file_get_strings(bf, minlen, 0, bf->rawstr);
-		if (bin->debase64) {
-			rz_bin_object_filter_strings(o);
+		if (bin->lazy) {
+			o->lazy_items |= RZ_BIN_REQ_STRINGS;
+		} else {
+			object_load_strings(bf, o);
 		}
-		REBASE_PADDR(o, o->strings, RzBinString);
 	}
 	if (bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES)) {
-		if (p->classes) {
-			RzList *classes = p->classes(bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free(o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht(o);
-			}
-			isSwift = rz_bin_lang_swift(bf);
-			if (isSwift) {
-				o->classes = classes_from_symbols(bf);
-			}
+		if (bin->lazy) {
+			o->lazy_items |= RZ_BIN_REQ_CLASSES;
+			// the language, and so the demangling of the symbols, cannot wait for the classes
+			isSwift = p->classes && rz_bin_lang_swift(bf);
 		} else {
-			RzList *classes = classes_from_symbols(bf);
-			if (classes) {
-				o->classes = classes;
-			}
-		}
-		if (bin->filter) {
-			filter_classes(bf, o->classes);
-		}
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = ht_up_new0();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						ht_up_insert(o->addrzklassmethod, method->vaddr, method);
-					}
-				}
-			}
+			isSwift = object_load_classes(bf, o);
 		}
 	}
 	if (p->lines) {
@@ -779,6 +822,7 @@ RZ_API RzList *rz_bin_object_get_segments(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_lazy(obj, RZ_BIN_REQ_CLASSES);
 	return obj->classes;
 }
 
@@ -787,6 +831,7 @@ RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_strings(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_lazy(obj, RZ_BIN_REQ_STRINGS);
 	return obj->strings;
 }
 
@@ -817,6 +862,7 @@ RZ_API const RzList *rz_bin_object_reset_strings(RzBin *bin, RzBinFile *bf, RzBi
 	}
 	ht_up_free(obj->strings_db);
 	obj->strings_db = ht_up_new0();
+	obj->lazy_items &= ~RZ_BIN_REQ_STRINGS;
 
 	bf->rawstr = bin->rawstr;
 	RzBinPlugin *plugin = obj->plugin;
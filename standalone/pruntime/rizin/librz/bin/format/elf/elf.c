@@ -469,6 +469,9 @@ void Elf_(rz_bin_elf_free)(RZ_NONNULL ELFOBJ *bin) {
 
 	rz_vector_free(bin->symbols);
 	rz_vector_free(bin->imports);
+	ht_up_free(bin->symbols_by_ordinal);
+	ht_up_free(bin->imports_by_ordinal);
+	ht_up_free(bin->symbols_strtabs);
 
 	free(bin);
 }
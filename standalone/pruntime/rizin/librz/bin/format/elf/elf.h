@@ -137,7 +137,7 @@ typedef struct rz_bin_elf_symbol_t {
 	ut32 ordinal;
 	const char *bind;
 	const char *type;
-	RZ_OWN char *name;
+	RZ_BORROW const char *name; ///< points into a string table or a section name of the ELFOBJ
 } RzBinElfSymbol;
 
 typedef struct rz_bin_elf_reloc_t {
@@ -216,6 +216,9 @@ struct Elf_(rz_bin_elf_obj_t) {
 
 	RzVector *symbols; // RzVector<RzBinElfSymbol>
 	RzVector *imports; // RzVector<RzBinElfSymbol>
+	HtUP *symbols_by_ordinal; // HtUP<RzBinElfSymbol *> into symbols, built on first lookup
+	HtUP *imports_by_ordinal; // HtUP<RzBinElfSymbol *> into imports, built on first lookup
+	HtUP *symbols_strtabs; // HtUP<RzBinElfStrtab *> by section index, the symbol names point into them
 };
 
 // elf.c
@@ -345,6 +348,7 @@ void Elf_(rz_bin_elf_strtab_free)(RzBinElfStrtab *ptr);
 typedef bool (*RzBinElfSymbolFilter)(ELFOBJ *bin, Elf_(Sym) * entry, bool is_dynamic);
 
 Elf_(Word) Elf_(rz_bin_elf_get_number_of_dynamic_symbols)(RZ_NONNULL ELFOBJ *bin);
+RZ_OWN HtUP *Elf_(rz_bin_elf_symbols_index_new)(RZ_NONNULL RzVector *symbols);
 RZ_BORROW RzBinElfSymbol *Elf_(rz_bin_elf_get_symbol)(RZ_NONNULL ELFOBJ *bin, ut32 ordinal);
 RZ_OWN RzVector *Elf_(rz_bin_elf_compute_symbols)(ELFOBJ *bin, RzBinElfSymbolFilter filter);
 RZ_OWN RzVector *Elf_(rz_bin_elf_symbols_new)(RZ_NONNULL ELFOBJ *bin);
@@ -315,14 +315,18 @@ static bool filter_import(ELFOBJ *bin, Elf_(Sym) * symbol, bool is_dynamic) {
 RZ_BORROW RzBinElfSymbol *Elf_(rz_bin_elf_get_import)(RZ_NONNULL ELFOBJ *bin, ut32 ordinal) {
 	rz_return_val_if_fail(bin, NULL);
 
-	RzBinElfSymbol *import;
-	rz_bin_elf_foreach_imports(bin, import) {
-		if (import->ordinal == ordinal) {
-			return import;
+	if (!Elf_(rz_bin_elf_has_imports)(bin)) {
+		return NULL;
+	}
+
+	if (!bin->imports_by_ordinal) {
+		bin->imports_by_ordinal = Elf_(rz_bin_elf_symbols_index_new)(bin->imports);
+		if (!bin->imports_by_ordinal) {
+			return NULL;
 		}
 	}
 
-	return NULL;
+	return ht_up_find(bin->imports_by_ordinal, ordinal, NULL);
 }
 
 RZ_OWN RzVector *Elf_(rz_bin_elf_analyse_imports)(RZ_NONNULL ELFOBJ *bin) {
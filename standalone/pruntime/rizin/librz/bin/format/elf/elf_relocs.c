@@ -7,6 +7,9 @@
 #include "elf.h"
 #include <ht_uu.h>
 
+// relocation tables are read by blocks of this size instead of field by field
+#define RELOCS_CHUNK_SIZE 0x10000
+
 struct relocs_segment {
 	ut64 offset;
 	ut64 size;
@@ -14,6 +17,12 @@ struct relocs_segment {
 	ut64 mode;
 };
 
+struct relocs_chunk {
+	ut8 *data;
+	ut64 offset;
+	ut64 size;
+};
+
 static struct relocs_segment relocs_segment_init(ut64 offset, ut64 size, ut64 entry_size, ut64 mode) {
 	return (struct relocs_segment){
 		.offset = offset,
@@ -80,9 +89,41 @@ static bool read_reloc_entry(ELFOBJ *bin, Elf_(Rela) * reloc, ut64 offset, ut64
 	return true;
 }
 
-static bool get_reloc_entry(ELFOBJ *bin, RzBinElfReloc *reloc, ut64 offset, ut64 mode) {
+static void read_reloc_entry_from_chunk(ELFOBJ *bin, Elf_(Rela) * reloc, const ut8 *data, ut64 mode) {
+#if RZ_BIN_ELF64
+	reloc->rz_offset = rz_read_ble64(data, bin->big_endian);
+	reloc->rz_info = rz_read_ble64(data + 8, bin->big_endian);
+	reloc->rz_addend = mode == DT_REL ? 0 : (st64)rz_read_ble64(data + 16, bin->big_endian);
+#else
+	reloc->rz_offset = rz_read_ble32(data, bin->big_endian);
+	reloc->rz_info = rz_read_ble32(data + 4, bin->big_endian);
+	reloc->rz_addend = mode == DT_REL ? 0 : (st32)rz_read_ble32(data + 8, bin->big_endian);
+#endif
+}
+
+static bool read_reloc_entry_chunked(ELFOBJ *bin, struct relocs_segment *segment, struct relocs_chunk *chunk, Elf_(Rela) * reloc, ut64 offset) {
+	ut64 size = get_size_rel_mode(segment->mode);
+	if (offset < chunk->offset || offset - chunk->offset + size > chunk->size) {
+		ut64 end = segment->offset + segment->size;
+		ut64 chunk_size = end > offset ? RZ_MIN(end - offset, RELOCS_CHUNK_SIZE) : 0;
+		chunk_size = RZ_MAX(chunk_size, size);
+		st64 read = rz_buf_read_at(bin->b, offset, chunk->data, chunk_size);
+		chunk->offset = offset;
+		chunk->size = read > 0 ? read : 0;
+		if (chunk->size < size) {
+			// let the field by field reader report the error
+			return read_reloc_entry(bin, reloc, offset, segment->mode);
+		}
+	}
+
+	read_reloc_entry_from_chunk(bin, reloc, chunk->data + (offset - chunk->offset), segment->mode);
+	return true;
+}
+
+static bool get_reloc_entry(ELFOBJ *bin, RzBinElfReloc *reloc, struct relocs_segment *segment, struct relocs_chunk *chunk, ut64 offset) {
+	ut64 mode = segment->mode;
 	Elf_(Rela) tmp;
-	if (!read_reloc_entry(bin, &tmp, offset, mode)) {
+	if (!read_reloc_entry_chunked(bin, segment, chunk, &tmp, offset)) {
 		return false;
 	}
 
@@ -103,27 +144,37 @@ static bool has_already_been_processed(ELFOBJ *bin, ut64 offset, HtUU *set) {
 }
 
 static bool get_relocs_entry(ELFOBJ *bin, RzBinElfSection *section, RzVector *relocs, struct relocs_segment *segment, HtUU *set) {
+	struct relocs_chunk chunk = { 0 };
+	chunk.data = malloc(RZ_MAX(RELOCS_CHUNK_SIZE, sizeof(Elf_(Rela))));
+	if (!chunk.data) {
+		return false;
+	}
+
 	for (ut64 entry_offset = 0; entry_offset < segment->size; entry_offset += segment->entry_size) {
 		if (has_already_been_processed(bin, segment->offset + entry_offset, set)) {
 			continue;
 		}
 
 		if (!ht_uu_insert(set, segment->offset + entry_offset, segment->offset + entry_offset)) {
+			free(chunk.data);
 			return false;
 		}
 
 		RzBinElfReloc tmp = { 0 };
-		if (!get_reloc_entry(bin, &tmp, segment->offset + entry_offset, segment->mode)) {
+		if (!get_reloc_entry(bin, &tmp, segment, &chunk, segment->offset + entry_offset)) {
+			free(chunk.data);
 			return false;
 		}
 
 		fix_rva_and_offset(bin, &tmp, section);
 
 		if (!rz_vector_push(relocs, &tmp)) {
+			free(chunk.data);
 			return false;
 		}
 	}
 
+	free(chunk.data);
 	return true;
 }
 
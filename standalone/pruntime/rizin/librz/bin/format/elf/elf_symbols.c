@@ -9,6 +9,9 @@
 
 #define HASH_NCHAIN_OFFSET(x) ((x) + 4)
 
+// symbol tables are read by blocks of this size instead of field by field
+#define SYMBOLS_CHUNK_SIZE 0x10000
+
 struct symbols_segment {
 	ut64 offset;
 	ut64 number;
@@ -17,6 +20,12 @@ struct symbols_segment {
 	RZ_BORROW RzBinElfStrtab *strtab;
 };
 
+struct symbols_chunk {
+	ut8 *data;
+	ut64 offset;
+	ut64 size;
+};
+
 struct symbol_bind_translation {
 	unsigned char bind;
 	const char *name;
@@ -177,6 +186,42 @@ static bool get_symbol_entry(ELFOBJ *bin, ut64 offset, Elf_(Sym) * result) {
 	return true;
 }
 
+static void get_symbol_entry_from_chunk(ELFOBJ *bin, const ut8 *data, Elf_(Sym) * result) {
+#if RZ_BIN_ELF64
+	result->st_name = rz_read_ble32(data, bin->big_endian);
+	result->st_info = data[4];
+	result->st_other = data[5];
+	result->st_shndx = rz_read_ble16(data + 6, bin->big_endian);
+	result->st_value = rz_read_ble64(data + 8, bin->big_endian);
+	result->st_size = rz_read_ble64(data + 16, bin->big_endian);
+#else
+	result->st_name = rz_read_ble32(data, bin->big_endian);
+	result->st_value = rz_read_ble32(data + 4, bin->big_endian);
+	result->st_size = rz_read_ble32(data + 8, bin->big_endian);
+	result->st_info = data[12];
+	result->st_other = data[13];
+	result->st_shndx = rz_read_ble16(data + 14, bin->big_endian);
+#endif
+}
+
+static bool get_symbol_entry_chunked(ELFOBJ *bin, struct symbols_segment *segment, struct symbols_chunk *chunk, ut64 offset, Elf_(Sym) * result) {
+	if (offset < chunk->offset || offset - chunk->offset + sizeof(Elf_(Sym)) > chunk->size) {
+		ut64 end = segment->offset + segment->number * segment->entry_size;
+		ut64 size = end > offset ? RZ_MIN(end - offset, SYMBOLS_CHUNK_SIZE) : 0;
+		size = RZ_MAX(size, sizeof(Elf_(Sym)));
+		st64 read = rz_buf_read_at(bin->b, offset, chunk->data, size);
+		chunk->offset = offset;
+		chunk->size = read > 0 ? read : 0;
+		if (chunk->size < sizeof(Elf_(Sym))) {
+			// let the field by field reader report the error
+			return get_symbol_entry(bin, offset, result);
+		}
+	}
+
+	get_symbol_entry_from_chunk(bin, chunk->data + (offset - chunk->offset), result);
+	return true;
+}
+
 static bool is_section_local_symbol(ELFOBJ *bin, Elf_(Sym) * symbol) {
 	if (symbol->st_name != 0) {
 		return false;
@@ -196,7 +241,7 @@ static bool is_section_local_symbol(ELFOBJ *bin, Elf_(Sym) * symbol) {
 
 static bool set_elf_symbol_name(ELFOBJ *bin, struct symbols_segment *segment, RzBinElfSymbol *elf_symbol, Elf_(Sym) * symbol, RzBinElfSection *section) {
 	if (section && is_section_local_symbol(bin, symbol)) {
-		elf_symbol->name = rz_str_new(section->name);
+		elf_symbol->name = section->name;
 		return elf_symbol->name;
 	}
 
@@ -204,7 +249,7 @@ static bool set_elf_symbol_name(ELFOBJ *bin, struct symbols_segment *segment, Rz
 		return false;
 	}
 
-	elf_symbol->name = Elf_(rz_bin_elf_strtab_get_dup)(segment->strtab, symbol->st_name);
+	elf_symbol->name = Elf_(rz_bin_elf_strtab_get)(segment->strtab, symbol->st_name);
 	if (!elf_symbol->name) {
 		return false;
 	}
@@ -243,13 +288,13 @@ static bool has_already_been_processed(ELFOBJ *bin, ut64 offset, HtUU *set) {
 	return found;
 }
 
-static void elf_symbol_fini(void *e, RZ_UNUSED void *user) {
-	RzBinElfSymbol *ptr = e;
-	free(ptr->name);
-}
-
 static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector *result, struct symbols_segment *segment, RzBinElfSymbolFilter filter, HtUU *set) {
 	ut64 offset = segment->offset + segment->entry_size;
+	struct symbols_chunk chunk = { 0 };
+	chunk.data = malloc(RZ_MAX(SYMBOLS_CHUNK_SIZE, sizeof(Elf_(Sym))));
+	if (!chunk.data) {
+		return false;
+	}
 
 	for (size_t i = 1; i < segment->number; i++) {
 		if (has_already_been_processed(bin, offset, set)) {
@@ -258,11 +303,13 @@ static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector *result, struct s
 		}
 
 		if (!ht_uu_insert(set, offset, offset)) {
+			free(chunk.data);
 			return false;
 		}
 
 		Elf_(Sym) entry;
-		if (!get_symbol_entry(bin, offset, &entry)) {
+		if (!get_symbol_entry_chunked(bin, segment, &chunk, offset, &entry)) {
+			free(chunk.data);
 			return false;
 		}
 
@@ -274,17 +321,19 @@ static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector *result, struct s
 		RzBinElfSymbol symbol = { 0 };
 
 		if (!convert_elf_symbol_entry(bin, segment, &symbol, &entry, i)) {
+			free(chunk.data);
 			return false;
 		}
 
 		if (!rz_vector_push(result, &symbol)) {
-			elf_symbol_fini(&symbol, NULL);
+			free(chunk.data);
 			return false;
 		}
 
 		offset += segment->entry_size;
 	}
 
+	free(chunk.data);
 	return true;
 }
 
@@ -318,6 +367,34 @@ static bool get_dynamic_elf_symbols(ELFOBJ *bin, RzVector *result, RzBinElfSymbo
 	return true;
 }
 
+static void strtab_kv_free(HtUPKv *kv) {
+	Elf_(rz_bin_elf_strtab_free)(kv->value);
+}
+
+// The string tables stay loaded until bin is freed, since the symbol names point into them
+static RzBinElfStrtab *get_symbols_strtab(ELFOBJ *bin, ut32 link) {
+	if (!bin->symbols_strtabs) {
+		bin->symbols_strtabs = ht_up_new(NULL, strtab_kv_free, NULL);
+		if (!bin->symbols_strtabs) {
+			return NULL;
+		}
+	}
+
+	bool found;
+	RzBinElfStrtab *strtab = ht_up_find(bin->symbols_strtabs, link, &found);
+	if (found) {
+		return strtab;
+	}
+
+	RzBinElfSection *strtab_section = Elf_(rz_bin_elf_get_section)(bin, link);
+	if (strtab_section) {
+		strtab = Elf_(rz_bin_elf_strtab_new)(bin, strtab_section->offset, strtab_section->size);
+	}
+
+	ht_up_insert(bin->symbols_strtabs, link, strtab);
+	return strtab;
+}
+
 static bool get_section_elf_symbols(ELFOBJ *bin, RzVector *result, RzBinElfSymbolFilter filter, HtUU *set) {
 	size_t i;
 	RzBinElfSection *section;
@@ -335,12 +412,7 @@ static bool get_section_elf_symbols(ELFOBJ *bin, RzVector *result, RzBinElfSymbo
 			continue;
 		}
 
-		RzBinElfSection *strtab_section = Elf_(rz_bin_elf_get_section)(bin, section->link);
-		if (!strtab_section) {
-			continue;
-		}
-
-		RzBinElfStrtab *strtab = Elf_(rz_bin_elf_strtab_new)(bin, strtab_section->offset, strtab_section->size);
+		RzBinElfStrtab *strtab = get_symbols_strtab(bin, section->link);
 		if (!strtab) {
 			continue;
 		}
@@ -350,11 +422,8 @@ static bool get_section_elf_symbols(ELFOBJ *bin, RzVector *result, RzBinElfSymbo
 		struct symbols_segment segment = symbols_segment_init(section->offset, number, sizeof(Elf_(Sym)), false, strtab);
 
 		if (!compute_symbols_from_segment(bin, result, &segment, filter, set)) {
-			Elf_(rz_bin_elf_strtab_free)(strtab);
 			return false;
 		}
-
-		Elf_(rz_bin_elf_strtab_free)(strtab);
 	}
 
 	return true;
@@ -394,21 +463,44 @@ Elf_(Word) Elf_(rz_bin_elf_get_number_of_dynamic_symbols)(RZ_NONNULL ELFOBJ *bin
 	return 0;
 }
 
+/**
+ * \brief Index the symbols of \p symbols by ordinal, the first one wins when several share it
+ */
+RZ_OWN HtUP *Elf_(rz_bin_elf_symbols_index_new)(RZ_NONNULL RzVector *symbols) {
+	rz_return_val_if_fail(symbols, NULL);
+
+	HtUP *result = ht_up_new0();
+	if (!result) {
+		return NULL;
+	}
+
+	RzBinElfSymbol *symbol;
+	rz_vector_foreach(symbols, symbol) {
+		ht_up_insert(result, symbol->ordinal, symbol);
+	}
+
+	return result;
+}
+
 RZ_BORROW RzBinElfSymbol *Elf_(rz_bin_elf_get_symbol)(RZ_NONNULL ELFOBJ *bin, ut32 ordinal) {
 	rz_return_val_if_fail(bin, NULL);
 
-	RzBinElfSymbol *symbol;
-	rz_bin_elf_foreach_symbols(bin, symbol) {
-		if (symbol->ordinal == ordinal) {
-			return symbol;
+	if (!Elf_(rz_bin_elf_has_symbols)(bin)) {
+		return NULL;
+	}
+
+	if (!bin->symbols_by_ordinal) {
+		bin->symbols_by_ordinal = Elf_(rz_bin_elf_symbols_index_new)(bin->symbols);
+		if (!bin->symbols_by_ordinal) {
+			return NULL;
 		}
 	}
 
-	return NULL;
+	return ht_up_find(bin->symbols_by_ordinal, ordinal, NULL);
 }
 
 RZ_OWN RzVector *Elf_(rz_bin_elf_compute_symbols)(ELFOBJ *bin, RzBinElfSymbolFilter filter) {
-	RzVector *result = rz_vector_new(sizeof(RzBinElfSymbol), elf_symbol_fini, NULL);
+	RzVector *result = rz_vector_new(sizeof(RzBinElfSymbol), NULL, NULL);
 	if (!result) {
 		return NULL;
 	}
@@ -255,6 +255,7 @@ RZ_API RzConfigNode *rz_config_set_b(RzConfig *cfg, const char *name, bool value
 	}
 
 beach:
+	cfg->generation++;
 	free(ov);
 	return node;
 }
@@ -345,10 +346,12 @@ RZ_API RzConfigNode *rz_config_set(RzConfig *cfg, const char *name, const char *
 			free(node->value);
 			node->value = strdup(ov ? ov : "");
 			free(ov);
+			cfg->generation++;
 			return NULL;
 		}
 	}
 beach:
+	cfg->generation++;
 	free(ov);
 	return node;
 }
@@ -375,6 +378,7 @@ RZ_API bool rz_config_rm(RzConfig *cfg, const char *name) {
 	if (node) {
 		ht_pp_delete(cfg->ht, node->name);
 		rz_list_delete_data(cfg->nodes, node);
+		cfg->generation++;
 		return true;
 	}
 	return false;
@@ -445,6 +449,7 @@ RZ_API RzConfigNode *rz_config_set_i(RzConfig *cfg, const char *name, const ut64
 		}
 	}
 beach:
+	cfg->generation++;
 	free(ov);
 	return node;
 }
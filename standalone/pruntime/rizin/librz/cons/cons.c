@@ -10,6 +10,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include "cons_private.h"
 
 #define COUNT_LINES 1
 #define CTX(x)      I.context->x
@@ -127,6 +128,10 @@ static void cons_context_init(RzConsContext *context, RZ_NULLABLE RzConsContext
 }
 
 static void cons_context_deinit(RzConsContext *context) {
+	if (context->grep_stream) {
+		free(context->grep_stream->grep.str);
+		RZ_FREE(context->grep_stream);
+	}
 	rz_stack_free(context->cons_stack);
 	context->cons_stack = NULL;
 	rz_stack_free(context->break_stack);
@@ -800,6 +805,10 @@ RZ_API int rz_cons_get_buffer_len(void) {
 
 RZ_API void rz_cons_filter(void) {
 	/* grep */
+	if (I.context->grep_stream) {
+		// flushed while the grepped command is still printing
+		rz_cons_grep_stream_update(true);
+	}
 	if (I.filter || I.context->grep.nstrings > 0 || I.context->grep.tokens_used || I.context->grep.less || I.context->grep.json) {
 		(void)rz_cons_grepbuf();
 		I.filter = false;
@@ -897,7 +906,7 @@ RZ_API void rz_cons_last(void) {
 }
 
 static bool lastMatters(void) {
-	return (I.context->buffer_len > 0) && (CTX(lastEnabled) && !I.filter && I.context->grep.nstrings < 1 && !I.context->grep.tokens_used && !I.context->grep.less && !I.context->grep.json && !I.is_html);
+	return (I.context->buffer_len > 0) && (CTX(lastEnabled) && !I.filter && I.context->grep.nstrings < 1 && !I.context->grep.tokens_used && !I.context->grep.less && !I.context->grep.json && !I.context->grep_stream && !I.is_html);
 }
 
 RZ_API void rz_cons_echo(const char *msg) {
@@ -941,6 +950,9 @@ RZ_API void rz_cons_flush(void) {
 		CTX(lastMode) = false;
 	}
 	rz_cons_filter();
+	// the line a grepped command is still printing is written once complete and filtered
+	size_t held_len;
+	char *held = rz_cons_grep_stream_hold(&held_len);
 	if (rz_cons_is_interactive() && I.fdout == 1) {
 		/* Use a pager if the output doesn't fit on the terminal window. */
 		if (CTX(pageable) && CTX(buffer) && I.pager && *I.pager && CTX(buffer_len) > 0 && rz_str_char_count(CTX(buffer), '\n') >= I.rows) {
@@ -949,9 +961,8 @@ RZ_API void rz_cons_flush(void) {
 				char *str = rz_str_ndup(CTX(buffer), CTX(buffer_len));
 				CTX(pageable) = false;
 				rz_cons_less_str(str, NULL);
-				rz_cons_reset();
 				free(str);
-				return;
+				goto beach;
 			} else {
 				rz_sys_cmd_str_full(I.pager, CTX(buffer), NULL, NULL, NULL);
 				rz_cons_reset();
@@ -965,15 +976,13 @@ RZ_API void rz_cons_flush(void) {
 				}
 			}
 			if (lines > 0 && !rz_cons_yesno('n', "Do you want to print %d lines? (y/N)", lines)) {
-				rz_cons_reset();
-				return;
+				goto beach;
 			}
 #else
 			char buf[8];
 			rz_num_units(buf, sizeof(buf), I.context->buffer_len);
 			if (!rz_cons_yesno('n', "Do you want to print %s chars? (y/N)", buf)) {
-				rz_cons_reset();
-				return;
+				goto beach;
 			}
 #endif
 			// fix | more | less problem
@@ -1021,7 +1030,9 @@ RZ_API void rz_cons_flush(void) {
 		__cons_write(I.context->buffer, I.context->buffer_len);
 	}
 
+beach:
 	rz_cons_reset();
+	rz_cons_grep_stream_restore(held, held_len);
 	if (I.newline) {
 		eprintf("\n");
 		I.newline = false;
@@ -1189,6 +1200,9 @@ RZ_API void rz_cons_printf_list(const char *format, va_list ap) {
 				}
 			}
 			I.context->buffer_len += written;
+			if (I.context->grep_stream) {
+				rz_cons_grep_stream_update(false);
+			}
 		}
 	} else {
 		rz_cons_strcat(format);
@@ -1235,6 +1249,9 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 			memcpy(I.context->buffer + I.context->buffer_len, str, len);
 			I.context->buffer_len += len;
 			I.context->buffer[I.context->buffer_len] = 0;
+			if (I.context->grep_stream) {
+				rz_cons_grep_stream_update(false);
+			}
 		}
 	}
 	if (I.flush) {
@@ -0,0 +1,11 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef CONS_PRIVATE_H
+#define CONS_PRIVATE_H
+
+RZ_IPI void rz_cons_grep_stream_update(bool force);
+RZ_IPI char *rz_cons_grep_stream_hold(size_t *len);
+RZ_IPI void rz_cons_grep_stream_restore(RZ_OWN char *held, size_t len);
+
+#endif
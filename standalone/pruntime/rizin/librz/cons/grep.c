@@ -4,7 +4,9 @@
 
 #include <rz_cons.h>
 #include <rz_util/rz_print.h>
+#include <rz_util/rz_json.h>
 #include <sdb.h>
+#include "cons_private.h"
 
 #define I(x) rz_cons_singleton()->x
 
@@ -73,7 +75,7 @@ RZ_API void rz_cons_grep_help(void) {
 
 #define RZ_CONS_GREP_BUFSIZE 4096
 
-static void parse_grep_expression(const char *str) {
+static void parse_grep_expression(RzConsGrep *grep, const char *str) {
 	static char buf[RZ_CONS_GREP_BUFSIZE];
 	int wlen, len, is_range, num_is_parsed, fail = 0;
 	char *ptr, *optr, *ptr2, *ptr3, *end_ptr = NULL, last;
@@ -83,7 +85,6 @@ static void parse_grep_expression(const char *str) {
 		return;
 	}
 	RzCons *cons = rz_cons_singleton();
-	RzConsGrep *grep = &cons->context->grep;
 	sorted_column = 0;
 	bool first = true;
 	while (*str) {
@@ -403,7 +404,7 @@ RZ_API void rz_cons_grep_parsecmd(char *cmd, const char *quotestr) {
 	char *ptr = preprocess_filter_expr(cmd, quotestr);
 	if (ptr) {
 		rz_str_trim(cmd);
-		parse_grep_expression(ptr);
+		parse_grep_expression(&I(context)->grep, ptr);
 		free(ptr);
 	}
 }
@@ -420,7 +421,7 @@ RZ_API char *rz_cons_grep_strip(char *cmd, const char *quotestr) {
 
 RZ_API void rz_cons_grep_process(char *grep) {
 	if (grep) {
-		parse_grep_expression(grep);
+		parse_grep_expression(&I(context)->grep, grep);
 		free(grep);
 	}
 }
@@ -498,7 +499,11 @@ RZ_API void rz_cons_grepbuf(void) {
 	}
 	if (grep->json) {
 		if (grep->json_path) {
-			char *u = sdb_json_get_str(cons->context->buffer, grep->json_path);
+			char *u = rz_json_path_get(cons->context->buffer, grep->json_path);
+			if (!u) {
+				// sdb is more lenient with paths not matching the document
+				u = sdb_json_get_str(cons->context->buffer, grep->json_path);
+			}
 			if (u) {
 				cons->context->buffer = u;
 				cons->context->buffer_len = strlen(u);
@@ -721,9 +726,7 @@ RZ_API void rz_cons_grepbuf(void) {
 	}
 }
 
-RZ_API int rz_cons_grep_line(char *buf, int len) {
-	RzCons *cons = rz_cons_singleton();
-	RzConsGrep *grep = &cons->context->grep;
+static int grep_line(RzConsGrep *grep, int lines, char *buf, int len) {
 	const char *delims = " |,;=\t";
 	char *tok = NULL;
 	bool hit = grep->neg;
@@ -782,11 +785,11 @@ RZ_API int rz_cons_grep_line(char *buf, int len) {
 
 	if (hit) {
 		if (!grep->range_line) {
-			if (grep->line == cons->lines) {
+			if (grep->line == lines) {
 				use_tok = true;
 			}
 		} else if (grep->range_line == 1) {
-			use_tok = RZ_BETWEEN(grep->f_line, cons->lines, grep->l_line);
+			use_tok = RZ_BETWEEN(grep->f_line, lines, grep->l_line);
 		} else {
 			use_tok = true;
 		}
@@ -838,7 +841,7 @@ RZ_API int rz_cons_grep_line(char *buf, int len) {
 		if (!unsorted_lines) {
 			unsorted_lines = rz_list_newf(free);
 		}
-		if (cons->lines >= grep->sort_row) {
+		if (lines >= grep->sort_row) {
 			rz_list_append(sorted_lines, strdup(buf));
 		} else {
 			rz_list_append(unsorted_lines, strdup(buf));
@@ -849,7 +852,251 @@ RZ_API int rz_cons_grep_line(char *buf, int len) {
 	return len;
 }
 
+RZ_API int rz_cons_grep_line(char *buf, int len) {
+	RzCons *cons = rz_cons_singleton();
+	return grep_line(&cons->context->grep, cons->lines, buf, len);
+}
+
+/* Greps that only look at one line at a time can run while the output is printed */
+static bool grep_streamable(RzConsGrep *grep) {
+	RzCons *cons = rz_cons_singleton();
+	return (grep->nstrings > 0 || grep->tokens_used) && grep->range_line == 2 && grep->sort == -1 &&
+		!grep->counter && !grep->less && !grep->hud && !grep->json && !grep->zoom &&
+		!cons->filter && !cons->flush && !cons->grep_highlight;
+}
+
+#define SWAR_ONES  0x0101010101010101ULL
+#define SWAR_HIGHS 0x8080808080808080ULL
+
+/*
+ * Find \p w in \p s comparing the first and last byte of the word at 8
+ * positions at once, as a portable take on the SSE2 substring search.
+ */
+static const char *find_word(const char *s, size_t len, const char *w, size_t wlen) {
+	if (wlen > len) {
+		return NULL;
+	}
+	const ut64 first = SWAR_ONES * (ut8)w[0];
+	const ut64 last = SWAR_ONES * (ut8)w[wlen - 1];
+	size_t i, end = len - wlen + 1;
+	for (i = 0; i + 8 <= end; i += 8) {
+		ut64 a, b;
+		memcpy(&a, s + i, sizeof(a));
+		memcpy(&b, s + i + wlen - 1, sizeof(b));
+		ut64 x = (a ^ first) | (b ^ last);
+		if (!((x - SWAR_ONES) & ~x & SWAR_HIGHS)) {
+			continue;
+		}
+		size_t j;
+		for (j = i; j < i + 8; j++) {
+			if (!memcmp(s + j, w, wlen)) {
+				return s + j;
+			}
+		}
+	}
+	for (; i < end; i++) {
+		if (!memcmp(s + i, w, wlen)) {
+			return s + i;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Filter the complete lines of buf in place, the same way rz_cons_grepbuf()
+ * does, and return the length of what is left. A trailing line without a
+ * newline is dropped.
+ */
+static size_t grep_stream_lines(RzConsGrepStream *gs, char *buf, size_t len) {
+	RzCons *cons = rz_cons_singleton();
+	RzConsGrep *grep = &gs->grep;
+	const char *word = NULL;
+	size_t wlen = 0;
+	// lines without the word can be skipped unless escape codes could be hiding it
+	if (grep->nstrings == 1 && !grep->neg && !grep->icase && *grep->strings[0] && !memchr(buf, 0x1b, len)) {
+		word = grep->strings[0];
+		wlen = strlen(word);
+	}
+	char *in = buf, *end = buf + len, *out = buf;
+	while (in < end) {
+		if (word) {
+			char *hit = (char *)find_word(in, end - in, word, wlen);
+			if (!hit) {
+				break;
+			}
+			while (hit > in && hit[-1] != '\n') {
+				hit--;
+			}
+			in = hit;
+		}
+		char *p = memchr(in, '\n', end - in);
+		if (!p) {
+			break;
+		}
+		int l = p - in;
+		if (l > 0) {
+			char *tline = rz_str_ndup(in, l);
+			if (!tline) {
+				break;
+			}
+			int tl = cons->grep_color ? l : rz_str_ansi_filter(tline, NULL, NULL, l);
+			int ret = tl < 0 ? -1 : grep_line(grep, gs->lines, tline, tl);
+			if (ret > 0) {
+				memcpy(out, tline, ret);
+				out[ret] = '\n';
+				out += ret + 1;
+				gs->lines++;
+			}
+			free(tline);
+		}
+		in = p + 1;
+	}
+	return out - buf;
+}
+
+static void grep_stream_update(RzConsContext *ctx, RzConsGrepStream *gs, bool force, bool last) {
+	if (rz_stack_size(ctx->cons_stack) != gs->depth) {
+		// the output of a nested command
+		return;
+	}
+	if (ctx->buffer_len < gs->pos) {
+		// the buffer was flushed or reset meanwhile
+		gs->pos = ctx->buffer_len;
+		gs->next = gs->pos + RZ_CONS_GREP_STREAM;
+	}
+	if ((!force && ctx->buffer_len < gs->next) || !ctx->buffer) {
+		return;
+	}
+	char *chunk = ctx->buffer + gs->pos;
+	size_t len = ctx->buffer_len - gs->pos;
+	if (!last) {
+		// the last line may not be complete yet
+		while (len > 0 && chunk[len - 1] != '\n') {
+			len--;
+		}
+	}
+	size_t rest = ctx->buffer_len - gs->pos - len;
+	size_t kept = grep_stream_lines(gs, chunk, len);
+	if (last) {
+		rest = 0;
+	}
+	memmove(chunk + kept, chunk + len, rest);
+	ctx->buffer_len = gs->pos + kept + rest;
+	ctx->buffer[ctx->buffer_len] = 0;
+	gs->pos += kept;
+	gs->next = ctx->buffer_len + RZ_CONS_GREP_STREAM;
+}
+
+/**
+ * \brief Filter the output lines printed so far by the streaming grep
+ * \param force filter even if less than RZ_CONS_GREP_STREAM bytes were printed
+ */
+RZ_IPI void rz_cons_grep_stream_update(bool force) {
+	RzConsContext *ctx = I(context);
+	if (ctx->grep_stream) {
+		grep_stream_update(ctx, ctx->grep_stream, force, false);
+	}
+}
+
+/**
+ * \brief Take the line the grepped command is still printing out of the output
+ *
+ * Once rz_cons_filter() filtered the complete lines, only the last one, not
+ * filtered yet, is left past the filtered output. rz_cons_flush() writes the
+ * output without it and puts it back with rz_cons_grep_stream_restore(), so
+ * that it is filtered once complete, like rz_cons_grepbuf() would.
+ *
+ * \param len set to the length of the line
+ * \return the line, or NULL if there is none
+ */
+RZ_IPI char *rz_cons_grep_stream_hold(size_t *len) {
+	RzConsContext *ctx = I(context);
+	RzConsGrepStream *gs = ctx->grep_stream;
+	*len = 0;
+	if (!gs || rz_stack_size(ctx->cons_stack) != gs->depth || !ctx->buffer || ctx->buffer_len <= gs->pos) {
+		return NULL;
+	}
+	char *held = rz_mem_dup(ctx->buffer + gs->pos, ctx->buffer_len - gs->pos);
+	if (!held) {
+		return NULL;
+	}
+	*len = ctx->buffer_len - gs->pos;
+	ctx->buffer_len = gs->pos;
+	ctx->buffer[ctx->buffer_len] = 0;
+	return held;
+}
+
+/**
+ * \brief Put back the line taken by rz_cons_grep_stream_hold() once the output was flushed
+ */
+RZ_IPI void rz_cons_grep_stream_restore(RZ_OWN char *held, size_t len) {
+	RzConsContext *ctx = I(context);
+	RzConsGrepStream *gs = ctx->grep_stream;
+	if (!held) {
+		return;
+	}
+	if (gs) {
+		gs->pos = ctx->buffer_len;
+		gs->next = gs->pos + RZ_CONS_GREP_STREAM;
+	}
+	rz_cons_memcat(held, len);
+	free(held);
+}
+
+/**
+ * \brief Grep the output of the next command while it is printed
+ *
+ * The lines are filtered every RZ_CONS_GREP_STREAM bytes of output, so the
+ * unfiltered output is never kept as a whole. Only the expressions that look
+ * at one line at a time can be streamed, the others (sorting, counting, line
+ * ranges, json, ...) need rz_cons_grep_process() once the command is done.
+ *
+ * \param grep the grep expression, as given to rz_cons_grep_process()
+ * \return true if the expression is streamed, false if it was left alone
+ */
+RZ_API bool rz_cons_grep_stream_begin(const char *grep) {
+	RzConsContext *ctx = I(context);
+	// '?' may print the help or count the lines
+	if (!grep || strchr(grep, '?') || ctx->grep_stream || !ctx->cons_stack) {
+		return false;
+	}
+	RzConsGrepStream *gs = RZ_NEW0(RzConsGrepStream);
+	if (!gs) {
+		return false;
+	}
+	gs->grep.line = -1;
+	gs->grep.sort = -1;
+	parse_grep_expression(&gs->grep, grep);
+	if (!grep_streamable(&gs->grep)) {
+		free(gs->grep.str);
+		free(gs->grep.json_path);
+		free(gs);
+		return false;
+	}
+	gs->pos = ctx->buffer_len;
+	gs->next = gs->pos + RZ_CONS_GREP_STREAM;
+	gs->depth = rz_stack_size(ctx->cons_stack);
+	ctx->grep_stream = gs;
+	return true;
+}
+
+/**
+ * \brief Filter what is left of the output of the command and stop streaming
+ */
+RZ_API void rz_cons_grep_stream_end(void) {
+	RzConsContext *ctx = I(context);
+	RzConsGrepStream *gs = ctx->grep_stream;
+	if (!gs) {
+		return;
+	}
+	grep_stream_update(ctx, gs, true, true);
+	I(lines) = gs->lines;
+	ctx->grep_stream = NULL;
+	free(gs->grep.str);
+	free(gs);
+}
+
 RZ_API void rz_cons_grep(const char *grep) {
-	parse_grep_expression(grep);
+	parse_grep_expression(&I(context)->grep, grep);
 	rz_cons_grepbuf();
 }
@@ -0,0 +1,661 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/*
+ * On-disk cache of analyzed functions.
+ *
+ * While aa/aaa/aaaa run with analysis.cache.dir set, every function that is
+ * about to be analyzed is first looked up in <dir>/functions.sdb. Entries are
+ * keyed by the sha256 of the bytes of the function's blocks, of the
+ * relocations patched into them, of its bits, of the analysis level and of
+ * every option that can change the outcome of the analysis. So a function is
+ * reused as long as its code is byte-identical, even if the rest of the
+ * binary changed or the function moved.
+ *
+ * An entry records the blocks, the xrefs and the variables of the function.
+ * Offsets are kept relative to the entrypoint. The targets of blocks and
+ * xrefs are stored as they were and translated on a hit by decoding the
+ * instruction they come from, which tells pc-relative targets (that move with
+ * the function) from absolute ones (that don't).
+ *
+ * Entries are found through an index of the first bytes of the function:
+ *
+ *   p.<len>.<xxhash of the first len bytes> = <digest>,<digest>,...
+ *   f.<digest> = {"addr":..,"bbs":[..],"xrefs":[..],"vars":[..],...}
+ */
+
+#include <rz_core.h>
+#include <rz_msg_digest.h>
+
+#define CACHE_VERSION     1
+#define CACHE_READ_SIZE   0x10000
+#define CACHE_PREFIX_SIZE 0x10
+#define CACHE_BLOCK_MAX   0x100000
+
+/// a block of a cached function, relative to the entrypoint
+typedef struct {
+	ut64 off;
+	ut64 size;
+} CacheRange;
+
+static bool is_cache_relevant_option(const char *name) {
+	if (!strcmp(name, "analysis.cache.dir")) {
+		return false;
+	}
+	return rz_str_startswith(name, "analysis.") || rz_str_startswith(name, "asm.") || rz_str_startswith(name, "bin.") || rz_str_startswith(name, "esil.");
+}
+
+static char *file_digest(RzCore *core) {
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	if (!bf || !bf->buf) {
+		return NULL;
+	}
+	RzMsgDigest *md = rz_msg_digest_new_with_algo2("sha256");
+	if (!md) {
+		return NULL;
+	}
+	ut8 *buf = malloc(CACHE_READ_SIZE);
+	if (!buf) {
+		rz_msg_digest_free(md);
+		return NULL;
+	}
+	char *r = NULL;
+	ut64 size = rz_buf_size(bf->buf);
+	ut64 off = 0;
+	rz_msg_digest_init(md);
+	while (off < size) {
+		st64 len = rz_buf_read_at(bf->buf, off, buf, RZ_MIN(CACHE_READ_SIZE, size - off));
+		if (len <= 0) {
+			goto beach;
+		}
+		rz_msg_digest_update(md, buf, len);
+		off += len;
+	}
+	rz_msg_digest_final(md);
+	r = rz_msg_digest_get_result_string(md, "sha256", NULL, false);
+beach:
+	free(buf);
+	rz_msg_digest_free(md);
+	return r;
+}
+
+static ut32 config_digest(RzCore *core, const char *level) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_strbuf_appendf(&sb, "%s\n", level);
+	RzListIter *it;
+	RzConfigNode *node;
+	rz_list_foreach (core->config->nodes, it, node) {
+		if (is_cache_relevant_option(node->name)) {
+			rz_strbuf_appendf(&sb, "%s=%s\n", node->name, node->value);
+		}
+	}
+	ut32 r = rz_hash_xxhash((const ut8 *)rz_strbuf_get(&sb), rz_strbuf_length(&sb));
+	rz_strbuf_fini(&sb);
+	return r;
+}
+
+static void digest_str(RzMsgDigest *md, const char *s) {
+	rz_msg_digest_update(md, (const ut8 *)s, strlen(s) + 1);
+}
+
+/*
+ * Hash the code of a function starting at addr and made of blocks, together
+ * with the relocations applied to it and the options it was analyzed with.
+ */
+static char *function_digest(RzCore *core, ut64 addr, int bits, RzVector /*<CacheRange>*/ *blocks) {
+	RzMsgDigest *md = rz_msg_digest_new_with_algo2("sha256");
+	if (!md) {
+		return NULL;
+	}
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	RzBinRelocStorage *relocs = bf && bf->o ? bf->o->relocs : NULL;
+	char *r = NULL;
+	ut8 *buf = NULL;
+	rz_msg_digest_init(md);
+	char *ctx = rz_str_newf("%08x:%s:%s:%d", core->analysis_cache.config, rz_config_get(core->config, "asm.arch"),
+		rz_config_get(core->config, "asm.cpu"), bits);
+	if (!ctx) {
+		goto beach;
+	}
+	digest_str(md, ctx);
+	free(ctx);
+	CacheRange *range;
+	rz_vector_foreach(blocks, range) {
+		if (!range->size || range->size > CACHE_BLOCK_MAX) {
+			goto beach;
+		}
+		ut8 *tmp = realloc(buf, range->size);
+		if (!tmp) {
+			goto beach;
+		}
+		buf = tmp;
+		ut64 at = addr + range->off;
+		ut64 end = at + range->size;
+		if (!rz_io_read_at(core->io, at, buf, range->size)) {
+			goto beach;
+		}
+		rz_msg_digest_update(md, (const ut8 *)range, sizeof(*range));
+		rz_msg_digest_update(md, buf, range->size);
+		while (relocs && at < end) {
+			RzBinReloc *reloc = rz_bin_reloc_storage_get_reloc_in(relocs, at, end - at);
+			if (!reloc) {
+				break;
+			}
+			const char *name = "";
+			if (reloc->import) {
+				name = reloc->import->name;
+			} else if (reloc->symbol) {
+				name = reloc->symbol->name;
+			}
+			char *s = rz_str_newf("%" PFMT64x ":%d:%" PFMT64d ":%s", reloc->vaddr - addr, reloc->type, reloc->addend, name);
+			if (!s) {
+				goto beach;
+			}
+			digest_str(md, s);
+			free(s);
+			at = reloc->vaddr + 1;
+		}
+	}
+	rz_msg_digest_final(md);
+	r = rz_msg_digest_get_result_string(md, "sha256", NULL, false);
+beach:
+	free(buf);
+	rz_msg_digest_free(md);
+	return r;
+}
+
+static char *prefix_key(const ut8 *buf, int len) {
+	return rz_str_newf("p.%d.%08x", len, rz_hash_xxhash(buf, len));
+}
+
+static ut64 json_num(const RzJson *json, const char *key, ut64 def) {
+	const RzJson *v = rz_json_get(json, key);
+	return v && (v->type == RZ_JSON_INTEGER || v->type == RZ_JSON_BOOLEAN) ? v->num.u_value : def;
+}
+
+static bool is_in_ranges(RzVector /*<CacheRange>*/ *blocks, ut64 off) {
+	CacheRange *range;
+	rz_vector_foreach(blocks, range) {
+		if (off >= range->off && off - range->off < range->size) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Translate target, recorded for an instruction that moved by delta to site.
+ * The instruction is decoded to see whether it still encodes the target
+ * moved along with it (pc-relative) or unchanged (absolute). Targets that
+ * cannot be told apart fall back to moving with the function when they
+ * point inside it.
+ */
+static bool rebase_target(RzCore *core, ut64 site, ut64 target, st64 delta, bool inside, ut64 *out) {
+	if (!delta || target == UT64_MAX) {
+		*out = target;
+		return true;
+	}
+	ut64 moved = target + delta;
+	bool is_moved = false;
+	bool is_fixed = false;
+	RzAnalysisOp *op = rz_core_op_analysis(core, site, RZ_ANALYSIS_OP_MASK_VAL);
+	if (op) {
+		ut64 values[] = { op->jump, op->fail, op->ptr, op->val, op->addr + op->size };
+		size_t i;
+		for (i = 0; i < RZ_ARRAY_SIZE(values); i++) {
+			is_moved |= values[i] == moved;
+			is_fixed |= values[i] == target;
+		}
+		rz_analysis_op_free(op);
+	}
+	if (is_moved || (!is_fixed && inside)) {
+		*out = moved;
+		return true;
+	}
+	if (is_fixed) {
+		*out = target;
+		return true;
+	}
+	return false;
+}
+
+static bool intersect_cb(RzAnalysisBlock *block, void *user) {
+	*(bool *)user = true;
+	return false;
+}
+
+typedef struct {
+	ut64 jump;
+	ut64 fail;
+} CacheJumps;
+
+/*
+ * Rebuild fcn from the entry json if the code at fcn->addr hashes to digest.
+ * Nothing is changed in the analysis unless the whole entry applies.
+ */
+static bool function_restore(RzCore *core, RzAnalysisFunction *fcn, int reftype, const char *digest, const RzJson *json) {
+	RzAnalysis *analysis = core->analysis;
+	const RzJson *bbs = rz_json_get(json, "bbs");
+	const RzJson *xrefs = rz_json_get(json, "xrefs");
+	const RzJson *vars = rz_json_get(json, "vars");
+	if (!bbs || bbs->type != RZ_JSON_ARRAY || !bbs->children.count) {
+		return false;
+	}
+	bool r = false;
+	char *hash = NULL;
+	st64 delta = fcn->addr - json_num(json, "addr", fcn->addr);
+	RzVector ranges;
+	RzVector jumps;
+	RzVector refs;
+	rz_vector_init(&ranges, sizeof(CacheRange), NULL, NULL);
+	rz_vector_init(&jumps, sizeof(CacheJumps), NULL, NULL);
+	rz_vector_init(&refs, sizeof(RzAnalysisXRef), NULL, NULL);
+	const RzJson *bb;
+	for (bb = bbs->children.first; bb; bb = bb->next) {
+		CacheRange *range = rz_vector_push(&ranges, NULL);
+		if (!range) {
+			goto beach;
+		}
+		range->off = json_num(bb, "off", 0);
+		range->size = json_num(bb, "size", 0);
+	}
+	hash = function_digest(core, fcn->addr, fcn->bits, &ranges);
+	if (!hash || strcmp(hash, digest)) {
+		goto beach;
+	}
+	// blocks found since the entry was stored take precedence
+	CacheRange *range;
+	rz_vector_foreach(&ranges, range) {
+		bool intersects = false;
+		rz_analysis_blocks_foreach_intersect(analysis, fcn->addr + range->off, range->size, intersect_cb, &intersects);
+		if (intersects) {
+			goto beach;
+		}
+	}
+	size_t i = 0;
+	for (bb = bbs->children.first; bb; bb = bb->next, i++) {
+		range = rz_vector_index_ptr(&ranges, i);
+		ut64 addr = fcn->addr + range->off;
+		const RzJson *op_pos = rz_json_get(bb, "op_pos");
+		const RzJson *last = op_pos && op_pos->type == RZ_JSON_ARRAY ? op_pos->children.last : NULL;
+		ut64 site = addr + (last && last->type == RZ_JSON_INTEGER ? last->num.u_value : 0);
+		ut64 jump = json_num(bb, "jump", UT64_MAX);
+		ut64 fail = json_num(bb, "fail", UT64_MAX);
+		CacheJumps *j = rz_vector_push(&jumps, NULL);
+		if (!j ||
+			!rebase_target(core, site, jump, delta, jump != UT64_MAX && is_in_ranges(&ranges, jump + delta - fcn->addr), &j->jump) ||
+			!rebase_target(core, site, fail, delta, fail != UT64_MAX && is_in_ranges(&ranges, fail + delta - fcn->addr), &j->fail)) {
+			goto beach;
+		}
+	}
+	const RzJson *x;
+	for (x = xrefs && xrefs->type == RZ_JSON_ARRAY ? xrefs->children.first : NULL; x; x = x->next) {
+		RzAnalysisXRef *ref = rz_vector_push(&refs, NULL);
+		if (!ref) {
+			goto beach;
+		}
+		ut64 to = json_num(x, "to", UT64_MAX);
+		ref->from = fcn->addr + json_num(x, "from", 0);
+		ref->type = json_num(x, "type", RZ_ANALYSIS_REF_TYPE_NULL);
+		if (!rebase_target(core, ref->from, to, delta, is_in_ranges(&ranges, to + delta - fcn->addr), &ref->to)) {
+			goto beach;
+		}
+		// a callee that became noreturn would have ended the block at the call
+		if (ref->type == RZ_ANALYSIS_REF_TYPE_CALL && !json_num(x, "noreturn", false) && rz_analysis_noreturn_at(analysis, ref->to)) {
+			goto beach;
+		}
+	}
+
+	fcn->type = (reftype == RZ_ANALYSIS_REF_TYPE_CODE) ? RZ_ANALYSIS_FCN_TYPE_LOC : RZ_ANALYSIS_FCN_TYPE_FCN;
+	fcn->stack = json_num(json, "stack", 0);
+	fcn->maxstack = json_num(json, "maxstack", 0);
+	fcn->ninstr = json_num(json, "ninstr", 0);
+	fcn->bp_frame = json_num(json, "bp_frame", false);
+	fcn->bp_off = json_num(json, "bp_off", 0);
+	fcn->is_pure = json_num(json, "pure", false);
+	i = 0;
+	for (bb = bbs->children.first; bb; bb = bb->next, i++) {
+		range = rz_vector_index_ptr(&ranges, i);
+		CacheJumps *j = rz_vector_index_ptr(&jumps, i);
+		RzAnalysisBlock *block = rz_analysis_create_block(analysis, fcn->addr + range->off, range->size);
+		if (!block) {
+			continue;
+		}
+		block->jump = j->jump;
+		block->fail = j->fail;
+		block->ninstr = json_num(bb, "ninstr", 1);
+		block->stackptr = json_num(bb, "stackptr", 0);
+		block->parent_stackptr = json_num(bb, "parent_stackptr", INT_MAX);
+		const RzJson *op_pos = rz_json_get(bb, "op_pos");
+		const RzJson *pos;
+		size_t k = 1;
+		for (pos = op_pos && op_pos->type == RZ_JSON_ARRAY ? op_pos->children.first : NULL; pos; pos = pos->next, k++) {
+			rz_analysis_block_set_op_offset(block, k, (ut16)pos->num.u_value);
+		}
+		rz_analysis_function_add_block(fcn, block);
+		rz_analysis_block_unref(block);
+	}
+	RzAnalysisXRef *ref;
+	rz_vector_foreach(&refs, ref) {
+		rz_analysis_xrefs_set(analysis, ref->from, ref->to, ref->type);
+	}
+	if (vars && vars->type == RZ_JSON_ARRAY) {
+		RzSerializeAnalVarParser parser = rz_serialize_analysis_var_parser_new();
+		if (parser) {
+			const RzJson *var;
+			for (var = vars->children.first; var; var = var->next) {
+				rz_serialize_analysis_var_load(fcn, parser, var);
+			}
+			rz_serialize_analysis_var_parser_free(parser);
+		}
+	}
+	r = true;
+beach:
+	free(hash);
+	rz_vector_fini(&ranges);
+	rz_vector_fini(&jumps);
+	rz_vector_fini(&refs);
+	return r;
+}
+
+/**
+ * \brief Get the path of the cache file \p name in analysis.cache.dir
+ *
+ * \return the path, or NULL if caching is disabled
+ */
+RZ_API RZ_OWN char *rz_core_analysis_cache_path(RzCore *core, const char *name) {
+	rz_return_val_if_fail(core && name, NULL);
+	const char *dir = rz_config_get(core->config, "analysis.cache.dir");
+	if (RZ_STR_ISEMPTY(dir)) {
+		return NULL;
+	}
+	char *path = rz_file_abspath(dir);
+	if (!path) {
+		return NULL;
+	}
+	char *r = rz_str_newf("%s" RZ_SYS_DIR "%s.sdb", path, name);
+	free(path);
+	return r;
+}
+
+/**
+ * \brief Compute a key identifying the current file and the arch it is disassembled with
+ *
+ * \return the key, or NULL if there is no file loaded
+ */
+RZ_API RZ_OWN char *rz_core_analysis_cache_key(RzCore *core) {
+	rz_return_val_if_fail(core, NULL);
+	char *digest = file_digest(core);
+	if (!digest) {
+		return NULL;
+	}
+	char *arch = rz_str_newf("%s-%" PFMT64d "-%s", rz_config_get(core->config, "asm.arch"),
+		rz_config_get_i(core->config, "asm.bits"), rz_config_get(core->config, "asm.cpu"));
+	char *r = arch ? rz_str_newf("%s-%08x", digest, rz_hash_xxhash((const ut8 *)arch, strlen(arch))) : NULL;
+	free(arch);
+	free(digest);
+	return r;
+}
+
+/**
+ * \brief Open the function cache of analysis.cache.dir
+ *
+ * Until rz_core_analysis_cache_close() is called, rz_core_analysis_fcn()
+ * reuses the functions found in the cache.
+ *
+ * \param level analysis level, i.e. "aa", "aaa" or "aaaa"
+ * \return false if caching is disabled or the cache cannot be opened
+ */
+RZ_API bool rz_core_analysis_cache_open(RzCore *core, const char *level) {
+	rz_return_val_if_fail(core && level, false);
+	if (core->analysis_cache.db) {
+		return true;
+	}
+	char *path = rz_core_analysis_cache_path(core, "functions");
+	if (!path) {
+		return false;
+	}
+	Sdb *db = sdb_new0();
+	if (!db) {
+		free(path);
+		return false;
+	}
+	if (rz_file_exists(path)) {
+		if (!sdb_text_load(db, path) || sdb_num_get(db, "version", 0) != CACHE_VERSION) {
+			RZ_LOG_WARN("Ignoring the analysis cache at %s\n", path);
+			sdb_free(db);
+			db = sdb_new0();
+			if (!db) {
+				free(path);
+				return false;
+			}
+		}
+	}
+	sdb_num_set(db, "version", CACHE_VERSION, 0);
+	core->analysis_cache.db = db;
+	core->analysis_cache.config = config_digest(core, level);
+	free(path);
+	return true;
+}
+
+/**
+ * \brief Close the function cache, storing the current functions first if \p store
+ *
+ * The file is rewritten only if an entry was added or changed.
+ */
+RZ_API void rz_core_analysis_cache_close(RzCore *core, bool store) {
+	rz_return_if_fail(core);
+	Sdb *db = core->analysis_cache.db;
+	if (!db) {
+		return;
+	}
+	ut64 stores = core->analysis_cache.stores;
+	if (store) {
+		RzListIter *it;
+		RzAnalysisFunction *fcn;
+		rz_list_foreach (core->analysis->fcns, it, fcn) {
+			rz_core_analysis_cache_function_save(core, fcn);
+		}
+	}
+	char *path = NULL;
+	char *dir = NULL;
+	if (core->analysis_cache.stores == stores) {
+		goto beach;
+	}
+	path = rz_core_analysis_cache_path(core, "functions");
+	dir = path ? rz_file_dirname(path) : NULL;
+	if (!dir || !rz_sys_mkdirp(dir)) {
+		RZ_LOG_ERROR("Cannot create the analysis cache directory %s\n", dir ? dir : "");
+		goto beach;
+	}
+	if (!sdb_text_save(db, path, true)) {
+		RZ_LOG_ERROR("Cannot write the analysis cache to %s\n", path);
+	}
+beach:
+	free(dir);
+	free(path);
+	sdb_free(db);
+	core->analysis_cache.db = NULL;
+}
+
+/**
+ * \brief Fill \p fcn from the cache entry matching the code at fcn->addr, if any
+ *
+ * \p fcn must be a new function with addr and bits set, not yet added to the
+ * analysis. On success its blocks, xrefs and variables are created as
+ * rz_analysis_fcn() would have done. Nothing else is touched, so flags and
+ * any other analysis already present are kept.
+ *
+ * \param reftype type of the reference that led to the function
+ */
+RZ_API bool rz_core_analysis_cache_function_load(RzCore *core, RzAnalysisFunction *fcn, int reftype) {
+	rz_return_val_if_fail(core && fcn, false);
+	Sdb *db = core->analysis_cache.db;
+	if (!db || fcn->addr == UT64_MAX || rz_meta_get_at(core->analysis, fcn->addr, RZ_META_TYPE_ANY, NULL)) {
+		return false;
+	}
+	ut8 prefix[CACHE_PREFIX_SIZE];
+	if (!rz_io_read_at(core->io, fcn->addr, prefix, sizeof(prefix))) {
+		core->analysis_cache.misses++;
+		return false;
+	}
+	bool r = false;
+	int len;
+	for (len = sizeof(prefix); len > 0 && !r; len--) {
+		char *key = prefix_key(prefix, len);
+		if (!key) {
+			break;
+		}
+		char *digest;
+		int i;
+		for (i = 0; !r && (digest = sdb_array_get(db, key, i, NULL)); i++) {
+			char *entry = rz_str_newf("f.%s", digest);
+			char *json_str = entry ? sdb_get(db, entry, 0) : NULL;
+			RzJson *json = json_str ? rz_json_parse(json_str) : NULL;
+			if (json) {
+				r = function_restore(core, fcn, reftype, digest, json);
+				rz_json_free(json);
+			}
+			free(json_str);
+			free(entry);
+			free(digest);
+		}
+		free(key);
+	}
+	if (r) {
+		core->analysis_cache.hits++;
+	} else {
+		core->analysis_cache.misses++;
+	}
+	return r;
+}
+
+/**
+ * \brief Store \p fcn in the open function cache
+ *
+ * Functions with jump tables are not stored: their blocks depend on data
+ * outside of the function.
+ */
+RZ_API bool rz_core_analysis_cache_function_save(RzCore *core, RzAnalysisFunction *fcn) {
+	rz_return_val_if_fail(core && fcn, false);
+	Sdb *db = core->analysis_cache.db;
+	RzAnalysisBlock *entry = rz_analysis_get_block_at(core->analysis, fcn->addr);
+	if (!db || !entry || !rz_list_contains(fcn->bbs, entry)) {
+		return false;
+	}
+	bool r = false;
+	char *digest = NULL;
+	char *key = NULL;
+	RzList *xrefs = NULL;
+	RzVector ranges;
+	rz_vector_init(&ranges, sizeof(CacheRange), NULL, NULL);
+	PJ *j = pj_new();
+	if (!j) {
+		goto beach;
+	}
+	pj_o(j);
+	pj_kn(j, "addr", fcn->addr);
+	pj_ki(j, "stack", fcn->stack);
+	pj_ki(j, "maxstack", fcn->maxstack);
+	pj_ki(j, "ninstr", fcn->ninstr);
+	if (fcn->bp_frame) {
+		pj_kb(j, "bp_frame", true);
+	}
+	if (fcn->bp_off) {
+		pj_kN(j, "bp_off", fcn->bp_off);
+	}
+	if (fcn->is_pure) {
+		pj_kb(j, "pure", true);
+	}
+	pj_ka(j, "bbs");
+	RzListIter *it;
+	RzAnalysisBlock *block;
+	rz_list_foreach (fcn->bbs, it, block) {
+		if (block->switch_op) {
+			goto beach;
+		}
+		CacheRange *range = rz_vector_push(&ranges, NULL);
+		if (!range) {
+			goto beach;
+		}
+		range->off = block->addr - fcn->addr;
+		range->size = block->size;
+		pj_o(j);
+		pj_kn(j, "off", range->off);
+		pj_kn(j, "size", block->size);
+		if (block->jump != UT64_MAX) {
+			pj_kn(j, "jump", block->jump);
+		}
+		if (block->fail != UT64_MAX) {
+			pj_kn(j, "fail", block->fail);
+		}
+		pj_ki(j, "ninstr", block->ninstr);
+		if (block->ninstr > 1) {
+			pj_ka(j, "op_pos");
+			size_t i;
+			for (i = 1; i < block->ninstr; i++) {
+				pj_n(j, rz_analysis_block_get_op_offset(block, i));
+			}
+			pj_end(j);
+		}
+		if (block->stackptr) {
+			pj_ki(j, "stackptr", block->stackptr);
+		}
+		if (block->parent_stackptr != INT_MAX) {
+			pj_ki(j, "parent_stackptr", block->parent_stackptr);
+		}
+		pj_end(j);
+	}
+	pj_end(j);
+	pj_ka(j, "xrefs");
+	xrefs = rz_analysis_function_get_xrefs_from(fcn);
+	RzAnalysisXRef *xref;
+	rz_list_foreach (xrefs, it, xref) {
+		pj_o(j);
+		pj_kn(j, "from", xref->from - fcn->addr);
+		pj_kn(j, "to", xref->to);
+		pj_ki(j, "type", xref->type);
+		if (xref->type == RZ_ANALYSIS_REF_TYPE_CALL && rz_analysis_noreturn_at(core->analysis, xref->to)) {
+			pj_kb(j, "noreturn", true);
+		}
+		pj_end(j);
+	}
+	pj_end(j);
+	pj_ka(j, "vars");
+	void **vit;
+	rz_pvector_foreach (&fcn->vars, vit) {
+		rz_serialize_analysis_var_save(j, *vit);
+	}
+	pj_end(j);
+	pj_end(j);
+
+	digest = function_digest(core, fcn->addr, fcn->bits, &ranges);
+	ut8 prefix[CACHE_PREFIX_SIZE];
+	int len = RZ_MIN(sizeof(prefix), entry->size);
+	if (!digest || !rz_io_read_at(core->io, fcn->addr, prefix, len)) {
+		goto beach;
+	}
+	key = rz_str_newf("f.%s", digest);
+	if (!key) {
+		goto beach;
+	}
+	// byte-identical functions share their entry, keep the first one
+	if (!sdb_exists(db, key)) {
+		sdb_set(db, key, pj_string(j), 0);
+		core->analysis_cache.stores++;
+	}
+	free(key);
+	key = prefix_key(prefix, len);
+	if (key && sdb_array_add(db, key, digest, 0)) {
+		core->analysis_cache.stores++;
+	}
+	r = true;
+beach:
+	rz_list_free(xrefs);
+	rz_vector_fini(&ranges);
+	pj_free(j);
+	free(digest);
+	free(key);
+	return r;
+}
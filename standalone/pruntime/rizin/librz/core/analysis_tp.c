@@ -797,6 +797,20 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	}
 }
 
+struct PropagateTypesCtx {
+	RzCore *core;
+	HtUP *op_cache;
+	RzAnalysisBlock *bb;
+	RzAnalysisOp *aop;
+	struct TypeAnalysisCtx *ctx;
+};
+
+static bool propagate_types_cb(RzAnalysisFunction *fcn, void *user) {
+	struct PropagateTypesCtx *pctx = user;
+	propagate_types_among_used_variables(pctx->core, pctx->op_cache, fcn, pctx->bb, pctx->aop, pctx->ctx);
+	return true;
+}
+
 RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
 	RzListIter *it;
 
@@ -899,17 +913,9 @@ RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, H
 
 			RzPVector *ins_traces = analysis->esil->trace->instructions;
 			ctx.cur_idx = rz_pvector_len(ins_traces) - 1;
-			RzList *fcns = rz_analysis_get_functions_in(analysis, aop->addr);
-			if (!fcns) {
-				break;
-			}
-			RzListIter *it;
-			RzAnalysisFunction *fcn;
-			rz_list_foreach (fcns, it, fcn) {
-				propagate_types_among_used_variables(core, op_cache, fcn, bb, aop, &ctx);
-			}
+			struct PropagateTypesCtx pctx = { core, op_cache, bb, aop, &ctx };
+			rz_analysis_functions_foreach_in(analysis, aop->addr, propagate_types_cb, &pctx);
 			addr += aop->size;
-			rz_list_free(fcns);
 		}
 	}
 	// Type propagation for register based args
@@ -108,7 +108,7 @@ RZ_IPI int fcn_cmpaddr(const void *_a, const void *_b) {
 
 static char *getFunctionName(RzCore *core, ut64 addr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (bf && bf->o) {
+	if (bf && bf->o && rz_bin_object_get_classes(bf->o)) {
 		RzBinSymbol *sym = ht_up_find(bf->o->addrzklassmethod, addr, NULL);
 		if (sym && sym->classname && sym->name) {
 			return rz_str_newf("method.%s.%s", sym->classname, sym->name);
@@ -1000,7 +1000,11 @@ static int __core_analysis_fcn(RzCore *core, ut64 at, ut64 from, int reftype, in
 		if (rz_cons_is_breaked()) {
 			break;
 		}
-		fcnlen = rz_analysis_fcn(core->analysis, fcn, at + delta, core->analysis->opt.bb_max_size, reftype);
+		if (!delta && rz_core_analysis_cache_function_load(core, fcn, reftype)) {
+			fcnlen = RZ_ANALYSIS_RET_END;
+		} else {
+			fcnlen = rz_analysis_fcn(core->analysis, fcn, at + delta, core->analysis->opt.bb_max_size, reftype);
+		}
 		if (core->analysis->opt.searchstringrefs) {
 			rz_analysis_set_stringrefs(core, fcn);
 		}
@@ -4221,6 +4225,15 @@ static bool found_xref(RzCore *core, ut64 at, ut64 xref_to, RzAnalysisXRefType t
 	return true;
 }
 
+static void op_arena_stats_print(RzCore *core) {
+	RzArena *arena = core->analysis->op_arena;
+	if (!arena || !core->analysis->verbose) {
+		return;
+	}
+	eprintf("op arena: %" PFMT64u " allocations served by %" PFMT64u " heap chunks, %" PFMT64u " releases, peak %" PFMT64u " bytes\n",
+		arena->stats.allocs, arena->stats.chunks, arena->stats.releases, (ut64)arena->stats.peak);
+}
+
 RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, PJ *pj, int rad) {
 	bool cfg_debug = rz_config_get_b(core->config, "cfg.debug");
 	bool cfg_analysis_strings = rz_config_get_i(core->config, "analysis.strings");
@@ -4257,6 +4270,8 @@ RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, PJ *p
 	rz_cons_break_push(NULL, NULL);
 	at = from;
 	st64 asm_sub_varmin = rz_config_get_i(core->config, "asm.sub.varmin");
+	RzArenaMark arena_mark;
+	bool arena = rz_analysis_op_arena_begin(core->analysis, &arena_mark);
 	while (at < to && !rz_cons_is_breaked()) {
 		int i = 0, ret = bsz;
 		if (!rz_io_is_valid_offset(core->io, at, RZ_PERM_X)) {
@@ -4337,10 +4352,17 @@ RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, PJ *p
 				break;
 			}
 			rz_analysis_op_fini(&op);
+			if (arena) {
+				rz_analysis_op_arena_release(core->analysis, &arena_mark);
+			}
 		}
 		at += bsz;
 		rz_analysis_op_fini(&op);
 	}
+	if (arena) {
+		rz_analysis_op_arena_end(core->analysis, &arena_mark);
+		op_arena_stats_print(core);
+	}
 	rz_cons_break_pop();
 	free(buf);
 	free(block);
@@ -4372,6 +4394,35 @@ static bool isSkippable(RzBinSymbol *s) {
 	return false;
 }
 
+/*
+ * Work queue of the function starts found by aa, in discovery order.
+ * Starts found more than once are not dropped, rz_core_analysis_fcn()
+ * returns early for the ones that already begin a function and may
+ * still resize or split an overlapping one otherwise.
+ */
+typedef struct {
+	RzVector /*<ut64>*/ addrs;
+} FcnQueue;
+
+static void fcn_queue_push(FcnQueue *q, ut64 addr) {
+	rz_vector_push(&q->addrs, &addr);
+}
+
+static void fcn_queue_drain(RzCore *core, FcnQueue *q, int depth) {
+	size_t i;
+	for (i = 0; i < rz_vector_len(&q->addrs); i++) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		ut64 addr = *(ut64 *)rz_vector_index_ptr(&q->addrs, i);
+		rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth);
+		if (!(i % 128)) {
+			rz_core_task_yield(&core->tasks);
+		}
+	}
+	rz_vector_clear(&q->addrs);
+}
+
 RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzList *list;
 	RzListIter *iter;
@@ -4382,6 +4433,8 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzBinSymbol *symbol;
 	int depth = core->analysis->opt.depth;
 	bool analysis_vars = rz_config_get_i(core->config, "analysis.vars");
+	FcnQueue queue;
+	rz_vector_init(&queue.addrs, sizeof(ut64), NULL, NULL);
 
 	/* Analyze Functions */
 	/* Entries */
@@ -4411,28 +4464,30 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 			}
 			if (isValidSymbol(symbol)) {
 				ut64 addr = rz_bin_object_get_vaddr(o, symbol->paddr, symbol->vaddr);
-				rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+				fcn_queue_push(&queue, addr);
 			}
 		}
 	}
+	fcn_queue_drain(core, &queue, depth - 1);
 	rz_core_task_yield(&core->tasks);
 	/* Main */
 	if (o && (binmain = rz_bin_object_get_special_symbol(o, RZ_BIN_SPECIAL_SYMBOL_MAIN))) {
 		if (binmain->paddr != UT64_MAX) {
 			ut64 addr = rz_bin_object_get_vaddr(o, binmain->paddr, binmain->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+			fcn_queue_push(&queue, addr);
 		}
 	}
-	rz_core_task_yield(&core->tasks);
 	if ((list = rz_bin_get_entries(core->bin))) {
 		rz_list_foreach (list, iter, entry) {
 			if (entry->paddr == UT64_MAX) {
 				continue;
 			}
 			ut64 addr = rz_bin_object_get_vaddr(o, entry->paddr, entry->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+			fcn_queue_push(&queue, addr);
 		}
 	}
+	fcn_queue_drain(core, &queue, depth - 1);
+	rz_vector_fini(&queue.addrs);
 	rz_core_task_yield(&core->tasks);
 	if (analysis_vars) {
 		/* Set fcn type to RZ_ANALYSIS_FCN_TYPE_SYM for symbols */
@@ -5410,6 +5465,8 @@ RZ_API void rz_core_analysis_esil(RzCore *core, const char *str, const char *tar
 		eprintf("Warning: No SN reg alias for current architecture.\n");
 	}
 	rz_reg_arena_push(core->analysis->reg);
+	RzArenaMark arena_mark;
+	bool arena = rz_analysis_op_arena_begin(core->analysis, &arena_mark);
 
 	IterCtx ictx = { start, end, fcn, NULL };
 	size_t i = addr - start;
@@ -5450,6 +5507,9 @@ RZ_API void rz_core_analysis_esil(RzCore *core, const char *str, const char *tar
 		}
 
 		rz_analysis_op_fini(&op);
+		if (arena) {
+			rz_analysis_op_arena_release(core->analysis, &arena_mark);
+		}
 		rz_asm_set_pc(core->rasm, cur);
 		if (!rz_analysis_op(core->analysis, &op, cur, buf + i, iend - i, RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_HINT)) {
 			i += minopsize - 1; //   XXX dupe in op.size below
@@ -5690,6 +5750,10 @@ RZ_API void rz_core_analysis_esil(RzCore *core, const char *str, const char *tar
 	ESIL->cb.hook_reg_write = NULL;
 	ESIL->user = NULL;
 	rz_analysis_op_fini(&op);
+	if (arena) {
+		rz_analysis_op_arena_end(core->analysis, &arena_mark);
+		op_arena_stats_print(core);
+	}
 	rz_cons_break_pop();
 	// restore register
 	rz_reg_arena_pop(core->analysis->reg);
@@ -6563,6 +6627,140 @@ RZ_API void rz_core_analysis_propagate_noreturn(RzCore *core, ut64 addr) {
 	ht_uu_free(done);
 }
 
+static void collect_fcn_addr(RzAnalysisBlock *block, SetU *addrs, RzList *out) {
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (block->fcns, iter, fcn) {
+		if (!set_u_contains(addrs, fcn->addr)) {
+			set_u_add(addrs, fcn->addr);
+			rz_list_append(out, ut64_new(fcn->addr));
+		}
+	}
+}
+
+/*
+ * Chop the block calling a noreturn function right after the call at
+ * call_addr and queue the functions of the block that became noreturn.
+ */
+static void chop_noreturn_call(RzCore *core, ut64 call_addr, SetU *done, RzVector *todo) {
+	RzAnalysisBlock *block = find_block_at_xref_addr(core, call_addr);
+	if (!block) {
+		return;
+	}
+	RzAnalysisOp *op = rz_core_op_analysis(core, call_addr, RZ_ANALYSIS_OP_MASK_BASIC);
+	if (!op) {
+		rz_analysis_block_unref(block);
+		return;
+	}
+	ut64 chop_addr = call_addr + op->size;
+	rz_analysis_op_free(op);
+	RzList *block_fcns = rz_list_clone(block->fcns);
+	// rz_analysis_block_chop_noreturn() might free the block!
+	block = rz_analysis_block_chop_noreturn(block, chop_addr);
+	RzListIter *it;
+	RzAnalysisFunction *f;
+	rz_list_foreach (block_fcns, it, f) {
+		if (!f->addr || f->is_noreturn || set_u_contains(done, f->addr)) {
+			continue;
+		}
+		if (analyze_noreturn_function(core, f)) {
+			f->is_noreturn = true;
+			rz_analysis_noreturn_add(core->analysis, NULL, f->addr);
+			set_u_add(done, f->addr);
+			rz_vector_push(todo, &f->addr);
+		}
+	}
+	if (block) {
+		rz_analysis_block_unref(block);
+	}
+	rz_list_free(block_fcns);
+}
+
+/*
+ * Propagate the noreturn state of the functions in todo to their callers only,
+ * unlike rz_core_analysis_propagate_noreturn() which looks at the whole program.
+ */
+static void propagate_noreturn_callers(RzCore *core, SetU *done, RzVector *todo) {
+	while (!rz_vector_empty(todo)) {
+		ut64 noret_addr;
+		rz_vector_pop(todo, &noret_addr);
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		RzList *xrefs = rz_analysis_xrefs_get_to(core->analysis, noret_addr);
+		RzListIter *it;
+		RzAnalysisXRef *xref;
+		rz_list_foreach (xrefs, it, xref) {
+			if (xref->type == RZ_ANALYSIS_REF_TYPE_CALL) {
+				chop_noreturn_call(core, xref->from, done, todo);
+			}
+		}
+		rz_list_free(xrefs);
+	}
+}
+
+/**
+ * \brief Update the analysis after \p size bytes at \p addr have been written
+ *
+ * Only the functions owning a modified block are reanalyzed. Their calls to
+ * noreturn functions are chopped and, if one of them became noreturn, so
+ * are the call sites of its callers, transitively.
+ */
+RZ_IPI void rz_core_analysis_update_range(RzCore *core, ut64 addr, int size) {
+	RzList *blocks = rz_analysis_get_blocks_intersect(core->analysis, addr, size);
+	if (rz_list_empty(blocks)) {
+		rz_list_free(blocks);
+		return;
+	}
+	SetU *seen = set_u_new();
+	SetU *done = set_u_new();
+	RzList *fcns = rz_list_newf(free);
+	RzVector todo;
+	rz_vector_init(&todo, sizeof(ut64), NULL, NULL);
+	RzListIter *iter;
+	RzAnalysisBlock *block;
+	if (!seen || !done || !fcns) {
+		goto beach;
+	}
+	rz_list_foreach (blocks, iter, block) {
+		collect_fcn_addr(block, seen, fcns);
+	}
+	rz_list_free(blocks);
+	blocks = NULL;
+
+	rz_analysis_update_analysis_range(core->analysis, addr, size);
+
+	ut64 *faddr;
+	rz_list_foreach (fcns, iter, faddr) {
+		RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, *faddr);
+		if (!fcn) {
+			continue;
+		}
+		RzList *xrefs = rz_analysis_function_get_xrefs_from(fcn);
+		RzListIter *it;
+		RzAnalysisXRef *xref;
+		rz_list_foreach (xrefs, it, xref) {
+			if (xref->type == RZ_ANALYSIS_REF_TYPE_CALL && rz_analysis_noreturn_at(core->analysis, xref->to)) {
+				chop_noreturn_call(core, xref->from, done, &todo);
+			}
+		}
+		rz_list_free(xrefs);
+		if (!fcn->is_noreturn && !set_u_contains(done, fcn->addr) && analyze_noreturn_function(core, fcn)) {
+			fcn->is_noreturn = true;
+			rz_analysis_noreturn_add(core->analysis, NULL, fcn->addr);
+			set_u_add(done, fcn->addr);
+			rz_vector_push(&todo, &fcn->addr);
+		}
+	}
+	propagate_noreturn_callers(core, done, &todo);
+beach:
+	rz_vector_fini(&todo);
+	rz_list_free(blocks);
+	rz_list_free(fcns);
+	set_u_free(seen);
+	set_u_free(done);
+}
+
 RZ_IPI bool rz_core_analysis_var_rename(RzCore *core, const char *name, const char *newname) {
 	RzAnalysisOp *op = rz_core_analysis_op(core, core->offset, RZ_ANALYSIS_OP_MASK_BASIC);
 	if (!name) {
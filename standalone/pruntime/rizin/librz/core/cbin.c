@@ -362,7 +362,12 @@ RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile) {
 	}
 	rz_asm_use(r->rasm, arch);
 
-	rz_core_bin_apply_info(r, binfile, RZ_CORE_BIN_ACC_ALL);
+	ut32 mask = RZ_CORE_BIN_ACC_ALL;
+	if (r->bin->lazy) {
+		// string and class flags are the only consumers at load, skip them
+		mask &= ~(RZ_CORE_BIN_ACC_STRINGS | RZ_CORE_BIN_ACC_CLASSES);
+	}
+	rz_core_bin_apply_info(r, binfile, mask);
 
 	rz_core_bin_set_cur(r, binfile);
 	return true;
@@ -1548,11 +1553,11 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
-	RzList *cs = o ? o->classes : NULL;
-	if (!cs) {
+	if (!o || !rz_config_get_b(core->config, "bin.classes")) {
 		return false;
 	}
-	if (!rz_config_get_b(core->config, "bin.classes")) {
+	const RzList *cs = rz_bin_object_get_classes(o);
+	if (!cs) {
 		return false;
 	}
 
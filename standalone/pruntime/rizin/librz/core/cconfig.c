@@ -2487,6 +2487,13 @@ static bool cb_debase64(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binlazy(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->bin->lazy = node->i_value;
+	return true;
+}
+
 static bool cb_binstrings(void *user, void *data) {
 	const ut32 req = RZ_BIN_REQ_STRINGS;
 	RzCore *core = (RzCore *)user;
@@ -2632,8 +2639,7 @@ static bool cb_dirpfx(RzCore *core, RzConfigNode *node) {
 
 static bool cb_analysis_roregs(RzCore *core, RzConfigNode *node) {
 	if (core && core->analysis && core->analysis->reg) {
-		rz_list_free(core->analysis->reg->roregs);
-		core->analysis->reg->roregs = rz_str_split_duplist(node->value, ",", true);
+		rz_reg_set_roregs(core->analysis->reg, rz_str_split_duplist(node->value, ",", true));
 	}
 	return true;
 }
@@ -2748,6 +2754,13 @@ static bool cb_analysis_jmpmid(void *user, void *data) {
 	return true;
 }
 
+static bool cb_analysis_arena(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	core->analysis->opt.op_arena = node->i_value;
+	return true;
+}
+
 static bool cb_analysis_searchstringrefs(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -2952,6 +2965,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 		"dbg.map", "dbg.maps", "dbg.maps.rwx", "dbg.maps.r", "dbg.maps.rw", "dbg.maps.rx", "dbg.maps.wx", "dbg.maps.x",
 		"analysis.fcn", "analysis.bb",
 		NULL);
+	SETPREF("analysis.cache.dir", "", "Directory where the results of aa/aaa and /R are cached across sessions (empty to disable)");
 	SETI("analysis.timeout", 0, "Stop analyzing after a couple of seconds");
 	SETCB("analysis.jmp.retpoline", "true", &cb_analysis_jmpretpoline, "Analyze retpolines, may be slower if not needed");
 	SETICB("analysis.jmp.tailcall", 0, &cb_analysis_jmptailcall, "Consume a branch as a call if delta is big");
@@ -3001,6 +3015,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("analysis.datarefs", "false", &cb_analysis_followdatarefs, "Follow data references for code coverage");
 	SETCB("analysis.brokenrefs", "false", &cb_analysis_brokenrefs, "Follow function references as well if function analysis was failed");
 	SETCB("analysis.jmp.mid", "true", &cb_analysis_jmpmid, "Continue analysis after jump to middle of instruction (x86 only)");
+	SETCB("analysis.arena", "true", &cb_analysis_arena, "Allocate the temporaries of each analyzed instruction in an arena (aae, aar, af)");
 
 	SETCB("analysis.refstr", "false", &cb_analysis_searchstringrefs, "Search string references in data references");
 	SETCB("analysis.trycatch", "false", &cb_analysis_trycatch, "Honor try.X.Y.{from,to,catch} flags");
@@ -3245,6 +3260,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("bin.prefix", "", &cb_binprefix, "Prefix all symbols/sections/relocs with a specific string");
 	SETCB("bin.rawstr", "false", &cb_rawstr, "Load strings from raw binaries");
 	SETCB("bin.strings", "true", &cb_binstrings, "Load strings from rbin on startup");
+	SETCB("bin.lazy", "false", &cb_binlazy, "Compute strings, classes and file hashes on first use instead of when opening a file");
 	SETCB("bin.debase64", "false", &cb_debase64, "Try to debase64 all strings");
 	SETBPREF("bin.classes", "true", "Load classes from rbin on startup");
 	SETCB("bin.verbose", "false", &cb_binverbose, "Show RzBin warnings when loading binaries");
@@ -3426,6 +3442,11 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	/* cmd */
 	SETCB("cmd.demangle", "false", &cb_bdc, "run xcrun swift-demangle and similar if available (SLOW)");
 	SETICB("cmd.depth", 10, &cb_cmddepth, "Maximum command depth");
+	SETI("cmd.cache", 64, "Number of parsed commands kept to run them again without parsing (0 to disable)");
+	SETBPREF("cmd.profile", "false", "Print the time spent parsing and running each command");
+	SETBPREF("cmd.framed", "false", "Read length-prefixed frames instead of lines in the -0 prompt loop (used by rzpipe_framed)");
+	SETI("cmd.iter.jobs", 1, "Processes running the command of @@ iterators over offsets, flags and functions, when it is in cmd.iter.jobs.cmds");
+	SETPREF("cmd.iter.jobs.cmds", "pd,pdj,pdf,pdfj,pi,pif,pifj,px,pxj,pxw,pxq,ps,psj,afi,afij,afb,afbj,axt,axtj,axf,axff,axffj", "Comma separated names of the read-only commands that cmd.iter.jobs can run in parallel");
 	SETPREF("cmd.bp", "", "Run when a breakpoint is hit");
 	SETPREF("cmd.onsyscall", "", "Run when a syscall is hit");
 	SETICB("cmd.hitinfo", 1, &cb_debug_hitinfo, "Show info when a tracepoint/breakpoint is hit");
@@ -3508,6 +3529,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETPREF("http.port", "9090", "HTTP server port");
 	SETPREF("http.maxport", "9999", "Last HTTP server port");
 	SETI("http.timeout", 3, "Disconnect clients after N seconds of inactivity");
+	SETI("http.jobs", 0, "Processes answering the read-only commands in http.jobs.cmds while the server goes on (0 to answer all requests in turn)");
+	SETPREF("http.jobs.cmds", "pd,pdj,pdf,pdfj,px,pxj,i,ij,afl,aflj,afi,afij,axt,axtj,axf,axfj", "Comma separated names of the read-only commands that can be answered by http.jobs");
 	SETI("http.dietime", 0, "Kill server after N seconds with no client");
 	SETBPREF("http.verbose", "false", "Output server logs to stdout");
 	SETBPREF("http.upget", "false", "/up/ answers GET requests, in addition to POST");
@@ -15,7 +15,11 @@
 #if __UNIX__
 #include <sys/utsname.h>
 #endif
+#if __UNIX__ && HAVE_FORK
+#include <sys/wait.h>
+#endif
 
+#include "core_private.h"
 #include <cmd_descs.h>
 
 #include <tree_sitter/api.h>
@@ -4325,6 +4329,13 @@ static TSTree *apply_edits(struct tsr2cmd_state *state, RzList *edits) {
 		state->input = rz_str_replace(state->input, edit->old_text, edit->new_text, 0);
 	}
 	RZ_LOG_DEBUG("new input = '%s'\n", state->input);
+	if (!state->parser) {
+		// commands served by the parse cache do not have a parser yet
+		state->parser = ts_parser_new();
+		if (!ts_parser_set_language(state->parser, (TSLanguage *)state->core->rcmd->language)) {
+			return NULL;
+		}
+	}
 	return ts_parser_parse_string(state->parser, NULL, state->input, strlen(state->input));
 }
 
@@ -4350,6 +4361,13 @@ static void substitute_args_init(struct tsr2cmd_state *state, TSNode command) {
 }
 
 static bool substitute_args_do(struct tsr2cmd_state *state, RzList *edits, TSNode *new_command) {
+	if (rz_list_empty(edits)) {
+		// nothing to substitute, the command can be used as it is parsed
+		free(state->input);
+		state->input = state->saved_input;
+		*new_command = state->substitute_cmd;
+		return true;
+	}
 	TSTree *new_tree = apply_edits(state, edits);
 	if (!new_tree) {
 		return false;
@@ -5109,6 +5127,190 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(tmp_hex_stmt) {
 	return res;
 }
 
+/* An iteration of a @@ iterator, collected to be run by forked processes */
+typedef struct {
+	ut64 addr;
+	ut32 size; ///< block size to use, 0 to keep the current one
+} IterJob;
+
+/**
+ * \brief Check that \p cmd runs a single command named in \p names
+ *
+ * \p names is a comma separated list of whole command names, e.g. "pd,pdf",
+ * so that listing a command does not allow the ones it is a prefix of.
+ * Commands chained with others, piped, redirected or with subcommands are
+ * never accepted.
+ */
+RZ_IPI bool rz_core_cmd_is_listed(const char *cmd, const char *names) {
+	rz_return_val_if_fail(cmd && names, false);
+	cmd = rz_str_trim_head_ro(cmd);
+	if (strpbrk(cmd, ";|>`\n") || strstr(cmd, "$(")) {
+		return false;
+	}
+	size_t len = strcspn(cmd, " \t@~");
+	while (len && *names) {
+		while (*names == ' ') {
+			names++;
+		}
+		size_t name_len = strcspn(names, ", ");
+		if (name_len == len && !strncmp(names, cmd, len)) {
+			return true;
+		}
+		names += name_len;
+		names += strspn(names, ", ");
+	}
+	return false;
+}
+
+/**
+ * Returns a vector where an iterator collects its iterations instead of running
+ * them when cmd.iter.jobs asks for more than one process and \p command is
+ * one of the read-only commands of cmd.iter.jobs.cmds, NULL otherwise.
+ */
+static RzVector /*<IterJob>*/ *iter_jobs_new(struct tsr2cmd_state *state, TSNode command) {
+#if __UNIX__ && HAVE_FORK
+	RzCore *core = state->core;
+	if (rz_config_get_i(core->config, "cmd.iter.jobs") < 2) {
+		return NULL;
+	}
+	char *cmd = ts_node_sub_string(command, state->input);
+	bool readonly = cmd && rz_core_cmd_is_listed(cmd, rz_config_get(core->config, "cmd.iter.jobs.cmds"));
+	free(cmd);
+	if (readonly) {
+		return rz_vector_new(sizeof(IterJob), NULL, NULL);
+	}
+#endif
+	return NULL;
+}
+
+static void iter_jobs_push(RzVector /*<IterJob>*/ *jobs, ut64 addr, ut32 size) {
+	IterJob job = { .addr = addr, .size = size };
+	rz_vector_push(jobs, &job);
+}
+
+static RzCmdStatus iter_jobs_inplace(struct tsr2cmd_state *state, TSNode command, IterJob *job, size_t n) {
+	RzCore *core = state->core;
+	size_t i;
+	for (i = 0; i < n; i++) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		rz_core_seek(core, job[i].addr, true);
+		if (job[i].size) {
+			rz_core_block_size(core, job[i].size);
+		}
+		RzCmdStatus res = handle_ts_stmt_tmpseek(state, command);
+		if (res != RZ_CMD_STATUS_OK) {
+			return res;
+		}
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+#if __UNIX__ && HAVE_FORK
+static void iter_jobs_child(struct tsr2cmd_state *state, TSNode command, IterJob *job, size_t n, int fd) {
+	// the output is sent to the parent, which prints it in the order of the iterations
+	rz_cons_push();
+	RzCmdStatus res = iter_jobs_inplace(state, command, job, n);
+	const char *out = rz_cons_get_buffer();
+	int len = rz_cons_get_buffer_len();
+	while (out && len > 0) {
+		ssize_t w = write(fd, out, len);
+		if (w <= 0) {
+			break;
+		}
+		out += w;
+		len -= w;
+	}
+	rz_sys_pipe_close(fd);
+	_exit(res);
+}
+#endif
+
+/**
+ * Runs \p command for every iteration in \p jobs, split in contiguous slices
+ * among cmd.iter.jobs forked processes. The forked processes work on a copy of
+ * the session, so this is only meant for commands that do not modify it.
+ * Slices that cannot be forked are run in place. With \p flush, the output is
+ * flushed as soon as it is received, like the iterators that flush after
+ * every iteration.
+ */
+static RzCmdStatus iter_jobs_run(struct tsr2cmd_state *state, TSNode command, RzVector /*<IterJob>*/ *jobs, bool flush) {
+	size_t n = rz_vector_len(jobs);
+	if (!n) {
+		return RZ_CMD_STATUS_OK;
+	}
+	IterJob *job = rz_vector_index_ptr(jobs, 0);
+#if __UNIX__ && HAVE_FORK
+	RzCore *core = state->core;
+	size_t n_procs = RZ_MIN(rz_config_get_i(core->config, "cmd.iter.jobs"), n);
+	int *fds = RZ_NEWS(int, n_procs);
+	int *pids = RZ_NEWS(int, n_procs);
+	if (!fds || !pids) {
+		free(fds);
+		free(pids);
+		return iter_jobs_inplace(state, command, job, n);
+	}
+	size_t p;
+	for (p = 0; p < n_procs; p++) {
+		size_t from = n * p / n_procs;
+		size_t to = n * (p + 1) / n_procs;
+		int fd[2];
+		pids[p] = -1;
+		if (rz_sys_pipe(fd, true)) {
+			continue;
+		}
+		pids[p] = rz_sys_fork();
+		if (!pids[p]) {
+			rz_sys_pipe_close(fd[0]);
+			iter_jobs_child(state, command, job + from, to - from, fd[1]);
+		}
+		rz_sys_pipe_close(fd[1]);
+		if (pids[p] < 0) {
+			rz_sys_pipe_close(fd[0]);
+			continue;
+		}
+		fds[p] = fd[0];
+	}
+	RzCmdStatus res = RZ_CMD_STATUS_OK;
+	for (p = 0; p < n_procs; p++) {
+		size_t from = n * p / n_procs;
+		size_t to = n * (p + 1) / n_procs;
+		if (pids[p] < 0) {
+			if (res == RZ_CMD_STATUS_OK) {
+				res = iter_jobs_inplace(state, command, job + from, to - from);
+			}
+			continue;
+		}
+		char buf[0x1000];
+		ssize_t r;
+		while ((r = read(fds[p], buf, sizeof(buf))) > 0) {
+			if (res == RZ_CMD_STATUS_OK) {
+				rz_cons_memcat(buf, r);
+				if (flush) {
+					rz_cons_flush();
+				}
+			}
+		}
+		rz_sys_pipe_close(fds[p]);
+		int st = 0;
+		waitpid(pids[p], &st, 0);
+		if (res == RZ_CMD_STATUS_OK) {
+			if (!WIFEXITED(st)) {
+				res = RZ_CMD_STATUS_ERROR;
+			} else if (WEXITSTATUS(st) != RZ_CMD_STATUS_OK) {
+				res = WEXITSTATUS(st);
+			}
+		}
+	}
+	free(fds);
+	free(pids);
+	return res;
+#else
+	return iter_jobs_inplace(state, command, job, n);
+#endif
+}
+
 DEFINE_HANDLE_TS_FCN_AND_SYMBOL(iter_flags_stmt) {
 	RzCore *core = state->core;
 	TSNode command = ts_node_named_child(node, 0);
@@ -5136,10 +5338,15 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(iter_flags_stmt) {
 	rz_flag_foreach_space(core->flags, flagspace, duplicate_flag, &u);
 
 	/* for all flags that match */
+	RzVector *jobs = iter_jobs_new(state, command);
 	rz_list_foreach (match_flag_items, iter, flag) {
 		if (rz_cons_is_breaked()) {
 			break;
 		}
+		if (jobs) {
+			iter_jobs_push(jobs, flag->offset, 0);
+			continue;
+		}
 
 		RZ_LOG_DEBUG("iter_flags_stmt: seek to %" PFMT64x "\n", flag->offset);
 		rz_core_seek(core, flag->offset, true);
@@ -5147,8 +5354,12 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(iter_flags_stmt) {
 		rz_core_task_yield(&core->tasks);
 		UPDATE_CMD_STATUS_RES(ret, cmd_res, err);
 	}
+	if (jobs) {
+		ret = iter_jobs_run(state, command, jobs, false);
+	}
 
 err:
+	rz_vector_free(jobs);
 	rz_list_free(match_flag_items);
 	free(arg_str);
 	return ret;
@@ -5248,12 +5459,17 @@ static RzCmdStatus do_iter_offsets(RzCore *core, struct tsr2cmd_state *state, TS
 	int i;
 	ut64 orig_offset = core->offset;
 	ut64 orig_blk_sz = core->blocksize;
+	RzVector *jobs = iter_jobs_new(state, *command);
 	rz_cmd_parsed_args_foreach_arg(a, i, s) {
 		ut64 addr = rz_num_math(core->num, s);
 		ut64 blk_sz = core->blocksize;
 		if (has_size) {
 			blk_sz = rz_num_math(core->num, a->argv[i++ + 1]);
 		}
+		if (jobs) {
+			iter_jobs_push(jobs, addr, has_size ? blk_sz : 0);
+			continue;
+		}
 		rz_core_seek(core, addr, true);
 		if (has_size) {
 			rz_core_block_size(core, blk_sz);
@@ -5262,8 +5478,12 @@ static RzCmdStatus do_iter_offsets(RzCore *core, struct tsr2cmd_state *state, TS
 		rz_cons_flush();
 		UPDATE_CMD_STATUS_RES(res, cmd_res, err);
 	}
+	if (jobs) {
+		res = iter_jobs_run(state, *command, jobs, true);
+	}
 
 err:
+	rz_vector_free(jobs);
 	if (has_size) {
 		rz_core_block_size(core, orig_blk_sz);
 	}
@@ -5755,20 +5975,30 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(iter_function_stmt) {
 	RzList *list = core->analysis->fcns;
 	RzListIter *iter;
 	RzCmdStatus res = RZ_CMD_STATUS_OK;
+	RzVector *jobs = iter_jobs_new(state, command);
 	rz_cons_break_push(NULL, NULL);
 	rz_list_foreach (list, iter, fcn) {
 		if (rz_cons_is_breaked()) {
 			break;
 		}
-		if (!filter || rz_str_glob(fcn->name, filter)) {
-			rz_core_seek(core, fcn->addr, true);
-			rz_core_block_size(core, rz_analysis_function_linear_size(fcn));
-			RzCmdStatus cmd_res = handle_ts_stmt_tmpseek(state, command);
-			UPDATE_CMD_STATUS_RES(res, cmd_res, err);
+		if (filter && !rz_str_glob(fcn->name, filter)) {
+			continue;
 		}
+		if (jobs) {
+			iter_jobs_push(jobs, fcn->addr, rz_analysis_function_linear_size(fcn));
+			continue;
+		}
+		rz_core_seek(core, fcn->addr, true);
+		rz_core_block_size(core, rz_analysis_function_linear_size(fcn));
+		RzCmdStatus cmd_res = handle_ts_stmt_tmpseek(state, command);
+		UPDATE_CMD_STATUS_RES(res, cmd_res, err);
+	}
+	if (jobs) {
+		res = iter_jobs_run(state, command, jobs, false);
 	}
 err:
 	rz_cons_break_pop();
+	rz_vector_free(jobs);
 	rz_core_block_size(core, obs);
 	rz_core_seek(core, offorig, true);
 	free(filter);
@@ -5805,10 +6035,6 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(grep_stmt) {
 	TSNode command = ts_node_child_by_field_name(node, "command", strlen("command"));
 	TSNode arg = ts_node_child_by_field_name(node, "specifier", strlen("specifier"));
 	char *arg_str = ts_node_handle_arg(state, node, arg, 1);
-	bool is_pipe = state->core->is_pipe;
-	state->core->is_pipe = true;
-	RzCmdStatus res = handle_ts_stmt(state, command);
-	state->core->is_pipe = is_pipe;
 	RZ_LOG_DEBUG("grep_stmt specifier: '%s'\n", arg_str);
 	RzStrBuf *sb = rz_strbuf_new(arg_str);
 	rz_strbuf_prepend(sb, "~");
@@ -5816,7 +6042,18 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(grep_stmt) {
 	rz_strbuf_free(sb);
 	char *specifier_str = rz_cmd_unescape_arg(specifier_str_es, true);
 	RZ_LOG_DEBUG("grep_stmt processed specifier: '%s'\n", specifier_str);
-	rz_cons_grep_process(specifier_str);
+	// simple greps filter the lines while the command prints them
+	bool stream = rz_cons_grep_stream_begin(specifier_str);
+	bool is_pipe = state->core->is_pipe;
+	state->core->is_pipe = true;
+	RzCmdStatus res = handle_ts_stmt(state, command);
+	state->core->is_pipe = is_pipe;
+	if (stream) {
+		rz_cons_grep_stream_end();
+		free(specifier_str);
+	} else {
+		rz_cons_grep_process(specifier_str);
+	}
 	free(specifier_str_es);
 	free(arg_str);
 	return res;
@@ -6027,23 +6264,151 @@ static void ts_symbols_init(RzCmd *cmd) {
 	}
 }
 
+/* Parse trees of the last commands, see cmd.cache */
+struct rz_core_cmd_cache_t {
+	HtPP *trees; ///< command text with masked numbers (see cmd_cache_key) -> TSTree
+	ut64 hits;
+	ut64 misses;
+};
+
+static void cmd_cache_free_kv(HtPPKv *kv) {
+	free(kv->key);
+	ts_tree_delete(kv->value);
+}
+
+RZ_IPI void rz_core_cmd_cache_free(RzCoreCmdCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_pp_free(cache->trees);
+	free(cache);
+}
+
+static bool cmd_cache_is_token_end(char c) {
+	return !c || IS_WHITESPACE(c);
+}
+
+/**
+ * Replace the digits of numbers with 1s, so that commands differing only by
+ * their numbers share a parse tree. The replaced numbers are whole words made
+ * of [1-9][0-9]* or 0x[0-9a-fA-F]+: the 1s do not change how they are parsed,
+ * and having the same length as the original they leave every node in place.
+ */
+static char *cmd_cache_key(const char *input) {
+	char *key = strdup(input);
+	if (!key) {
+		return NULL;
+	}
+	char *p = key;
+	while (*p) {
+		if (p > key && !IS_WHITESPACE(p[-1])) {
+			p++;
+			continue;
+		}
+		char *digits = NULL;
+		char *end = p;
+		if (p[0] == '0' && p[1] == 'x' && IS_HEXCHAR(p[2])) {
+			digits = end = p + 2;
+			while (IS_HEXCHAR(*end)) {
+				end++;
+			}
+		} else if (*p >= '1' && *p <= '9') {
+			digits = end = p;
+			while (IS_DIGIT(*end)) {
+				end++;
+			}
+		}
+		if (digits && cmd_cache_is_token_end(*end)) {
+			memset(digits, '1', end - digits);
+		}
+		p = end > p ? end : p + 1;
+	}
+	return key;
+}
+
+/**
+ * Returns a reference to the cached parse tree of \p input, to be released
+ * with ts_tree_delete, or NULL if the command was not parsed recently.
+ */
+static TSTree *cmd_cache_get(RzCore *core, const char *input) {
+	RzCoreCmdCache *cache = core->cmd_cache;
+	if (!cache) {
+		return NULL;
+	}
+	char *key = cmd_cache_key(input);
+	TSTree *tree = key ? ht_pp_find(cache->trees, key, NULL) : NULL;
+	free(key);
+	if (!tree) {
+		cache->misses++;
+		return NULL;
+	}
+	cache->hits++;
+	return ts_tree_copy(tree);
+}
+
+static void cmd_cache_put(RzCore *core, const char *input, TSTree *tree) {
+	ut64 size = rz_config_get_i(core->config, "cmd.cache");
+	if (!size) {
+		return;
+	}
+	RzCoreCmdCache *cache = core->cmd_cache;
+	if (!cache) {
+		cache = RZ_NEW0(RzCoreCmdCache);
+		if (!cache) {
+			return;
+		}
+		cache->trees = ht_pp_new(NULL, cmd_cache_free_kv, NULL);
+		if (!cache->trees) {
+			free(cache);
+			return;
+		}
+		core->cmd_cache = cache;
+	}
+	if (cache->trees->count >= size) {
+		// scripts only use a few shapes of commands, start over instead of tracking their use
+		ht_pp_free(cache->trees);
+		cache->trees = ht_pp_new(NULL, cmd_cache_free_kv, NULL);
+		if (!cache->trees) {
+			return;
+		}
+	}
+	char *key = cmd_cache_key(input);
+	if (key) {
+		TSTree *copy = ts_tree_copy(tree);
+		if (!ht_pp_insert(cache->trees, key, copy)) {
+			ts_tree_delete(copy);
+		}
+		free(key);
+	}
+}
+
 static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_lines, bool log) {
 	ts_symbols_init(core->rcmd);
 
-	TSParser *parser = ts_parser_new();
-	bool language_ok = ts_parser_set_language(parser, (TSLanguage *)core->rcmd->language);
-	rz_return_val_if_fail(language_ok, RZ_CMD_STATUS_INVALID);
-
+	bool profile = rz_config_get_b(core->config, "cmd.profile");
+	ut64 t_start = profile ? rz_time_now_mono() : 0;
 	char *input = strdup(rz_str_trim_head_ro(cstr));
-
-	TSTree *tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	TSParser *parser = NULL;
+	TSTree *tree = cmd_cache_get(core, input);
+	bool cached = tree;
+	if (!tree) {
+		parser = ts_parser_new();
+		bool language_ok = ts_parser_set_language(parser, (TSLanguage *)core->rcmd->language);
+		rz_return_val_if_fail(language_ok, RZ_CMD_STATUS_INVALID);
+		tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	}
 	if (!tree) {
 		rz_warn_if_reached();
+		ts_parser_delete(parser);
 		free(input);
 		return RZ_CMD_STATUS_INVALID;
 	}
 
 	TSNode root = ts_tree_root_node(tree);
+	if (!cached && !ts_node_has_error(root)) {
+		cmd_cache_put(core, input, tree);
+	}
+	ut64 t_parsed = profile ? rz_time_now_mono() : 0;
 
 	RzCmdStatus res = RZ_CMD_STATUS_INVALID;
 	struct tsr2cmd_state state;
@@ -6069,9 +6434,16 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 		// tokens to indicate where, probably, the error is.
 		eprintf("Error while parsing command: `%s`\n", input);
 	}
+	if (profile) {
+		ut64 t_end = rz_time_now_mono();
+		eprintf("cmd.profile: parse %" PFMT64u "us%s, exec %" PFMT64u "us: %s\n",
+			t_parsed - t_start, cached ? " (cached)" : "", t_end - t_parsed, input);
+	}
 
 	ts_tree_delete(tree);
-	ts_parser_delete(parser);
+	if (state.parser) {
+		ts_parser_delete(state.parser);
+	}
 	free(input);
 	return res;
 }
@@ -48,6 +48,7 @@ static const char *help_msg_aa[] = {
 	"aaa", "[?]", "autoname functions after aa (see afna)",
 	"aac", " [len]", "analyze function calls (af @@=`pi len~call[1]`)",
 	"aac*", " [len]", "flag function calls without performing a complete analysis",
+	"aaC", "[j]", "show the statistics of the analysis cache (see analysis.cache.dir)",
 	"aad", " [len]", "analyze data references to code",
 	"aae", " [len] ([addr])", "analyze references with ESIL (optionally to address)",
 	"aaef", "", "analyze references with ESIL in all functions",
@@ -3205,12 +3206,11 @@ RZ_IPI int rz_cmd_analysis_fcn(void *data, const char *input) {
 			char *sp = strchr(input + 1, ' ');
 			const char *arg = sp ? rz_str_trim_head_ro(sp) : NULL;
 			ut64 addr = arg ? rz_num_math(core->num, arg) : core->offset;
-			RzList *l = rz_analysis_get_functions_in(core->analysis, addr);
-			if (rz_list_empty(l)) {
+			RzAnalysisFunction *fcn = rz_analysis_first_function_in(core->analysis, addr);
+			if (!fcn) {
 				eprintf("No functions at 0x%" PFMT64x, addr);
 				break;
 			}
-			RzAnalysisFunction *fcn = rz_list_first(l);
 			rz_core_analysis_fcn_returns(core, fcn);
 			break;
 		}
@@ -3218,12 +3218,11 @@ RZ_IPI int rz_cmd_analysis_fcn(void *data, const char *input) {
 			char *sp = strchr(input + 1, ' ');
 			const char *arg = sp ? rz_str_trim_head_ro(sp) : NULL;
 			ut64 addr = arg ? rz_num_math(core->num, arg) : core->offset;
-			RzList *l = rz_analysis_get_functions_in(core->analysis, addr);
-			if (rz_list_empty(l)) {
+			RzAnalysisFunction *fcn = rz_analysis_first_function_in(core->analysis, addr);
+			if (!fcn) {
 				eprintf("No functions at 0x%" PFMT64x, addr);
 				break;
 			}
-			RzAnalysisFunction *fcn = rz_list_first(l);
 			rz_core_analysis_bbs_asciiart(core, fcn);
 			break;
 		}
@@ -7856,6 +7855,29 @@ static int cmd_analysis_all(RzCore *core, const char *input) {
 	case 'i': // "aai"
 		rz_core_analysis_info(core, input + 1);
 		break;
+	case 'C': { // "aaC"
+		RzCoreAnalysisCache *st = &core->analysis_cache;
+		ut64 lookups = st->hits + st->misses;
+		if (input[1] == 'j') { // "aaCj"
+			PJ *pj = pj_new();
+			if (!pj) {
+				break;
+			}
+			pj_o(pj);
+			pj_ks(pj, "dir", rz_config_get(core->config, "analysis.cache.dir"));
+			pj_kn(pj, "hits", st->hits);
+			pj_kn(pj, "misses", st->misses);
+			pj_kn(pj, "stores", st->stores);
+			pj_end(pj);
+			rz_cons_println(pj_string(pj));
+			pj_free(pj);
+		} else {
+			rz_cons_printf("dir: %s\n", rz_config_get(core->config, "analysis.cache.dir"));
+			rz_cons_printf("hits: %" PFMT64u "\nmisses: %" PFMT64u "\nstores: %" PFMT64u "\n", st->hits, st->misses, st->stores);
+			rz_cons_printf("hit rate: %.1f%%\n", lookups ? 100.0 * st->hits / lookups : 0.0);
+		}
+		break;
+	}
 	case 's': // "aas"
 		rz_core_cmd0(core, "af @@= `isq~[0]`");
 		rz_core_cmd0(core, "af @@f:entry*");
@@ -7896,6 +7918,7 @@ static int cmd_analysis_all(RzCore *core, const char *input) {
 			rz_cons_println("Usage: See aa? for more help");
 		} else {
 			char *dh_orig = NULL;
+			bool cache_store = false;
 			if (!strncmp(input, "aaaaa", 5)) {
 				eprintf("A rizin developer is coming to your place to manually analyze this program. Please wait for it\n");
 				if (rz_cons_is_interactive()) {
@@ -7904,6 +7927,9 @@ static int cmd_analysis_all(RzCore *core, const char *input) {
 				goto jacuzzi;
 			}
 			ut64 curseek = core->offset;
+			if (RZ_STR_ISNOTEMPTY(rz_config_get(core->config, "analysis.cache.dir"))) {
+				rz_core_analysis_cache_open(core, !*input ? "aa" : input[1] == 'a' ? "aaaa" : "aaa");
+			}
 			oldstr = rz_print_rowlog(core->print, "Analyze all flags starting with sym. and entry0 (aa)");
 			rz_cons_break_push(NULL, NULL);
 			rz_cons_break_timeout(rz_config_get_i(core->config, "analysis.timeout"));
@@ -7930,7 +7956,10 @@ static int cmd_analysis_all(RzCore *core, const char *input) {
 				}
 			}
 			rz_core_seek(core, curseek, true);
+			// never cache the results of an interrupted analysis
+			cache_store = !rz_cons_is_breaked();
 		jacuzzi:
+			rz_core_analysis_cache_close(core, cache_store);
 			// XXX this shouldnt be called. flags muts be created wheen the function is registered
 			rz_core_analysis_flag_every_function(core);
 			rz_cons_break_pop();
@@ -8948,12 +8977,11 @@ RZ_IPI int rz_cmd_analysis(void *data, const char *input) {
 
 RZ_IPI RzCmdStatus rz_analysis_function_blocks_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
 	ut64 addr = argc > 1 ? rz_num_math(core->num, argv[1]) : core->offset;
-	RzList *l = rz_analysis_get_functions_in(core->analysis, addr);
-	if (rz_list_empty(l)) {
+	RzAnalysisFunction *fcn = rz_analysis_first_function_in(core->analysis, addr);
+	if (!fcn) {
 		eprintf("No functions at 0x%" PFMT64x, addr);
 		return RZ_CMD_STATUS_ERROR;
 	}
-	RzAnalysisFunction *fcn = rz_list_first(l);
 	rz_core_analysis_bbs_info_print(core, fcn, state);
 	return RZ_CMD_STATUS_OK;
 }
@@ -8998,24 +9026,22 @@ RZ_IPI RzCmdStatus rz_analysis_function_blocks_edge_handler(RzCore *core, int ar
 
 RZ_IPI RzCmdStatus rz_analysis_function_returns_handler(RzCore *core, int argc, const char **argv) {
 	ut64 addr = argc > 1 ? rz_num_math(core->num, argv[1]) : core->offset;
-	RzList *l = rz_analysis_get_functions_in(core->analysis, addr);
-	if (rz_list_empty(l)) {
+	RzAnalysisFunction *fcn = rz_analysis_first_function_in(core->analysis, addr);
+	if (!fcn) {
 		eprintf("No functions at 0x%" PFMT64x, addr);
 		return RZ_CMD_STATUS_ERROR;
 	}
-	RzAnalysisFunction *fcn = rz_list_first(l);
 	rz_core_analysis_fcn_returns(core, fcn);
 	return RZ_CMD_STATUS_OK;
 }
 
 RZ_IPI RzCmdStatus rz_analysis_function_blocks_asciiart_handler(RzCore *core, int argc, const char **argv) {
 	ut64 addr = argc > 1 ? rz_num_math(core->num, argv[1]) : core->offset;
-	RzList *l = rz_analysis_get_functions_in(core->analysis, addr);
-	if (rz_list_empty(l)) {
+	RzAnalysisFunction *fcn = rz_analysis_first_function_in(core->analysis, addr);
+	if (!fcn) {
 		eprintf("No functions at 0x%" PFMT64x, addr);
 		return RZ_CMD_STATUS_ERROR;
 	}
-	RzAnalysisFunction *fcn = rz_list_first(l);
 	rz_core_analysis_bbs_asciiart(core, fcn);
 	return RZ_CMD_STATUS_OK;
 }
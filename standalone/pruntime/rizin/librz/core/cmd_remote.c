@@ -43,6 +43,7 @@ static const char *help_msg_equalh[] = {
 	"Rh--", "", "stop foreground webserver",
 	"Rh*", "", "restart current webserver",
 	"Rh&", " port", "start http server in background",
+	"Rhb", " [requests] [conns] [path]", "load test the http server listening on http.port",
 	"RH", " port", "launch browser and listen for http",
 	"RH&", " port", "launch browser and listen for http in background",
 	NULL
@@ -79,6 +80,8 @@ RZ_IPI int rz_equal_h_handler_old(void *data, const char *input) {
 	RzCore *core = (RzCore *)data;
 	if (input[0] == '?') {
 		rz_core_cmd_help(core, help_msg_equalh);
+	} else if (input[0] == 'b') {
+		rz_core_rtr_http_bench(core, rz_str_trim_head_ro(input + 1));
 	} else {
 		rz_core_rtr_http(core, getArg(input[0], 'h'), 'h', input);
 	}
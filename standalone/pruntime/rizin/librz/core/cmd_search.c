@@ -172,74 +172,560 @@ struct endlist_pair {
 	int delay_size;
 };
 
-static int search_hash(RzCore *core, const char *hashname, const char *hashstr, ut32 minlen, ut32 maxlen, struct search_parameters *param) {
-	RzIOMap *map;
-	ut8 *buf;
-	int i, j;
-	RzListIter *iter;
+/*
+ * Instruction decoded at some offset of the range searched for gadgets.
+ * Every instruction leads to the one at offset + size, so the decoded
+ * instructions form a trie of gadget suffixes rooted at the end gadgets and
+ * the candidates that fall into the same suffix share its instructions.
+ */
+typedef struct {
+	int size; ///< size of the instruction, negative if it could not be decoded
+	bool end; ///< unconditional end of a gadget
+	bool nop;
+	char *mnemonic;
+} RopInsn;
+
+/* Checksums of a window that can be slid by one byte in constant time */
+typedef struct {
+	ut32 low, high;
+} HashWindow;
+
+typedef struct {
+	const char *name;
+	void (*init)(HashWindow *w, const ut8 *buf, ut32 len);
+	void (*roll)(HashWindow *w, ut8 out, ut8 in, ut32 len);
+	ut32 (*digest)(HashWindow *w, ut8 *digest); ///< same bytes as the msg digest plugin, returns the size
+} HashRoller;
+
+static inline ut8 byte_parity(ut8 x) {
+	x ^= x >> 4;
+	x ^= x >> 2;
+	x ^= x >> 1;
+	return x & 1;
+}
 
-	if (!minlen || minlen == UT32_MAX) {
-		minlen = core->blocksize;
+static void xor8_init(HashWindow *w, const ut8 *buf, ut32 len) {
+	w->low = 0;
+	for (ut32 i = 0; i < len; i++) {
+		w->low ^= buf[i];
 	}
-	if (!maxlen || maxlen == UT32_MAX) {
-		maxlen = minlen;
+}
+
+static void xor8_roll(HashWindow *w, ut8 out, ut8 in, ut32 len) {
+	w->low ^= out ^ in;
+}
+
+static ut32 xor8_digest(HashWindow *w, ut8 *digest) {
+	digest[0] = w->low;
+	return 1;
+}
+
+static void parity_init(HashWindow *w, const ut8 *buf, ut32 len) {
+	w->low = 0;
+	for (ut32 i = 0; i < len; i++) {
+		w->low ^= byte_parity(buf[i]);
 	}
+}
 
-	rz_cons_break_push(NULL, NULL);
-	for (j = minlen; j <= maxlen; j++) {
-		ut32 len = j;
-		eprintf("Searching %s for %d byte length.\n", hashname, j);
-		rz_list_foreach (param->boundaries, iter, map) {
-			if (rz_cons_is_breaked()) {
-				break;
+static void parity_roll(HashWindow *w, ut8 out, ut8 in, ut32 len) {
+	w->low ^= byte_parity(out) ^ byte_parity(in);
+}
+
+static void mod255_init(HashWindow *w, const ut8 *buf, ut32 len) {
+	ut8 sum = 0;
+	for (ut32 i = 0; i < len; i++) {
+		sum += buf[i];
+	}
+	w->low = sum;
+}
+
+static void mod255_roll(HashWindow *w, ut8 out, ut8 in, ut32 len) {
+	w->low = (ut8)(w->low - out + in);
+}
+
+static ut32 mod255_digest(HashWindow *w, ut8 *digest) {
+	digest[0] = w->low % 255;
+	return 1;
+}
+
+#define ADLER32_MOD 65521
+
+static void adler32_init(HashWindow *w, const ut8 *buf, ut32 len) {
+	w->low = 1;
+	w->high = 0;
+	for (ut32 i = 0; i < len; i++) {
+		w->low = (w->low + buf[i]) % ADLER32_MOD;
+		w->high = (w->high + w->low) % ADLER32_MOD;
+	}
+}
+
+static void adler32_roll(HashWindow *w, ut8 out, ut8 in, ut32 len) {
+	// high is len + sum((len - i) * buf[i]), so the byte leaving counts len times
+	w->low = (w->low + ADLER32_MOD - out + in) % ADLER32_MOD;
+	ut64 high = (ut64)w->high + ADLER32_MOD - ((ut64)(len % ADLER32_MOD) * out) % ADLER32_MOD + w->low + ADLER32_MOD - 1;
+	w->high = high % ADLER32_MOD;
+}
+
+static ut32 adler32_digest(HashWindow *w, ut8 *digest) {
+	rz_write_le32(digest, w->high << 16 | w->low);
+	return 4;
+}
+
+static void fletcher16_init(HashWindow *w, const ut8 *buf, ut32 len) {
+	w->low = 0;
+	w->high = 0;
+	for (ut32 i = 0; i < len; i++) {
+		w->low = (w->low + buf[i]) % 0xff;
+		w->high = (w->high + w->low) % 0xff;
+	}
+}
+
+static void fletcher16_roll(HashWindow *w, ut8 out, ut8 in, ut32 len) {
+	w->low = (w->low + 0xff - out + in) % 0xff;
+	w->high = (w->high + 0xff - ((len % 0xff) * out) % 0xff + w->low) % 0xff;
+}
+
+static ut32 fletcher16_digest(HashWindow *w, ut8 *digest) {
+	rz_write_le16(digest, w->high << 8 | w->low);
+	return 2;
+}
+
+static const HashRoller hash_rollers[] = {
+	{ "xor8", xor8_init, xor8_roll, xor8_digest },
+	{ "parity", parity_init, parity_roll, xor8_digest },
+	{ "mod255", mod255_init, mod255_roll, mod255_digest },
+	{ "adler32", adler32_init, adler32_roll, adler32_digest },
+	{ "fletcher16", fletcher16_init, fletcher16_roll, fletcher16_digest },
+};
+
+static const HashRoller *hash_roller(const char *name) {
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(hash_rollers); i++) {
+		if (!strcmp(hash_rollers[i].name, name)) {
+			return &hash_rollers[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+ * CRCs are affine over GF(2): the digest of a window is a linear function of
+ * its bytes xored with the digest of as many zero bytes. Sliding a window of
+ * len bytes by one is then
+ *
+ *   digest' = alpha(digest ^ zeros(len) ^ out(len, first)) ^ in(last) ^ zeros(len)
+ *
+ * where alpha is the effect of appending a zero byte, in(b) the difference
+ * made by a last byte b and out(len, b) the one made by a first byte b. They
+ * are all worked out from the digests of short messages, so every crc
+ * plugin can be rolled without knowing its parameters.
+ */
+typedef struct {
+	RzMsgDigest *md;
+	const char *name;
+	ut32 size; ///< size of the digest, at most 8 bytes
+	ut64 alpha[8][256]; ///< alpha of each byte of a digest
+	ut64 in[256];
+	ut8 *zeros; ///< zero bytes, as many as the longest window
+} HashLinear;
+
+typedef struct {
+	ut64 digest;
+	ut64 zeros; ///< digest of len zero bytes
+	ut64 out[8]; ///< out(len, b) of every bit of b
+} HashLinearWindow;
+
+static ut64 hash_linear_digest(HashLinear *h, const ut8 *buf, ut64 len) {
+	ut8 digest[8] = { 0 };
+	RzMsgDigestSize size = 0;
+	rz_msg_digest_init(h->md);
+	rz_msg_digest_update(h->md, buf, len);
+	rz_msg_digest_final(h->md);
+	const ut8 *r = rz_msg_digest_get_result(h->md, h->name, &size);
+	if (r) {
+		memcpy(digest, r, RZ_MIN(size, sizeof(digest)));
+	}
+	return rz_read_le64(digest);
+}
+
+// digest of a window of len bytes starting with b and followed by zeros
+static ut64 hash_linear_first(HashLinear *h, ut8 b, ut64 len) {
+	h->zeros[0] = b;
+	ut64 r = hash_linear_digest(h, h->zeros, len);
+	h->zeros[0] = 0;
+	return r;
+}
+
+static inline ut64 hash_linear_alpha(HashLinear *h, ut64 x) {
+	ut64 r = 0;
+	for (ut32 i = 0; i < h->size; i++) {
+		r ^= h->alpha[i][(x >> (i * 8)) & 0xff];
+	}
+	return r;
+}
+
+static void hash_linear_window_init(HashLinear *h, HashLinearWindow *w, const ut8 *buf, ut32 len) {
+	w->digest = hash_linear_digest(h, buf, len);
+	w->zeros = hash_linear_digest(h, h->zeros, len);
+	for (ut32 i = 0; i < 8; i++) {
+		w->out[i] = hash_linear_first(h, 1 << i, len) ^ w->zeros;
+	}
+}
+
+static inline void hash_linear_roll(HashLinear *h, HashLinearWindow *w, ut8 out, ut8 in) {
+	ut64 x = w->digest ^ w->zeros;
+	for (ut32 i = 0; i < 8; i++) {
+		if (out & (1 << i)) {
+			x ^= w->out[i];
+		}
+	}
+	w->digest = hash_linear_alpha(h, x) ^ h->in[in] ^ w->zeros;
+}
+
+static void hash_linear_fini(HashLinear *h) {
+	rz_msg_digest_free(h->md);
+	free(h->zeros);
+}
+
+/*
+ * Work out alpha, in and out for the algorithm name, and check that rolling
+ * gives the digests computed from scratch. Returns false if the algorithm
+ * cannot be rolled.
+ */
+static bool hash_linear_init(HashLinear *h, const char *name, ut32 maxlen) {
+	memset(h, 0, sizeof(*h));
+	h->name = name;
+	h->md = rz_msg_digest_new_with_algo2(name);
+	h->zeros = calloc(RZ_MAX(maxlen, 16) + 1, 1);
+	if (!h->md || !h->zeros) {
+		goto fail;
+	}
+	h->size = rz_msg_digest_size(h->md, name);
+	if (!h->size || h->size > 8) {
+		goto fail;
+	}
+	// pairs (u, alpha(u)) from single bits followed by zeros, reduced so
+	// that every row has a pivot bit that is clear in the other rows
+	ut64 u[64], v[64];
+	ut32 rows = 0;
+	for (ut32 bit = 0; bit < 8; bit++) {
+		for (ut32 zeros = 0; zeros < 8; zeros++) {
+			ut64 x = hash_linear_first(h, 1 << bit, zeros + 1) ^ hash_linear_digest(h, h->zeros, zeros + 1);
+			ut64 y = hash_linear_first(h, 1 << bit, zeros + 2) ^ hash_linear_digest(h, h->zeros, zeros + 2);
+			for (ut32 r = 0; r < rows; r++) {
+				if (x & (u[r] & -u[r])) {
+					x ^= u[r];
+					y ^= v[r];
+				}
 			}
-			ut64 from = map->itv.addr, to = rz_itv_end(map->itv);
-			st64 bufsz;
-			bufsz = to - from;
-			if (len > bufsz) {
-				eprintf("Hash length is bigger than range 0x%" PFMT64x "\n", from);
+			if (!x) {
 				continue;
 			}
-			buf = malloc(bufsz);
-			if (!buf) {
-				eprintf("Cannot allocate %" PFMT64d " bytes\n", bufsz);
-				goto fail;
-			}
-			eprintf("Search in range 0x%08" PFMT64x " and 0x%08" PFMT64x "\n", from, to);
-			int blocks = (int)(to - from - len);
-			eprintf("Carving %d blocks...\n", blocks);
-			(void)rz_io_read_at(core->io, from, buf, bufsz);
-			for (i = 0; (from + i + len) < to; i++) {
-				if (rz_cons_is_breaked()) {
-					break;
+			ut64 pivot = x & -x;
+			for (ut32 r = 0; r < rows; r++) {
+				if (u[r] & pivot) {
+					u[r] ^= x;
+					v[r] ^= y;
 				}
-				char *s = rz_msg_digest_calculate_small_block_string(hashname, buf + i, len, NULL, false);
-				if (!s) {
-					eprintf("Hash fail\n");
-					break;
+			}
+			u[rows] = x;
+			v[rows++] = y;
+		}
+	}
+	// a digest d of the span is the xor of the rows whose pivot is set in d
+	for (ut32 i = 0; i < h->size; i++) {
+		for (ut32 b = 0; b < 256; b++) {
+			ut64 x = (ut64)b << (i * 8);
+			ut64 r = 0;
+			for (ut32 k = 0; k < rows; k++) {
+				if (x & u[k] & -u[k]) {
+					r ^= v[k];
 				}
-				if (!(i % 5)) {
-					eprintf("%d\r", i);
+			}
+			h->alpha[i][b] = r;
+		}
+	}
+	ut64 zero = hash_linear_digest(h, h->zeros, 1);
+	for (ut32 b = 0; b < 256; b++) {
+		h->in[b] = hash_linear_first(h, b, 1) ^ zero;
+	}
+	// not affine after all if rolling does not give the same digests
+	static const ut8 probe[] = "\x5a\x01\xc3\x77\xfe\x10\x99\x42\x0d\xe8\x3b\x64\xa7";
+	const ut32 len = sizeof(probe) - 2;
+	HashLinearWindow w;
+	hash_linear_window_init(h, &w, probe, len);
+	hash_linear_roll(h, &w, probe[0], probe[len]);
+	if (w.digest != hash_linear_digest(h, probe + 1, len)) {
+		goto fail;
+	}
+	return true;
+fail:
+	hash_linear_fini(h);
+	return false;
+}
+
+typedef struct {
+	const char *hashname;
+	const char *hashstr;
+	const ut8 *target; ///< decoded hashstr, NULL when the digest is not printed in hex
+	ut32 target_size;
+	const ut8 *buf;
+	ut64 size;
+	ut32 minlen, maxlen;
+	RzThreadLock *lock;
+	ut64 hit; ///< lowest offset found so far, UT64_MAX if none
+	ut32 hit_len;
+	bool stop;
+} HashCarve;
+
+typedef struct {
+	HashCarve *carve;
+	ut64 from, to;
+	bool main; ///< the slice scanned by the main thread, which polls for ^C
+} HashCarveSlice;
+
+static void hash_carve_found(HashCarve *c, ut64 off, ut32 len) {
+	rz_th_lock_enter(c->lock);
+	if (off < c->hit) {
+		c->hit = off;
+		c->hit_len = len;
+	}
+	rz_th_lock_leave(c->lock);
+}
+
+// true when a hit has been found before off or the search was interrupted
+static bool hash_carve_done(HashCarve *c, ut64 off) {
+	rz_th_lock_enter(c->lock);
+	bool r = c->stop || c->hit <= off;
+	rz_th_lock_leave(c->lock);
+	return r;
+}
+
+static bool hash_carve_match(HashCarve *c, RzMsgDigest *md) {
+	if (c->target) {
+		ut32 size = 0;
+		const ut8 *digest = rz_msg_digest_get_result(md, c->hashname, &size);
+		return digest && size == c->target_size && !memcmp(digest, c->target, size);
+	}
+	char *s = rz_msg_digest_get_result_string(md, c->hashname, NULL, false);
+	bool r = s && !strcmp(s, c->hashstr);
+	free(s);
+	return r;
+}
+
+static void hash_carve_slice(HashCarveSlice *slice) {
+	HashCarve *c = slice->carve;
+	RzMsgDigest *md = rz_msg_digest_new_with_algo2(c->hashname);
+	if (!md) {
+		return;
+	}
+	for (ut64 i = slice->from; i < slice->to; i++) {
+		if (!(i & 0xff)) {
+			if (slice->main && rz_cons_is_breaked()) {
+				rz_th_lock_enter(c->lock);
+				c->stop = true;
+				rz_th_lock_leave(c->lock);
+			}
+			if (hash_carve_done(c, i)) {
+				break;
+			}
+		}
+		// all the lengths at an offset come before the next offset, so the first hit is the lowest one
+		for (ut32 len = c->minlen; len <= c->maxlen && len <= c->size - i; len++) {
+			// a new digest is already initialized
+			rz_msg_digest_update(md, c->buf + i, len);
+			rz_msg_digest_final(md);
+			if (hash_carve_match(c, md)) {
+				hash_carve_found(c, i, len);
+				goto end;
+			}
+			rz_msg_digest_init(md);
+		}
+	}
+end:
+	rz_msg_digest_free(md);
+}
+
+static void hash_carve_slice_cb(void *user, size_t i) {
+	hash_carve_slice((HashCarveSlice *)user + i);
+}
+
+static bool hash_carve_roll_match(HashCarve *c, ut64 off, ut32 len, const ut8 *digest, ut32 size) {
+	if (size != c->target_size || memcmp(digest, c->target, size)) {
+		return false;
+	}
+	c->hit = off;
+	c->hit_len = len;
+	return true;
+}
+
+/*
+ * Slide one window per length over c->buf in a single pass. All the lengths
+ * at an offset come before the next offset, so the first hit is the lowest
+ * one.
+ */
+static void hash_carve_roll(HashCarve *c, const HashRoller *roller, HashLinear *linear) {
+	ut32 maxlen = RZ_MIN(c->maxlen, c->size);
+	if (c->minlen > maxlen) {
+		return;
+	}
+	ut32 n = maxlen - c->minlen + 1;
+	HashWindow *w = roller ? RZ_NEWS(HashWindow, n) : NULL;
+	HashLinearWindow *lw = linear ? RZ_NEWS(HashLinearWindow, n) : NULL;
+	if (!w && !lw) {
+		return;
+	}
+	ut8 digest[8];
+	for (ut32 k = 0; k < n; k++) {
+		if (w) {
+			roller->init(&w[k], c->buf, c->minlen + k);
+		} else {
+			hash_linear_window_init(linear, &lw[k], c->buf, c->minlen + k);
+		}
+	}
+	for (ut64 i = 0; i + c->minlen <= c->size; i++) {
+		if (!(i & 0xffff) && rz_cons_is_breaked()) {
+			c->stop = true;
+			break;
+		}
+		for (ut32 k = 0; k < n && i + c->minlen + k <= c->size; k++) {
+			ut32 len = c->minlen + k;
+			ut32 size;
+			if (w) {
+				if (i) {
+					roller->roll(&w[k], c->buf[i - 1], c->buf[i + len - 1], len);
 				}
-				// eprintf ("0x%08"PFMT64x" %s\n", from+i, s);
-				if (!strcmp(s, hashstr)) {
-					eprintf("Found at 0x%" PFMT64x "\n", from + i);
-					rz_cons_printf("f hash.%s.%s = 0x%" PFMT64x "\n",
-						hashname, hashstr, from + i);
-					free(s);
-					free(buf);
-					return 1;
+				size = roller->digest(&w[k], digest);
+			} else {
+				if (i) {
+					hash_linear_roll(linear, &lw[k], c->buf[i - 1], c->buf[i + len - 1]);
 				}
-				free(s);
+				rz_write_le64(digest, lw[k].digest);
+				size = linear->size;
 			}
-			free(buf);
+			if (hash_carve_roll_match(c, i, len, digest, size)) {
+				goto beach;
+			}
+		}
+	}
+beach:
+	free(w);
+	free(lw);
+}
+
+// Scan the window starts of c->buf with as many threads as there are cores
+static void hash_carve(HashCarve *c) {
+	ut64 offsets = c->size - c->minlen + 1;
+	size_t i, n = RZ_MIN(rz_th_logical_core_number(), offsets / 0x1000 + 1);
+	HashCarveSlice *slices = RZ_NEWS0(HashCarveSlice, n);
+	if (!slices) {
+		HashCarveSlice single = { .carve = c, .to = offsets, .main = true };
+		hash_carve_slice(&single);
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		slices[i].carve = c;
+		slices[i].from = offsets * i / n;
+		slices[i].to = offsets * (i + 1) / n;
+		slices[i].main = !i;
+	}
+	rz_th_parallel_for(n, hash_carve_slice_cb, slices);
+	free(slices);
+}
+
+static int search_hash(RzCore *core, const char *hashname, const char *hashstr, ut32 minlen, ut32 maxlen, struct search_parameters *param) {
+	RzIOMap *map;
+	RzListIter *iter;
+	int r = 0;
+
+	if (!minlen || minlen == UT32_MAX) {
+		minlen = core->blocksize;
+	}
+	if (!maxlen || maxlen == UT32_MAX) {
+		maxlen = minlen;
+	}
+	RzMsgDigest *md = rz_msg_digest_new_with_algo2(hashname);
+	if (!md) {
+		eprintf("Hash fail\n");
+		return 0;
+	}
+	rz_msg_digest_free(md);
+
+	HashCarve c = { 0 };
+	c.hashname = hashname;
+	c.hashstr = hashstr;
+	c.minlen = minlen;
+	c.maxlen = maxlen;
+	size_t hexlen = strlen(hashstr);
+	ut8 *target = malloc(hexlen / 2 + 1);
+	if (!target) {
+		return 0;
+	}
+	if (strncmp(hashname, "entropy", 7) && hexlen && !(hexlen & 1) && rz_hex_str2bin(hashstr, target) == hexlen / 2) {
+		c.target = target;
+		c.target_size = hexlen / 2;
+	}
+	const HashRoller *roller = c.target ? hash_roller(hashname) : NULL;
+	HashLinear linear_ctx;
+	HashLinear *linear = NULL;
+	if (c.target && !roller && rz_str_startswith(hashname, "crc") && hash_linear_init(&linear_ctx, hashname, maxlen)) {
+		linear = &linear_ctx;
+	}
+	c.lock = roller || linear ? NULL : rz_th_lock_new(false);
+	if (!roller && !linear && !c.lock) {
+		free(target);
+		return 0;
+	}
+
+	rz_cons_break_push(NULL, NULL);
+	eprintf("Searching %s for %u to %u byte length.\n", hashname, minlen, maxlen);
+	rz_list_foreach (param->boundaries, iter, map) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		ut64 from = map->itv.addr, to = rz_itv_end(map->itv);
+		ut64 bufsz = to - from;
+		if (minlen > bufsz) {
+			eprintf("Hash length is bigger than range 0x%" PFMT64x "\n", from);
+			continue;
+		}
+		ut8 *buf = malloc(bufsz);
+		if (!buf) {
+			eprintf("Cannot allocate %" PFMT64d " bytes\n", bufsz);
+			r = -1;
+			break;
+		}
+		eprintf("Search in range 0x%08" PFMT64x " and 0x%08" PFMT64x "\n", from, to);
+		(void)rz_io_read_at(core->io, from, buf, bufsz);
+		c.buf = buf;
+		c.size = bufsz;
+		c.hit = UT64_MAX;
+		if (roller || linear) {
+			hash_carve_roll(&c, roller, linear);
+		} else {
+			hash_carve(&c);
+		}
+		free(buf);
+		if (c.hit != UT64_MAX) {
+			eprintf("Found at 0x%" PFMT64x " (%u bytes)\n", from + c.hit, c.hit_len);
+			rz_cons_printf("f hash.%s.%s = 0x%" PFMT64x "\n",
+				hashname, hashstr, from + c.hit);
+			r = 1;
+			break;
+		}
+		if (c.stop) {
+			break;
 		}
 	}
 	rz_cons_break_pop();
-	eprintf("No hashes found\n");
-	return 0;
-fail:
-	return -1;
+	rz_th_lock_free(c.lock);
+	if (linear) {
+		hash_linear_fini(linear);
+	}
+	free(target);
+	if (!r && !c.stop) {
+		eprintf("No hashes found\n");
+	}
+	return r;
 }
 
 static void cmd_search_bin(RzCore *core, RzInterval itv) {
@@ -301,7 +787,7 @@ RZ_API int rz_core_search_prelude(RzCore *core, ut64 from, ut64 to, const ut8 *b
 		free(b);
 		return 0;
 	}
-	rz_search_reset(core->search, RZ_SEARCH_KEYWORD);
+	rz_search_reset(core->search, RZ_SEARCH_MULTI);
 	rz_search_kw_add(core->search, rz_search_keyword_new(buf, blen, mask, mlen, NULL));
 	rz_search_begin(core->search);
 	rz_search_set_callback(core->search, &__prelude_cb_hit, core);
@@ -331,12 +817,123 @@ static int count_functions(RzCore *core) {
 	return rz_list_length(core->analysis->fcns);
 }
 
+// bytes of a boundary read and scanned for preludes at once
+#define PRELUDE_WINDOW 0x4000000
+
+typedef struct {
+	const RzList /*<RzSearchKeyword>*/ *kws; ///< shared by all the slices, each one searches with its own copy
+	int kw_max; ///< length of the longest keyword
+	bool overlap;
+	int contiguous; ///< search.contiguous
+	int align; ///< search.align
+	const ut8 *buf;
+	ut64 addr; ///< address of buf
+	ut64 size;
+	ut64 from, to; ///< offsets in buf where the hits of this slice start
+	bool main; ///< the slice scanned by the main thread, which polls for ^C
+	RzVector /*<PreludeHit>*/ hits;
+} PreludeSlice;
+
+typedef struct {
+	ut64 addr;
+	int kw; ///< index of the keyword in PreludeSlice.kws
+} PreludeHit;
+
+static void prelude_slice_scan(PreludeSlice *slice) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_MULTI);
+	if (!s) {
+		return;
+	}
+	s->overlap = slice->overlap;
+	s->contiguous = slice->contiguous;
+	s->align = slice->align;
+	RzListIter *it;
+	RzSearchKeyword *kw;
+	rz_list_foreach (slice->kws, it, kw) {
+		rz_search_kw_add(s, rz_search_keyword_new(kw->bin_keyword, kw->keyword_length, kw->bin_binmask, kw->binmask_length, NULL));
+	}
+	rz_search_begin(s);
+	// the matches starting before slice->to may end past it
+	ut64 end = RZ_MIN(slice->to + slice->kw_max - 1, slice->size);
+	ut64 at;
+	for (at = slice->from; at < end; at += 0x100000) {
+		if (slice->main && rz_cons_is_breaked()) {
+			break;
+		}
+		int len = (int)RZ_MIN(0x100000, end - at);
+		if (rz_search_update(s, slice->addr + at, slice->buf + at, len) == -1) {
+			break;
+		}
+	}
+	RzSearchHit *hit;
+	rz_list_foreach (s->hits, it, hit) {
+		if (hit->addr < slice->addr + slice->to) {
+			PreludeHit ph = { hit->addr, hit->kw->kwidx };
+			rz_vector_push(&slice->hits, &ph);
+		}
+	}
+	rz_search_free(s);
+}
+
+static void prelude_slice_scan_cb(void *user, size_t i) {
+	prelude_slice_scan((PreludeSlice *)user + i);
+}
+
+// Find the preludes starting in the first starts bytes of buf with as many threads as there are cores
+static void prelude_scan(PreludeSlice *tpl, ut64 starts, RzVector /*<PreludeHit>*/ *hits) {
+	size_t i, n = RZ_MIN(rz_th_logical_core_number(), starts / 0x10000 + 1);
+	PreludeSlice *slices = RZ_NEWS0(PreludeSlice, n);
+	if (!slices) {
+		n = 1;
+		slices = tpl;
+	}
+	for (i = 0; i < n; i++) {
+		slices[i] = *tpl;
+		slices[i].from = starts * i / n;
+		slices[i].to = starts * (i + 1) / n;
+		slices[i].main = !i;
+		rz_vector_init(&slices[i].hits, sizeof(PreludeHit), NULL, NULL);
+	}
+	rz_th_parallel_for(n, prelude_slice_scan_cb, slices);
+	for (i = 0; i < n; i++) {
+		PreludeHit *hit;
+		rz_vector_foreach(&slices[i].hits, hit) {
+			rz_vector_push(hits, hit);
+		}
+		rz_vector_fini(&slices[i].hits);
+	}
+	if (slices != tpl) {
+		free(slices);
+	}
+}
+
+static int cmp_prelude_hit(const void *a, const void *b) {
+	const PreludeHit *ha = a, *hb = b;
+	if (ha->addr != hb->addr) {
+		return ha->addr < hb->addr ? -1 : 1;
+	}
+	return ha->kw - hb->kw;
+}
+
+static int cmp_ut64(const void *a, const void *b) {
+	ut64 va = *(const ut64 *)a, vb = *(const ut64 *)b;
+	return va < vb ? -1 : va > vb;
+}
+
+/**
+ * \brief Analyze functions at the preludes found in the executable boundaries
+ *
+ * All the preludes of the arch (or analysis.prelude) are searched at once,
+ * the boundaries being split across threads, and the functions are
+ * analyzed afterwards in address order. As before, search.maxhits caps
+ * the hits of each prelude in each boundary.
+ *
+ * \return the number of preludes found, -1 on error
+ */
 RZ_API int rz_core_search_preludes(RzCore *core, bool log) {
-	int ret = -1;
 	const char *prelude = rz_config_get(core->config, "analysis.prelude");
-	ut64 from = UT64_MAX;
-	ut64 to = UT64_MAX;
 	const char *where = rz_config_get(core->config, "analysis.in");
+	const int depth = rz_config_get_i(core->config, "analysis.depth");
 
 	RzList *list = rz_core_get_boundaries_prot(core, RZ_PERM_X, where, "search");
 	RzListIter *iter;
@@ -346,7 +943,57 @@ RZ_API int rz_core_search_preludes(RzCore *core, bool log) {
 		return -1;
 	}
 
+	RzList *kws = NULL;
+	if (prelude && *prelude) {
+		ut8 *kw = malloc(strlen(prelude) + 1);
+		kws = rz_list_newf((RzListFree)rz_search_keyword_free);
+		if (kw && kws) {
+			int kwlen = rz_hex_str2bin(prelude, kw);
+			rz_list_append(kws, rz_search_keyword_new(kw, kwlen, NULL, 0, NULL));
+		}
+		free(kw);
+	} else {
+		kws = rz_analysis_preludes(core->analysis);
+	}
+	if (rz_list_empty(kws)) {
+		if (log) {
+			eprintf("ap: Unsupported asm.arch and asm.bits\n");
+		}
+		rz_list_free(kws);
+		rz_list_free(list);
+		return -1;
+	}
+
+	PreludeSlice tpl = { 0 };
+	RzSearchKeyword *kw;
+	rz_list_foreach (kws, iter, kw) {
+		tpl.kw_max = RZ_MAX(tpl.kw_max, kw->keyword_length);
+	}
+	tpl.kws = kws;
+	tpl.overlap = core->search->overlap;
+	tpl.contiguous = core->search->contiguous;
+	tpl.align = core->search->align;
+	// as with one search per prelude and boundary, each one stops at search.maxhits
+	const ut64 maxhits = rz_config_get_i(core->config, "search.maxhits");
+	ut64 *counts = RZ_NEWS0(ut64, rz_list_length(kws));
+	ut64 window = 0;
+	rz_list_foreach (list, iter, p) {
+		window = RZ_MAX(window, RZ_MIN(PRELUDE_WINDOW, p->itv.size));
+	}
+	RzVector hits, map_hits;
+	rz_vector_init(&hits, sizeof(ut64), NULL, NULL);
+	rz_vector_init(&map_hits, sizeof(PreludeHit), NULL, NULL);
+	ut8 *buf = malloc(window + tpl.kw_max);
+	if (!buf || !counts) {
+		free(buf);
+		free(counts);
+		rz_list_free(kws);
+		rz_list_free(list);
+		return -1;
+	}
+
 	int fc0 = count_functions(core);
+	rz_cons_break_push(NULL, NULL);
 	rz_list_foreach (list, iter, p) {
 		if (log) {
 			eprintf("\r[>] Scanning %s 0x%" PFMT64x " - 0x%" PFMT64x " ",
@@ -356,43 +1003,61 @@ RZ_API int rz_core_search_preludes(RzCore *core, bool log) {
 				continue;
 			}
 		}
-		from = p->itv.addr;
-		to = rz_itv_end(p->itv);
-		if (prelude && *prelude) {
-			ut8 *kw = malloc(strlen(prelude) + 1);
-			int kwlen = rz_hex_str2bin(prelude, kw);
-			ret = rz_core_search_prelude(core, from, to, kw, kwlen, NULL, 0);
-			free(kw);
-		} else {
-			RzList *preds = rz_analysis_preludes(core->analysis);
-			if (preds) {
-				RzListIter *iter;
-				RzSearchKeyword *kw;
-				rz_list_foreach (preds, iter, kw) {
-					ret = rz_core_search_prelude(core, from, to,
-						kw->bin_keyword, kw->keyword_length,
-						kw->bin_binmask, kw->binmask_length);
-				}
-			} else {
-				if (log) {
-					eprintf("ap: Unsupported asm.arch and asm.bits\n");
-				}
+		ut64 from = p->itv.addr, to = rz_itv_end(p->itv);
+		ut64 at;
+		for (at = from; at < to && !rz_cons_is_breaked(); at += PRELUDE_WINDOW) {
+			ut64 starts = RZ_MIN(PRELUDE_WINDOW, to - at);
+			tpl.addr = at;
+			tpl.size = RZ_MIN(starts + tpl.kw_max - 1, to - at);
+			tpl.buf = buf;
+			(void)rz_io_read_at(core->io, at, buf, tpl.size);
+			prelude_scan(&tpl, starts, &map_hits);
+		}
+		qsort(map_hits.a, map_hits.len, sizeof(PreludeHit), cmp_prelude_hit);
+		memset(counts, 0, rz_list_length(kws) * sizeof(ut64));
+		PreludeHit *hit;
+		rz_vector_foreach(&map_hits, hit) {
+			if (!maxhits || counts[hit->kw]++ < maxhits) {
+				rz_vector_push(&hits, &hit->addr);
 			}
 		}
+		rz_vector_clear(&map_hits);
 		if (log) {
 			eprintf("done\n");
 		}
 	}
+
+	// the same address can start more than one prelude
+	qsort(hits.a, hits.len, sizeof(ut64), cmp_ut64);
+	ut64 *addr, last = UT64_MAX;
+	int found = 0;
+	rz_vector_foreach(&hits, addr) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		if (*addr == last) {
+			continue;
+		}
+		last = *addr;
+		rz_core_analysis_fcn(core, *addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth);
+		found++;
+	}
+	rz_cons_break_pop();
 	int fc1 = count_functions(core);
 	if (log) {
-		if (list) {
+		if (!rz_list_empty(list)) {
 			eprintf("Analyzed %d functions based on preludes\n", fc1 - fc0);
 		} else {
 			eprintf("No executable section found, cannot analyze anything. Use 'S' to change or define permissions of sections\n");
 		}
 	}
+	rz_vector_fini(&hits);
+	rz_vector_fini(&map_hits);
+	free(counts);
+	free(buf);
+	rz_list_free(kws);
 	rz_list_free(list);
-	return ret;
+	return found;
 }
 
 /* TODO: maybe move into util/str */
@@ -997,11 +1662,48 @@ static bool insert_into(void *user, const ut64 k, const ut64 v) {
 	return true;
 }
 
+static void rop_insn_free(HtUPKv *kv) {
+	RopInsn *insn = kv->value;
+	free(insn->mnemonic);
+	free(insn);
+}
+
+static RopInsn *rop_insn_at(RzCore *core, HtUP *insns, ut64 addr, ut8 *buf, int buflen, int idx) {
+	RopInsn *insn = ht_up_find(insns, idx, NULL);
+	if (insn) {
+		return insn;
+	}
+	insn = RZ_NEW0(RopInsn);
+	if (!insn) {
+		return NULL;
+	}
+	RzAnalysisOp aop = { 0 };
+	int error = rz_analysis_op(core->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
+	insn->size = error < 0 ? -1 : aop.size;
+	insn->end = is_end_gadget(&aop, 0);
+	insn->nop = aop.type == RZ_ANALYSIS_OP_TYPE_NOP;
+	insn->mnemonic = aop.mnemonic;
+	aop.mnemonic = NULL;
+	rz_analysis_op_fini(&aop);
+	if (insn->size >= 0 && !insn->mnemonic) {
+		RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", core->analysis->cur->name);
+		RzAsmOp asmop;
+		rz_asm_set_pc(core->rasm, addr);
+		if (rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
+			insn->size = -1;
+		} else {
+			insn->mnemonic = strdup(rz_asm_op_get_asm(&asmop));
+		}
+		rz_asm_op_fini(&asmop);
+	}
+	ht_up_insert(insns, idx, insn);
+	return insn;
+}
+
 // TODO: follow unconditional jumps
-static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RzList *rx_list, struct endlist_pair *end_gadget, HtUU *badstart) {
+static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RzList *rx_list, struct endlist_pair *end_gadget, HtUU *badstart, HtUP *insns) {
 	int endaddr = end_gadget->instr_offset;
 	int branch_delay = end_gadget->delay_size;
-	RzAnalysisOp aop = { 0 };
 	const char *start = NULL, *end = NULL;
 	char *grep_str = NULL;
 	RzCoreAsmHit *hit = NULL;
@@ -1041,26 +1743,14 @@ static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int bufle
 	while (nb_instr < max_instr) {
 		ht_uu_insert(localbadstart, idx, 1);
 
-		int error = rz_analysis_op(core->analysis, &aop, addr, buf + idx, buflen - idx, RZ_ANALYSIS_OP_MASK_DISASM);
-		if (error < 0 || (nb_instr == 0 && (is_end_gadget(&aop, 0) || aop.type == RZ_ANALYSIS_OP_TYPE_NOP))) {
+		RopInsn *insn = rop_insn_at(core, insns, addr, buf, buflen, idx);
+		if (!insn || insn->size < 0 || (nb_instr == 0 && (insn->end || insn->nop))) {
 			valid = false;
 			goto ret;
 		}
 
-		const int opsz = aop.size;
-		// opsz = rz_strbuf_length (asmop.buf);
-		char *opst = aop.mnemonic;
-		if (!opst) {
-			RZ_LOG_WARN("Analysis plugin %s did not return disassembly\n", core->analysis->cur->name);
-			RzAsmOp asmop;
-			rz_asm_set_pc(core->rasm, addr);
-			if (rz_asm_disassemble(core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
-				valid = false;
-				goto ret;
-			}
-			opst = strdup(rz_asm_op_get_asm(&asmop));
-			rz_asm_op_fini(&asmop);
-		}
+		const int opsz = insn->size;
+		const char *opst = insn->mnemonic;
 		if (!rz_str_ncasecmp(opst, "invalid", strlen("invalid")) ||
 			!rz_str_ncasecmp(opst, ".byte", strlen(".byte"))) {
 			valid = false;
@@ -1106,12 +1796,9 @@ static RzList *construct_rop_gadget(RzCore *core, ut64 addr, ut8 *buf, int bufle
 			valid = (endaddr == idx - opsz);
 			goto ret;
 		}
-		free(opst);
-		aop.mnemonic = NULL;
 		nb_instr++;
 	}
 ret:
-	free(aop.mnemonic);
 	free(grep_str);
 	if (regex && rx) {
 		rz_list_free(hitlist);
@@ -1133,6 +1820,190 @@ ret:
 	return hitlist;
 }
 
+/*
+ * Gadget database
+ *
+ * Next to the classification read by /Rk ("rop"), /R records the end gadgets
+ * found in every searched range ("rop_ends", keyed by the arch options and
+ * the hash of the range), and the bytes, disassembly and ESIL of every
+ * classified gadget ("rop_gadgets", "rop_disasm" and "rop_esil"). Later
+ * searches skip the scan of the ranges that did not change and the emulation
+ * of the gadgets that were already classified. When analysis.cache.dir is
+ * set, the database of the current file is kept there across sessions: it is
+ * merged in the first time it is needed and written back only when /R added
+ * something to it. The state of the file is kept in "rop_db".
+ */
+static const char *rop_db_namespaces[] = { "rop", "rop_ends", "rop_gadgets", "rop_disasm", "rop_esil" };
+
+// Path of the database of the current file, computed once per file and directory
+static const char *rop_db_path(RzCore *core) {
+	Sdb *state = sdb_ns(core->sdb, "rop_db", true);
+	const char *dir = rz_config_get(core->config, "analysis.cache.dir");
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	if (!state || RZ_STR_ISEMPTY(dir) || !bf) {
+		return NULL;
+	}
+	const char *path = sdb_const_get(state, "path", 0);
+	const char *path_dir = sdb_const_get(state, "dir", 0);
+	if (path && path_dir && !strcmp(path_dir, dir) && sdb_num_get(state, "file", 0) == bf->id) {
+		return path;
+	}
+	char *key = rz_core_analysis_cache_key(core);
+	char *name = key ? rz_str_newf("rop-%s", key) : NULL;
+	char *r = name ? rz_core_analysis_cache_path(core, name) : NULL;
+	free(key);
+	free(name);
+	if (!r) {
+		return NULL;
+	}
+	sdb_set_owned(state, "path", r, 0);
+	sdb_set(state, "dir", dir, 0);
+	sdb_num_set(state, "file", bf->id, 0);
+	sdb_unset(state, "loaded", 0);
+	return sdb_const_get(state, "path", 0);
+}
+
+static void rop_db_changed(RzCore *core) {
+	sdb_num_set(sdb_ns(core->sdb, "rop_db", true), "changed", 1, 0);
+}
+
+static void rop_db_load(RzCore *core) {
+	const char *path = rop_db_path(core);
+	Sdb *state = sdb_ns(core->sdb, "rop_db", false);
+	if (!path || sdb_num_get(state, "loaded", 0)) {
+		return;
+	}
+	sdb_num_set(state, "loaded", 1, 0);
+	if (!rz_file_exists(path)) {
+		return;
+	}
+	Sdb *db = sdb_new0();
+	if (db && sdb_text_load(db, path)) {
+		size_t i;
+		for (i = 0; i < RZ_ARRAY_SIZE(rop_db_namespaces); i++) {
+			Sdb *ns = sdb_ns(db, rop_db_namespaces[i], false);
+			if (ns) {
+				sdb_copy(ns, sdb_ns(core->sdb, rop_db_namespaces[i], true));
+			}
+		}
+	} else {
+		RZ_LOG_WARN("Cannot load the ROP gadget database at %s\n", path);
+	}
+	sdb_free(db);
+}
+
+static void rop_db_save(RzCore *core) {
+	const char *path = rop_db_path(core);
+	Sdb *state = sdb_ns(core->sdb, "rop_db", false);
+	if (!path || !sdb_num_get(state, "changed", 0)) {
+		return;
+	}
+	char *dir = rz_file_dirname(path);
+	if (!dir || !rz_sys_mkdirp(dir)) {
+		RZ_LOG_ERROR("Cannot create the analysis cache directory for %s\n", path);
+		free(dir);
+		return;
+	}
+	free(dir);
+	Sdb *db = sdb_new0();
+	if (!db) {
+		return;
+	}
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE(rop_db_namespaces); i++) {
+		Sdb *ns = sdb_ns(core->sdb, rop_db_namespaces[i], false);
+		if (ns) {
+			sdb_copy(ns, sdb_ns(db, rop_db_namespaces[i], true));
+		}
+	}
+	if (sdb_text_save(db, path, true)) {
+		sdb_unset(state, "changed", 0);
+	} else {
+		RZ_LOG_ERROR("Cannot write the ROP gadget database to %s\n", path);
+	}
+	sdb_free(db);
+}
+
+static char *rop_db_ends_key(RzCore *core, ut64 from, const ut8 *buf, int len, bool crop, int increment) {
+	return rz_str_newf("%s-%" PFMT64d "-%s-%d-%d-0x%" PFMT64x "-%d-%08x",
+		rz_config_get(core->config, "asm.arch"), rz_config_get_i(core->config, "asm.bits"),
+		rz_config_get(core->config, "asm.cpu"), crop, increment, from, len, rz_hash_xxhash(buf, len));
+}
+
+// Stored as the number of end gadgets followed by their offset:delay pairs
+static bool rop_db_get_ends(RzCore *core, const char *key, RzList *end_list) {
+	const char *s = sdb_const_get(sdb_ns(core->sdb, "rop_ends", true), key, 0);
+	if (!s) {
+		return false;
+	}
+	char *e;
+	long n = strtol(s, &e, 10);
+	for (; n > 0; n--) {
+		struct endlist_pair *epair = RZ_NEW0(struct endlist_pair);
+		if (!epair) {
+			break;
+		}
+		epair->instr_offset = (int)strtol(e, &e, 16);
+		if (*e != ':') {
+			free(epair);
+			break;
+		}
+		epair->delay_size = (int)strtol(e + 1, &e, 16);
+		rz_list_append(end_list, epair);
+	}
+	if (n > 0) {
+		rz_list_purge(end_list);
+		return false;
+	}
+	return true;
+}
+
+static void rop_db_set_ends(RzCore *core, const char *key, RzList *end_list) {
+	RzStrBuf sb;
+	rz_strbuf_initf(&sb, "%d", rz_list_length(end_list));
+	RzListIter *it;
+	struct endlist_pair *epair;
+	rz_list_foreach (end_list, it, epair) {
+		rz_strbuf_appendf(&sb, " %x:%x", epair->instr_offset, epair->delay_size);
+	}
+	sdb_set(sdb_ns(core->sdb, "rop_ends", true), key, rz_strbuf_get(&sb), 0);
+	rz_strbuf_fini(&sb);
+	rop_db_changed(core);
+}
+
+// Classify the gadget at \p addr unless it was already, with the same bytes
+static void rop_db_classify(RzCore *core, Sdb *db, RzList *ropList, const char *disasm, ut64 addr, unsigned int size) {
+	ut8 *bytes = malloc(size);
+	if (!bytes) {
+		return;
+	}
+	rz_io_read_at(core->io, addr, bytes, size);
+	char *hex = rz_hex_bin2strdup(bytes, size);
+	free(bytes);
+	if (!hex) {
+		return;
+	}
+	Sdb *gadgets = sdb_ns(core->sdb, "rop_gadgets", true);
+	char *key = rz_str_newf("0x%08" PFMT64x, addr);
+	const char *known = sdb_const_get(gadgets, key, 0);
+	if (!known || strcmp(known, hex)) {
+		SdbListIter *it;
+		SdbNs *ns;
+		ls_foreach (db->ns, it, ns) {
+			sdb_unset(ns->sdb, key, 0);
+		}
+		rop_classify(core, db, ropList, key, size);
+		sdb_set(gadgets, key, hex, 0);
+		sdb_set(sdb_ns(core->sdb, "rop_disasm", true), key, disasm, 0);
+		char *esil = rz_str_list_join(ropList, ";");
+		sdb_set(sdb_ns(core->sdb, "rop_esil", true), key, esil ? rz_str_trim_head_ro(esil) : "", 0);
+		free(esil);
+		rop_db_changed(core);
+	}
+	free(key);
+	free(hex);
+}
+
 static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 	const char *otype;
 	RzCoreAsmHit *hit = NULL;
@@ -1143,11 +2014,13 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 	RzAnalysisOp analop = RZ_EMPTY;
 	RzAsmOp asmop;
 	Sdb *db = NULL;
+	RzStrBuf disasm;
 	const bool colorize = rz_config_get_i(core->config, "scr.color");
 	const bool rop_comments = rz_config_get_i(core->config, "rop.comments");
 	const bool esil = rz_config_get_i(core->config, "asm.esil");
 	const bool rop_db = rz_config_get_i(core->config, "rop.db");
 
+	rz_strbuf_init(&disasm);
 	if (rop_db) {
 		db = sdb_ns(core->sdb, "rop", true);
 		ropList = rz_list_newf(free);
@@ -1170,6 +2043,7 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 			rz_io_read_at(core->io, hit->addr, buf, hit->len);
 			rz_asm_set_pc(core->rasm, hit->addr);
 			rz_asm_disassemble(core->rasm, &asmop, buf, hit->len);
+			rz_strbuf_appendf(&disasm, "%s%s", rz_strbuf_is_empty(&disasm) ? "" : "; ", rz_asm_op_get_asm(&asmop));
 			rz_analysis_op(core->analysis, &analop, hit->addr, buf, hit->len, RZ_ANALYSIS_OP_MASK_ESIL);
 			size += hit->len;
 			if (analop.type != RZ_ANALYSIS_OP_TYPE_RET) {
@@ -1187,9 +2061,7 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 		pj_end(pj);
 		if (db && hit) {
 			const ut64 addr = ((RzCoreAsmHit *)hitlist->head->data)->addr;
-			// rz_cons_printf ("Gadget size: %d\n", (int)size);
-			const char *key = sdb_fmt("0x%08" PFMT64x, addr);
-			rop_classify(core, db, ropList, key, size);
+			rop_db_classify(core, db, ropList, rz_strbuf_get(&disasm), addr, size);
 		}
 		if (hit) {
 			pj_kN(pj, "retaddr", hit->addr);
@@ -1207,6 +2079,7 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 			rz_io_read_at(core->io, hit->addr, buf, hit->len);
 			rz_asm_set_pc(core->rasm, hit->addr);
 			rz_asm_disassemble(core->rasm, &asmop, buf, hit->len);
+			rz_strbuf_appendf(&disasm, "%s%s", rz_strbuf_is_empty(&disasm) ? "" : "; ", rz_asm_op_get_asm(&asmop));
 			rz_analysis_op(core->analysis, &analop, hit->addr, buf, hit->len, RZ_ANALYSIS_OP_MASK_BASIC);
 			size += hit->len;
 			const char *opstr = RZ_STRBUF_SAFEGET(&analop.esil);
@@ -1227,9 +2100,7 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 		}
 		if (db && hit) {
 			const ut64 addr = ((RzCoreAsmHit *)hitlist->head->data)->addr;
-			// rz_cons_printf ("Gadget size: %d\n", (int)size);
-			const char *key = sdb_fmt("0x%08" PFMT64x, addr);
-			rop_classify(core, db, ropList, key, size);
+			rop_db_classify(core, db, ropList, rz_strbuf_get(&disasm), addr, size);
 		}
 		break;
 	default:
@@ -1248,6 +2119,7 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 			rz_io_read_at(core->io, hit->addr, buf, hit->len);
 			rz_asm_set_pc(core->rasm, hit->addr);
 			rz_asm_disassemble(core->rasm, &asmop, buf, hit->len);
+			rz_strbuf_appendf(&disasm, "%s%s", rz_strbuf_is_empty(&disasm) ? "" : "; ", rz_asm_op_get_asm(&asmop));
 			rz_analysis_op(core->analysis, &analop, hit->addr, buf, hit->len, RZ_ANALYSIS_OP_MASK_ESIL);
 			size += hit->len;
 			if (analop.type != RZ_ANALYSIS_OP_TYPE_RET) {
@@ -1281,14 +2153,13 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 		}
 		if (db && hit) {
 			const ut64 addr = ((RzCoreAsmHit *)hitlist->head->data)->addr;
-			// rz_cons_printf ("Gadget size: %d\n", (int)size);
-			const char *key = sdb_fmt("0x%08" PFMT64x, addr);
-			rop_classify(core, db, ropList, key, size);
+			rop_db_classify(core, db, ropList, rz_strbuf_get(&disasm), addr, size);
 		}
 	}
 	if (mode != 'j') {
 		rz_cons_newline();
 	}
+	rz_strbuf_fini(&disasm);
 	rz_list_free(ropList);
 }
 
@@ -1298,7 +2169,7 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
 	const char *arch = rz_config_get(core->config, "asm.arch");
 	int max_count = rz_config_get_i(core->config, "search.maxhits");
-	int i = 0, end = 0, mode = 0, increment = 1, ret, result = true;
+	int i = 0, end = 0, mode = 0, increment = 1, result = true;
 	RzList /*<endlist_pair>*/ *end_list = rz_list_newf(free);
 	RzList /*<RzRegex>*/ *rx_list = NULL;
 	int align = core->search->align;
@@ -1309,7 +2180,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	int delta = 0;
 	ut8 *buf;
 	RzIOMap *map;
-	RzAsmOp asmop;
 
 	Sdb *gadgetSdb = NULL;
 	if (rz_config_get_i(core->config, "rop.sdb")) {
@@ -1378,11 +2248,10 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 	if (param->outmode == RZ_MODE_JSON) {
 		pj_a(param->pj);
 	}
+	rop_db_load(core);
 	rz_cons_break_push(NULL, NULL);
 
 	rz_list_foreach (param->boundaries, itermap, map) {
-		HtUUOptions opt = { 0 };
-		HtUU *badstart = ht_uu_new_opt(&opt);
 		if (!rz_itv_overlap(search_itv, map->itv)) {
 			continue;
 		}
@@ -1398,9 +2267,21 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			goto bad;
 		}
 		(void)rz_io_read_at(core->io, from, buf, delta);
+		HtUUOptions opt = { 0 };
+		HtUU *badstart = ht_uu_new_opt(&opt);
+		HtUP *insns = ht_up_new(NULL, rop_insn_free, NULL);
+		if (!badstart || !insns) {
+			ht_uu_free(badstart);
+			ht_up_free(insns);
+			free(buf);
+			result = false;
+			goto bad;
+		}
 
-		// Find the end gadgets.
-		for (i = 0; i + 32 < delta; i += increment) {
+		// Find the end gadgets, unless the database has them for this range.
+		char *ends_key = rop_db_ends_key(core, from, buf, delta, crop, increment);
+		bool ends_known = ends_key && rop_db_get_ends(core, ends_key, end_list);
+		for (i = 0; !ends_known && i + 32 < delta; i += increment) {
 			RzAnalysisOp end_gadget = RZ_EMPTY;
 			// Disassemble one.
 			if (rz_analysis_op(core->analysis, &end_gadget, from + i, buf + i,
@@ -1436,6 +2317,10 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			// Right now we have a list of all of the end/stop gadgets.
 			// We can just construct gadgets from a little bit before them.
 		}
+		if (ends_key && !ends_known && !rz_cons_is_breaked()) {
+			rop_db_set_ends(core, ends_key, end_list);
+		}
+		free(ends_key);
 		rz_list_reverse(end_list);
 		// If we have no end gadgets, just skip all of this search nonsense.
 		if (!rz_list_empty(end_list)) {
@@ -1445,9 +2330,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 			// instructions, x86 and friends are weird length instructions, so
 			// we'll just assume 15 byte instructions.
 			ropdepth = increment == 1 ? max_instr * max_inst_size_x86 /* wow, x86 is long */ : max_instr * increment;
-			if (rz_cons_is_breaked()) {
-				break;
-			}
 			struct endlist_pair *end_gadget = (struct endlist_pair *)rz_list_pop(end_list);
 			next = end_gadget->instr_offset;
 			prev = 0;
@@ -1490,58 +2372,55 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 						RZ_MIN((delta - i), 4096));
 					end = i + 2048;
 				}
-				ret = rz_asm_disassemble(core->rasm, &asmop, buf + i, delta - i);
-				if (ret) {
-					rz_asm_set_pc(core->rasm, from + i);
-					RzList *hitlist = construct_rop_gadget(core,
-						from + i, buf, delta, i, grep, regexp,
-						rx_list, end_gadget, badstart);
-					if (!hitlist) {
-						continue;
-					}
-					if (align && (0 != ((from + i) % align))) {
-						continue;
+				RzList *hitlist = construct_rop_gadget(core,
+					from + i, buf, delta, i, grep, regexp,
+					rx_list, end_gadget, badstart, insns);
+				if (!hitlist) {
+					continue;
+				}
+				if (align && (0 != ((from + i) % align))) {
+					rz_list_free(hitlist);
+					continue;
+				}
+				if (gadgetSdb) {
+					RzListIter *iter;
+
+					RzCoreAsmHit *hit = (RzCoreAsmHit *)hitlist->head->data;
+					char *headAddr = rz_str_newf("%" PFMT64x, hit->addr);
+					if (!headAddr) {
+						result = false;
+						goto bad;
 					}
-					if (gadgetSdb) {
-						RzListIter *iter;
 
-						RzCoreAsmHit *hit = (RzCoreAsmHit *)hitlist->head->data;
-						char *headAddr = rz_str_newf("%" PFMT64x, hit->addr);
-						if (!headAddr) {
+					rz_list_foreach (hitlist, iter, hit) {
+						char *addr = rz_str_newf("%" PFMT64x "(%" PFMT32d ")", hit->addr, hit->len);
+						if (!addr) {
+							free(headAddr);
 							result = false;
 							goto bad;
 						}
-
-						rz_list_foreach (hitlist, iter, hit) {
-							char *addr = rz_str_newf("%" PFMT64x "(%" PFMT32d ")", hit->addr, hit->len);
-							if (!addr) {
-								free(headAddr);
-								result = false;
-								goto bad;
-							}
-							sdb_concat(gadgetSdb, headAddr, addr, 0);
-							free(addr);
-						}
-						free(headAddr);
+						sdb_concat(gadgetSdb, headAddr, addr, 0);
+						free(addr);
 					}
+					free(headAddr);
+				}
 
-					if (param->outmode == RZ_MODE_JSON) {
-						mode = 'j';
-					}
-					if ((mode == 'q') && subchain) {
-						do {
-							print_rop(core, hitlist, NULL, mode);
-							hitlist->head = hitlist->head->n;
-						} while (hitlist->head->n);
-					} else {
-						print_rop(core, hitlist, param->pj, mode);
-					}
-					rz_list_free(hitlist);
-					if (max_count > 0) {
-						max_count--;
-						if (max_count < 1) {
-							break;
-						}
+				if (param->outmode == RZ_MODE_JSON) {
+					mode = 'j';
+				}
+				if ((mode == 'q') && subchain) {
+					do {
+						print_rop(core, hitlist, NULL, mode);
+						hitlist->head = hitlist->head->n;
+					} while (hitlist->head->n);
+				} else {
+					print_rop(core, hitlist, param->pj, mode);
+				}
+				rz_list_free(hitlist);
+				if (max_count > 0) {
+					max_count--;
+					if (max_count < 1) {
+						break;
 					}
 				}
 				if (increment != 1) {
@@ -1549,12 +2428,16 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 				}
 			}
 		}
+		rz_list_purge(end_list);
+		ht_up_free(insns);
+		ht_uu_free(badstart);
 		free(buf);
 	}
 	if (rz_cons_is_breaked()) {
 		eprintf("\n");
 	}
 	rz_cons_break_pop();
+	rop_db_save(core);
 
 	if (param->outmode == RZ_MODE_JSON) {
 		pj_end(param->pj);
@@ -2430,7 +3313,10 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 
 static void rop_kuery(void *data, const char *input, PJ *pj) {
 	RzCore *core = (RzCore *)data;
+	rop_db_load(core);
 	Sdb *db_rop = sdb_ns(core->sdb, "rop", false);
+	Sdb *db_disasm = sdb_ns(core->sdb, "rop_disasm", false);
+	Sdb *db_esil = sdb_ns(core->sdb, "rop_esil", false);
 	SdbListIter *sdb_iter, *it;
 	SdbList *sdb_list;
 	SdbNs *ns;
@@ -2470,6 +3356,14 @@ static void rop_kuery(void *data, const char *input, PJ *pj) {
 				pj_ks(pj, "size", size);
 				pj_ks(pj, "type", ns->name);
 				pj_ks(pj, "effect", tok);
+				const char *disasm = db_disasm ? sdb_const_get(db_disasm, sdbkv_key(kv), 0) : NULL;
+				if (disasm) {
+					pj_ks(pj, "disasm", disasm);
+				}
+				const char *esil = db_esil ? sdb_const_get(db_esil, sdbkv_key(kv), 0) : NULL;
+				if (esil) {
+					pj_ks(pj, "esil", esil);
+				}
 				pj_end(pj);
 				free(dup);
 				if (flag) {
@@ -3532,7 +4426,7 @@ reread:
 			}
 			p[1] = 0;
 		}
-		rz_search_reset(core->search, RZ_SEARCH_KEYWORD);
+		rz_search_reset(core->search, RZ_SEARCH_MULTI);
 		rz_search_set_distance(core->search, (int)rz_config_get_i(core->config, "search.distance"));
 		RzSearchKeyword *skw;
 		skw = rz_search_keyword_new((const ut8 *)inp, len * 2, NULL, 0, NULL);
@@ -3572,7 +4466,7 @@ reread:
 			eprintf ("\n");
 		}
 #endif
-		rz_search_reset(core->search, RZ_SEARCH_KEYWORD);
+		rz_search_reset(core->search, RZ_SEARCH_MULTI);
 		rz_search_set_distance(core->search, (int)rz_config_get_i(core->config, "search.distance"));
 		{
 			RzSearchKeyword *skw;
@@ -3747,7 +4641,7 @@ reread:
 		} else {
 			RzSearchKeyword *kw;
 			char *s, *p = strdup(input + param_offset);
-			rz_search_reset(core->search, RZ_SEARCH_KEYWORD);
+			rz_search_reset(core->search, RZ_SEARCH_MULTI);
 			rz_search_set_distance(core->search, (int)rz_config_get_i(core->config, "search.distance"));
 			s = strchr(p, ':');
 			if (s) {
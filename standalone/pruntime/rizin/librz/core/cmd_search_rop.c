@@ -687,7 +687,6 @@ static int rop_classify_nops(RzCore *core, RzList *ropList) {
 
 static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key, unsigned int size) {
 	int nop = 0;
-	rop_classify_nops(core, ropList);
 	char *mov, *ct, *arithm, *arithm_ct, *str;
 	Sdb *db_nop = sdb_ns(db, "nop", true);
 	Sdb *db_mov = sdb_ns(db, "mov", true);
@@ -2326,7 +2326,7 @@ static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
 	if (rz_config_get_i(core->config, "analysis.detectwrites")) {
-		rz_analysis_update_analysis_range(core->analysis, iow->addr, iow->len);
+		rz_core_analysis_update_range(core, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
 			// Force a reload of the graph
 			core->cons->event_resize(core->cons->event_data);
@@ -2628,6 +2628,9 @@ RZ_API void rz_core_fini(RzCore *c) {
 	//rz_core_file_free (c->file);
 	//c->file = NULL;
 	RZ_FREE(c->table_query);
+	RZ_FREE(c->disasm_config);
+	rz_core_cmd_cache_free(c->cmd_cache);
+	c->cmd_cache = NULL;
 	rz_list_free(c->files);
 	rz_list_free(c->watchers);
 	rz_list_free(c->scriptstack);
@@ -2684,6 +2687,12 @@ RZ_API void rz_core_prompt_loop(RzCore *r) {
 		if ((ret = rz_core_prompt_exec(r)) == -2) {
 			break;
 		}
+		if (r->cons->line && r->cons->line->zerosep && rz_config_get_b(r->config, "cmd.framed")) {
+			// an rzpipe client asked for frames, serve them until it goes away
+			rzpipe_frame_serve(0, 1, (RzPipeFrameCmd)rz_core_cmd_str, r);
+			r->num->value = 0;
+			break;
+		}
 	} while (ret != RZ_CORE_CMD_EXIT);
 }
 
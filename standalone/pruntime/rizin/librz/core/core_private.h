@@ -9,12 +9,15 @@
 
 RZ_IPI void rz_core_kuery_print(RzCore *core, const char *k);
 RZ_IPI int rz_output_mode_to_char(RzOutputMode mode);
+RZ_IPI void rz_core_cmd_cache_free(RzCoreCmdCache *cache);
+RZ_IPI bool rz_core_cmd_is_listed(const char *cmd, const char *names);
 
 RZ_IPI int bb_cmpaddr(const void *_a, const void *_b);
 RZ_IPI int fcn_cmpaddr(const void *_a, const void *_b);
 
 RZ_IPI int rz_core_analysis_set_reg(RzCore *core, const char *regname, ut64 val);
 RZ_IPI void rz_core_analysis_esil_init(RzCore *core);
+RZ_IPI void rz_core_analysis_update_range(RzCore *core, ut64 addr, int size);
 RZ_IPI void rz_core_analysis_esil_reinit(RzCore *core);
 RZ_IPI void rz_core_analysis_esil_init_mem_del(RzCore *core, const char *name, ut64 addr, ut32 size);
 RZ_IPI void rz_core_analysis_esil_init_mem(RzCore *core, const char *name, ut64 addr, ut32 size);
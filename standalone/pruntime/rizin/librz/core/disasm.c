@@ -96,6 +96,9 @@ typedef struct {
 	int interactive;
 	bool subjmp;
 	bool subvar;
+	bool subrel;
+	bool subreg;
+	bool subvaronly;
 	bool show_lines;
 	bool show_lines_bb;
 	bool show_lines_ret;
@@ -294,6 +297,7 @@ typedef struct {
 	const char *strip;
 	int maxflags;
 	int asm_types;
+	int bytespace;
 } RDisasmState;
 
 static void ds_setup_print_pre(RDisasmState *ds, bool tail, bool middle);
@@ -566,102 +570,21 @@ static void ds_print_esil_analysis_fini(RDisasmState *ds) {
 	}
 }
 
-static RDisasmState *ds_init(RzCore *core) {
-	RDisasmState *ds = RZ_NEW0(RDisasmState);
-	if (!ds) {
-		return NULL;
-	}
-	ds->core = core;
-	ds->strip = rz_config_get(core->config, "asm.strip");
-	ds->pal_comment = core->cons->context->pal.comment;
-#define P(x) (core->cons && core->cons->context->pal.x) ? core->cons->context->pal.x
-	ds->color_comment = P(comment)
-	    : Color_CYAN;
-	ds->color_usrcmt = P(usercomment)
-	    : Color_CYAN;
-	ds->color_fname = P(fname)
-	    : Color_RED;
-	ds->color_floc = P(floc)
-	    : Color_MAGENTA;
-	ds->color_fline = P(fline)
-	    : Color_CYAN;
-	ds->color_flow = P(flow)
-	    : Color_CYAN;
-	ds->color_flow2 = P(flow2)
-	    : Color_BLUE;
-	ds->color_flag = P(flag)
-	    : Color_CYAN;
-	ds->color_label = P(label)
-	    : Color_CYAN;
-	ds->color_offset = P(offset)
-	    : Color_GREEN;
-	ds->color_other = P(other)
-	    : Color_WHITE;
-	ds->color_nop = P(nop)
-	    : Color_BLUE;
-	ds->color_bin = P(bin)
-	    : Color_YELLOW;
-	ds->color_math = P(math)
-	    : Color_YELLOW;
-	ds->color_btext = P(btext)
-	    : Color_YELLOW;
-	ds->color_jmp = P(jmp)
-	    : Color_GREEN;
-	ds->color_cjmp = P(cjmp)
-	    : Color_GREEN;
-	ds->color_call = P(call)
-	    : Color_BGREEN;
-	ds->color_cmp = P(cmp)
-	    : Color_MAGENTA;
-	ds->color_swi = P(swi)
-	    : Color_MAGENTA;
-	ds->color_trap = P(trap)
-	    : Color_BRED;
-	ds->color_ret = P(ret)
-	    : Color_RED;
-	ds->color_push = P(push)
-	    : Color_YELLOW;
-	ds->color_pop = P(pop)
-	    : Color_BYELLOW;
-	ds->color_reg = P(reg)
-	    : Color_YELLOW;
-	ds->color_num = P(num)
-	    : Color_CYAN;
-	ds->color_mov = P(mov)
-	    : Color_WHITE;
-	ds->color_invalid = P(invalid)
-	    : Color_BRED;
-	ds->color_gui_cflow = P(gui_cflow)
-	    : Color_YELLOW;
-	ds->color_gui_dataoffset = P(gui_dataoffset)
-	    : Color_YELLOW;
-	ds->color_gui_background = P(gui_background)
-	    : Color_BLACK;
-	ds->color_gui_alt_background = P(gui_alt_background)
-	    : Color_GRAY;
-	ds->color_gui_border = P(gui_border)
-	    : Color_BGGRAY;
-	ds->color_linehl = P(linehl)
-	    : Color_BGBLUE;
-	ds->color_func_var = P(func_var)
-	    : Color_WHITE;
-	ds->color_func_var_type = P(func_var_type)
-	    : Color_BLUE;
-	ds->color_func_var_addr = P(func_var_addr)
-	    : Color_CYAN;
+struct rz_core_disasm_config_t {
+	ut64 generation; ///< value of RzConfig.generation when the snapshot was taken
+	RDisasmState ds; ///< only the fields derived from the configuration are set
+};
 
+/* Fills every field of ds that depends only on the value of config variables */
+static void ds_init_config(RzCore *core, RDisasmState *ds) {
+	ds->strip = rz_config_get(core->config, "asm.strip");
 	ds->immstr = rz_config_get_b(core->config, "asm.imm.str");
 	ds->immtrim = rz_config_get_b(core->config, "asm.imm.trim");
 	ds->use_esil = rz_config_get_b(core->config, "asm.esil");
 	ds->pre_emu = rz_config_get_b(core->config, "emu.pre");
 	ds->show_flgoff = rz_config_get_b(core->config, "asm.flags.offset");
 	ds->show_nodup = rz_config_get_b(core->config, "asm.nodup");
-	{
-		const char *ah = rz_config_get(core->config, "asm.highlight");
-		ds->asm_highlight = (ah && *ah) ? rz_num_math(core->num, ah) : UT64_MAX;
-	}
 	ds->asm_analysis = rz_config_get_b(core->config, "asm.analysis");
-	ds->show_color = rz_config_get_i(core->config, "scr.color");
 	ds->show_color_bytes = rz_config_get_b(core->config, "scr.color.bytes"); // maybe rename to asm.color.bytes
 	ds->show_color_args = rz_config_get_b(core->config, "scr.color.args");
 	ds->colorop = rz_config_get_b(core->config, "scr.color.ops"); // XXX confusing name // asm.color.inst (mnemonic + operands) ?
@@ -675,18 +598,16 @@ static RDisasmState *ds_init(RzCore *core) {
 	ds->midbb = rz_config_get_b(core->config, "asm.bb.middle");
 	ds->midcursor = rz_config_get_b(core->config, "asm.midcursor");
 	ds->decode = rz_config_get_b(core->config, "asm.decode");
-	core->parser->pseudo = ds->pseudo = rz_config_get_b(core->config, "asm.pseudo");
+	ds->pseudo = rz_config_get_b(core->config, "asm.pseudo");
 	if (ds->pseudo) {
 		ds->atabs = 0;
 	}
 	ds->subnames = rz_config_get_b(core->config, "asm.sub.names");
-	ds->interactive = rz_cons_is_interactive();
 	ds->subjmp = rz_config_get_b(core->config, "asm.sub.jmp");
 	ds->subvar = rz_config_get_b(core->config, "asm.sub.var");
-	core->parser->subrel = rz_config_get_b(core->config, "asm.sub.rel");
-	core->parser->subreg = rz_config_get_b(core->config, "asm.sub.reg");
-	core->parser->localvar_only = rz_config_get_b(core->config, "asm.sub.varonly");
-	core->parser->retleave_asm = NULL;
+	ds->subrel = rz_config_get_b(core->config, "asm.sub.rel");
+	ds->subreg = rz_config_get_b(core->config, "asm.sub.reg");
+	ds->subvaronly = rz_config_get_b(core->config, "asm.sub.varonly");
 	ds->show_fcnsig = rz_config_get_b(core->config, "asm.fcn.signature");
 	ds->show_fcnsize = rz_config_get_b(core->config, "asm.fcn.size");
 	ds->show_vars = rz_config_get_b(core->config, "asm.var");
@@ -705,8 +626,8 @@ static RDisasmState *ds_init(RzCore *core) {
 	ds->tracespace = rz_config_get_i(core->config, "asm.tracespace");
 	ds->cyclespace = rz_config_get_i(core->config, "asm.cyclespace");
 	ds->show_dwarf = rz_config_get_b(core->config, "asm.dwarf");
-	ds->dwarfFile = rz_config_get_b(ds->core->config, "asm.dwarf.file");
-	ds->dwarfAbspath = rz_config_get_b(ds->core->config, "asm.dwarf.abspath");
+	ds->dwarfFile = rz_config_get_b(core->config, "asm.dwarf.file");
+	ds->dwarfAbspath = rz_config_get_b(core->config, "asm.dwarf.abspath");
 	ds->show_lines_call = ds->show_lines ? rz_config_get_b(core->config, "asm.lines.call") : false;
 	ds->show_lines_ret = ds->show_lines ? rz_config_get_b(core->config, "asm.lines.ret") : false;
 	ds->show_size = rz_config_get_b(core->config, "asm.size");
@@ -734,25 +655,6 @@ static RDisasmState *ds_init(RzCore *core) {
 	ds->show_emu_write = rz_config_get_b(core->config, "emu.write");
 	ds->show_emu_ssa = rz_config_get_b(core->config, "emu.ssa");
 	ds->show_emu_stack = rz_config_get_b(core->config, "emu.stack");
-	ds->stackFd = -1;
-	if (ds->show_emu_stack) {
-		// TODO: initialize fake stack in here
-		const char *uri = "malloc://32K";
-		ut64 size = rz_num_get(core->num, "32K");
-		ut64 addr = rz_reg_getv(core->analysis->reg, "SP") - (size / 2);
-		emustack_min = addr;
-		emustack_max = addr + size;
-		ds->stackFd = rz_io_fd_open(core->io, uri, RZ_PERM_RW, 0);
-		RzIOMap *map = rz_io_map_add(core->io, ds->stackFd, RZ_PERM_RW, 0LL, addr, size);
-		if (!map) {
-			rz_io_fd_close(core->io, ds->stackFd);
-			eprintf("Cannot create map for tha stack, fd %d got closed again\n", ds->stackFd);
-			ds->stackFd = -1;
-		} else {
-			rz_io_map_set_name(map, "fake.stack");
-		}
-	}
-	ds->stackptr = core->analysis->stackptr;
 	ds->show_offseg = rz_config_get_b(core->config, "asm.segoff");
 	ds->show_flags = rz_config_get_b(core->config, "asm.flags");
 	ds->show_bytes = rz_config_get_b(core->config, "asm.bytes");
@@ -790,7 +692,6 @@ static RDisasmState *ds_init(RzCore *core) {
 	}
 	ds->show_functions = rz_config_get_b(core->config, "asm.functions");
 	ds->nbytes = rz_config_get_i(core->config, "asm.nbytes");
-	ds->show_asciidot = !strcmp(core->print->strconv_mode, "asciidot");
 	const char *strenc_str = rz_config_get(core->config, "bin.str.enc");
 	if (!strenc_str) {
 		ds->strenc = RZ_STRING_ENC_GUESS;
@@ -809,44 +710,22 @@ static RDisasmState *ds_init(RzCore *core) {
 	} else {
 		ds->strenc = RZ_STRING_ENC_GUESS;
 	}
-	core->print->bytespace = rz_config_get_i(core->config, "asm.bytes.space");
-	ds->cursor = 0;
-	ds->nb = 0;
-	ds->flagspace_ports = rz_flag_space_get(core->flags, "ports");
+	ds->bytespace = rz_config_get_i(core->config, "asm.bytes.space");
 	ds->lbytes = rz_config_get_i(core->config, "asm.lbytes");
 	ds->show_comment_right_default = rz_config_get_b(core->config, "asm.cmt.right");
-	ds->show_comment_right = ds->show_comment_right_default;
 	ds->show_flag_in_bytes = rz_config_get_b(core->config, "asm.flags.inbytes");
 	ds->show_marks = rz_config_get_b(core->config, "asm.marks");
 	ds->show_noisy_comments = rz_config_get_b(core->config, "asm.noisy");
-	ds->pre = DS_PRE_NONE;
-	ds->ocomment = NULL;
-	ds->linesopts = 0;
-	ds->lastfail = 0;
-	ds->ocols = 0;
-	ds->lcols = 0;
-	ds->printed_str_addr = UT64_MAX;
-	ds->printed_flag_addr = UT64_MAX;
-
-	ds->esil_old_pc = UT64_MAX;
-	ds->esil_regstate = NULL;
-	ds->esil_likely = false;
-
-	ds->showpayloads = rz_config_get_b(ds->core->config, "asm.payloads");
+	ds->showpayloads = rz_config_get_b(core->config, "asm.payloads");
 	ds->showrelocs = rz_config_get_b(core->config, "bin.relocs");
 	ds->min_ref_addr = rz_config_get_i(core->config, "asm.sub.varmin");
 
 	if (ds->show_flag_in_bytes) {
 		ds->show_flags = false;
 	}
-	if (rz_config_get_i(core->config, "asm.lines.wide")) {
+	if (rz_config_get_b(core->config, "asm.lines.wide")) {
 		ds->linesopts |= RZ_ANALYSIS_REFLINE_TYPE_WIDE;
 	}
-	if (core->cons->vline) {
-		if (ds->show_utf8) {
-			ds->linesopts |= RZ_ANALYSIS_REFLINE_TYPE_UTF8;
-		}
-	}
 	if (ds->show_lines_bb) {
 		ds->ocols += 10; // XXX
 	}
@@ -865,6 +744,157 @@ static RDisasmState *ds_init(RzCore *core) {
 	}
 	/* disasm */ ds->ocols += 20;
 	ds->nb = ds->nbytes ? (1 + ds->nbytes * 2) : 0;
+}
+
+/**
+ * Reading the ~150 variables used by the disassembler is a sizeable part of
+ * printing a single function, so they are read once into a snapshot kept in
+ * the core and copied from there until any config variable changes.
+ */
+static bool ds_load_config(RzCore *core, RDisasmState *ds) {
+	RzCoreDisasmConfig *dc = core->disasm_config;
+	if (!dc || dc->generation != core->config->generation) {
+		if (!dc) {
+			dc = RZ_NEW(RzCoreDisasmConfig);
+			if (!dc) {
+				return false;
+			}
+			core->disasm_config = dc;
+		}
+		memset(&dc->ds, 0, sizeof(dc->ds));
+		dc->generation = core->config->generation;
+		ds_init_config(core, &dc->ds);
+	}
+	memcpy(ds, &dc->ds, sizeof(*ds));
+	return true;
+}
+
+static RDisasmState *ds_init(RzCore *core) {
+	RDisasmState *ds = RZ_NEW(RDisasmState);
+	if (!ds) {
+		return NULL;
+	}
+	if (!ds_load_config(core, ds)) {
+		free(ds);
+		return NULL;
+	}
+	ds->core = core;
+	ds->pal_comment = core->cons->context->pal.comment;
+#define P(x) (core->cons && core->cons->context->pal.x) ? core->cons->context->pal.x
+	ds->color_comment = P(comment)
+	    : Color_CYAN;
+	ds->color_usrcmt = P(usercomment)
+	    : Color_CYAN;
+	ds->color_fname = P(fname)
+	    : Color_RED;
+	ds->color_floc = P(floc)
+	    : Color_MAGENTA;
+	ds->color_fline = P(fline)
+	    : Color_CYAN;
+	ds->color_flow = P(flow)
+	    : Color_CYAN;
+	ds->color_flow2 = P(flow2)
+	    : Color_BLUE;
+	ds->color_flag = P(flag)
+	    : Color_CYAN;
+	ds->color_label = P(label)
+	    : Color_CYAN;
+	ds->color_offset = P(offset)
+	    : Color_GREEN;
+	ds->color_other = P(other)
+	    : Color_WHITE;
+	ds->color_nop = P(nop)
+	    : Color_BLUE;
+	ds->color_bin = P(bin)
+	    : Color_YELLOW;
+	ds->color_math = P(math)
+	    : Color_YELLOW;
+	ds->color_btext = P(btext)
+	    : Color_YELLOW;
+	ds->color_jmp = P(jmp)
+	    : Color_GREEN;
+	ds->color_cjmp = P(cjmp)
+	    : Color_GREEN;
+	ds->color_call = P(call)
+	    : Color_BGREEN;
+	ds->color_cmp = P(cmp)
+	    : Color_MAGENTA;
+	ds->color_swi = P(swi)
+	    : Color_MAGENTA;
+	ds->color_trap = P(trap)
+	    : Color_BRED;
+	ds->color_ret = P(ret)
+	    : Color_RED;
+	ds->color_push = P(push)
+	    : Color_YELLOW;
+	ds->color_pop = P(pop)
+	    : Color_BYELLOW;
+	ds->color_reg = P(reg)
+	    : Color_YELLOW;
+	ds->color_num = P(num)
+	    : Color_CYAN;
+	ds->color_mov = P(mov)
+	    : Color_WHITE;
+	ds->color_invalid = P(invalid)
+	    : Color_BRED;
+	ds->color_gui_cflow = P(gui_cflow)
+	    : Color_YELLOW;
+	ds->color_gui_dataoffset = P(gui_dataoffset)
+	    : Color_YELLOW;
+	ds->color_gui_background = P(gui_background)
+	    : Color_BLACK;
+	ds->color_gui_alt_background = P(gui_alt_background)
+	    : Color_GRAY;
+	ds->color_gui_border = P(gui_border)
+	    : Color_BGGRAY;
+	ds->color_linehl = P(linehl)
+	    : Color_BGBLUE;
+	ds->color_func_var = P(func_var)
+	    : Color_WHITE;
+	ds->color_func_var_type = P(func_var_type)
+	    : Color_BLUE;
+	ds->color_func_var_addr = P(func_var_addr)
+	    : Color_CYAN;
+
+	{
+		const char *ah = rz_config_get(core->config, "asm.highlight");
+		ds->asm_highlight = (ah && *ah) ? rz_num_math(core->num, ah) : UT64_MAX;
+	}
+	// the getter of scr.color follows the console, which may change on its own
+	ds->show_color = rz_config_get_i(core->config, "scr.color");
+	ds->interactive = rz_cons_is_interactive();
+	core->parser->pseudo = ds->pseudo;
+	core->parser->subrel = ds->subrel;
+	core->parser->subreg = ds->subreg;
+	core->parser->localvar_only = ds->subvaronly;
+	core->parser->retleave_asm = NULL;
+	ds->stackFd = -1;
+	if (ds->show_emu_stack) {
+		// TODO: initialize fake stack in here
+		const char *uri = "malloc://32K";
+		ut64 size = rz_num_get(core->num, "32K");
+		ut64 addr = rz_reg_getv(core->analysis->reg, "SP") - (size / 2);
+		emustack_min = addr;
+		emustack_max = addr + size;
+		ds->stackFd = rz_io_fd_open(core->io, uri, RZ_PERM_RW, 0);
+		RzIOMap *map = rz_io_map_add(core->io, ds->stackFd, RZ_PERM_RW, 0LL, addr, size);
+		if (!map) {
+			rz_io_fd_close(core->io, ds->stackFd);
+			eprintf("Cannot create map for tha stack, fd %d got closed again\n", ds->stackFd);
+			ds->stackFd = -1;
+		} else {
+			rz_io_map_set_name(map, "fake.stack");
+		}
+	}
+	ds->stackptr = core->analysis->stackptr;
+	ds->show_asciidot = !strcmp(core->print->strconv_mode, "asciidot");
+	core->print->bytespace = ds->bytespace;
+	ds->flagspace_ports = rz_flag_space_get(core->flags, "ports");
+	ds->show_comment_right = ds->show_comment_right_default;
+	ds->pre = DS_PRE_NONE;
+	ds->printed_str_addr = UT64_MAX;
+	ds->printed_flag_addr = UT64_MAX;
+	ds->esil_old_pc = UT64_MAX;
 	ds->tries = 3;
 	if (core->print->cur_enabled) {
 		if (core->print->cur < 0) {
@@ -874,9 +904,6 @@ static RDisasmState *ds_init(RzCore *core) {
 	} else {
 		ds->cursor = -1;
 	}
-	if (rz_config_get_b(core->config, "asm.lines.wide")) {
-		ds->linesopts |= RZ_ANALYSIS_REFLINE_TYPE_WIDE;
-	}
 	if (core->cons->vline) {
 		if (ds->show_utf8) {
 			ds->linesopts |= RZ_ANALYSIS_REFLINE_TYPE_UTF8;
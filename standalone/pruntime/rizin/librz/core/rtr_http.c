@@ -2,11 +2,72 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 // included from rtr.c
 
+/* A request answered by a forked process */
+typedef struct {
+	int pid;
+	RzSocketHTTPRequest *rs;
+} HttpJob;
+
+/**
+ * Answers the read-only command \p cmd from a forked copy of the session
+ * when less than http.jobs processes are running, so that the server can
+ * go on with the next requests. The connection is handed back to the server
+ * by http_jobs_reap() once the process is done.
+ */
+static bool http_jobs_fork(RzCore *core, RzVector /*<HttpJob>*/ *jobs, RzSocketHTTPRequest *rs, const char *cmd, const char *headers) {
+#if __UNIX__ && HAVE_FORK
+	st64 max = rz_config_get_i(core->config, "http.jobs");
+	if (max < 1 || rz_vector_len(jobs) >= max || !rz_core_cmd_is_listed(cmd, rz_config_get(core->config, "http.jobs.cmds"))) {
+		return false;
+	}
+	int pid = rz_sys_fork();
+	if (pid < 0) {
+		return false;
+	}
+	if (!pid) {
+		char *out = rz_core_cmd_str_pipe(core, cmd);
+		char *hdr = rz_str_newf("Content-Type: text/plain\n%s", headers);
+		rz_socket_http_response(rs, 200, out ? out : "", 0, hdr ? hdr : headers);
+		_exit(0);
+	}
+	HttpJob job = { .pid = pid, .rs = rs };
+	if (!rz_vector_push(jobs, &job)) {
+		waitpid(pid, NULL, 0);
+		rz_socket_http_close(rs);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void http_jobs_reap(RzSocketHTTPServer *hs, RzVector /*<HttpJob>*/ *jobs, bool wait) {
+#if __UNIX__ && HAVE_FORK
+	size_t i = 0;
+	while (i < rz_vector_len(jobs)) {
+		HttpJob *job = rz_vector_index_ptr(jobs, i);
+		int status = 0;
+		if (!waitpid(job->pid, &status, wait ? 0 : WNOHANG)) {
+			i++;
+			continue;
+		}
+		if (WIFEXITED(status) && !WEXITSTATUS(status)) {
+			rz_socket_http_server_done(hs, job->rs);
+		} else {
+			rz_socket_http_close(job->rs);
+		}
+		rz_vector_remove_at(jobs, i, NULL);
+	}
+#endif
+}
+
 // return 1 on error
 static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char *path) {
 	RzConfig *newcfg = NULL, *origcfg = NULL;
 	char headers[128] = RZ_EMPTY;
 	RzSocketHTTPRequest *rs;
+	RzSocketHTTPServer *hs = NULL;
+	RzVector jobs;
 	char buf[32];
 	int ret = 0;
 	RzSocket *s;
@@ -106,6 +167,15 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		so.accept_timeout = 1;
 	}
 
+	hs = rz_socket_http_server_new(s, &so);
+	if (!hs) {
+		rz_socket_free(s);
+		rz_list_free(so.authtokens);
+		free(pfile);
+		return 1;
+	}
+	rz_vector_init(&jobs, sizeof(HttpJob), NULL, NULL);
+
 	origcfg = core->config;
 	newcfg = rz_config_clone(core->config);
 	core->config = newcfg;
@@ -129,6 +199,8 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 
 	newblk = malloc(core->blocksize);
 	if (!newblk) {
+		rz_socket_http_server_free(hs);
+		rz_vector_fini(&jobs);
 		rz_socket_free(s);
 		rz_list_free(so.authtokens);
 		free(pfile);
@@ -160,8 +232,10 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		/* this is blocking */
 		activateDieTime(core);
 
+		http_jobs_reap(hs, &jobs, false);
 		void *bed = rz_cons_sleep_begin();
-		rs = rz_socket_http_accept(s, &so);
+		// wake up regularly to give the connections of finished jobs back
+		rs = rz_socket_http_server_accept(hs, rz_vector_empty(&jobs) && !so.accept_timeout ? -1 : 100);
 		rz_cons_sleep_end(bed);
 
 		origoff = core->offset;
@@ -179,9 +253,6 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		rz_config_set(newcfg, "scr.interactive", rz_config_get(newcfg, "scr.interactive"));
 
 		if (!rs) {
-			bed = rz_cons_sleep_begin();
-			rz_sys_usleep(100);
-			rz_cons_sleep_end(bed);
 			continue;
 		}
 		if (allow && *allow) {
@@ -320,6 +391,10 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 								/* commands in /cmd/: starting with : do not show any output */
 								rz_core_cmd0(core, cmd + 1);
 								out = NULL;
+							} else if (http_jobs_fork(core, &jobs, rs, cmd, headers)) {
+								/* answered by the forked process */
+								out = NULL;
+								rs = NULL;
 							} else {
 								out = rz_core_cmd_str_pipe(core, cmd);
 							}
@@ -332,7 +407,7 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 								free(out);
 								free(newheaders);
 								free(res);
-							} else {
+							} else if (rs) {
 								rz_socket_http_response(rs, 200, "", 0, headers);
 							}
 
@@ -389,7 +464,7 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 					if (rz_file_is_directory(path)) {
 						char *res = rz_str_newf("Location: %s/\n%s", rs->path, headers);
 						rz_socket_http_response(rs, 302, NULL, 0, res);
-						rz_socket_http_close(rs);
+						rz_socket_http_server_done(hs, rs);
 						free(path);
 						free(res);
 						RZ_FREE(dir);
@@ -460,7 +535,9 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		} else {
 			rz_socket_http_response(rs, 404, "Invalid protocol", 0, headers);
 		}
-		rz_socket_http_close(rs);
+		if (rs) {
+			rz_socket_http_server_done(hs, rs);
+		}
 		free(dir);
 	}
 the_end : {
@@ -478,6 +555,9 @@ the_end : {
 }
 	rz_cons_break_pop();
 	core->http_up = false;
+	http_jobs_reap(hs, &jobs, true);
+	rz_vector_fini(&jobs);
+	rz_socket_http_server_free(hs);
 	free(pfile);
 	rz_socket_free(s);
 	rz_config_free(newcfg);
@@ -561,3 +641,34 @@ RZ_API int rz_core_rtr_http(RzCore *core, int launch, int browse, const char *pa
 	} while (ret == -2);
 	return ret;
 }
+
+/**
+ * \brief Load test the http server listening on http.port
+ * \param args "[requests] [conns] [path]"
+ */
+RZ_API bool rz_core_rtr_http_bench(RzCore *core, const char *args) {
+	rz_return_val_if_fail(core && args, false);
+	char *argv = strdup(args);
+	if (!argv) {
+		return false;
+	}
+	int argc = rz_str_word_set0(argv);
+	int requests = argc > 0 ? (int)rz_num_math(core->num, rz_str_word_get0(argv, 0)) : 1000;
+	int conns = argc > 1 ? (int)rz_num_math(core->num, rz_str_word_get0(argv, 1)) : 8;
+	const char *path = argc > 2 ? rz_str_word_get0(argv, 2) : "/cmd/?V";
+	const char *host = rz_config_get(core->config, "http.bind");
+	if (!host || !*host || !strcmp(host, "local") || host[0] == '0' || !strcmp(host, "public")) {
+		host = "127.0.0.1";
+	}
+	RzSocketHTTPBench res;
+	bool ret = requests > 0 && conns > 0 &&
+		rz_socket_http_bench(host, rz_config_get(core->config, "http.port"), path, requests, conns, &res);
+	if (ret) {
+		rz_cons_printf("%d requests, %d failed in %.3fs (%.0f requests/s)\n",
+			res.ok + res.failed, res.failed, res.seconds, res.seconds > 0 ? res.ok / res.seconds : 0.0);
+	} else {
+		eprintf("Cannot load test http://%s:%s%s\n", host, rz_config_get(core->config, "http.port"), path);
+	}
+	free(argv);
+	return ret;
+}
@@ -1972,6 +1972,7 @@ static void config_visual_hit(RzCore *core, const char *name, int editor) {
 		if (editor) {
 			char *buf = rz_core_editor(core, NULL, node->value);
 			node->value = rz_str_dup(node->value, buf);
+			core->config->generation++;
 			free(buf);
 		} else {
 			// FGETS AND SO
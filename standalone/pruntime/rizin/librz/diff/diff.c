@@ -59,6 +59,7 @@
 
 #include <rz_diff.h>
 #include <rz_util.h>
+#include "diff_private.h"
 /**/
 #include <ht_pp.h>
 #include <ht_uu.h>
@@ -92,6 +93,7 @@ struct rz_diff_t {
 	ut32 a_size;
 	ut32 b_size;
 	HtPP *b_hits;
+	bool large; ///< bytes diffed by large_diff.c, b_hits is not used
 	MethodsInternal methods;
 };
 
@@ -184,6 +186,9 @@ static bool set_b(RzDiff *diff, const void *b, ut32 b_size) {
  * Allocates the internal structure needed to diff buffers by
  * using the methods defined in methods_bytes.
  * Allows to define an callback function to ignore bytes.
+ * Inputs of DIFF_LARGE_BYTES_THRESHOLD bytes or more, when no bytes are
+ * ignored, are diffed with the algorithm in large_diff.c instead, which
+ * does not build the map of hits and runs in linear memory.
  * */
 RZ_API RZ_OWN RzDiff *rz_diff_bytes_new(RZ_BORROW const ut8 *a, ut32 a_size, RZ_BORROW const ut8 *b, ut32 b_size, RZ_NULLABLE RzDiffIgnoreByte ignore) {
 	rz_return_val_if_fail(a && b, NULL);
@@ -202,6 +207,12 @@ RZ_API RZ_OWN RzDiff *rz_diff_bytes_new(RZ_BORROW const ut8 *a, ut32 a_size, RZ_
 		rz_diff_free(diff);
 		return NULL;
 	}
+	if (!ignore && RZ_MAX(a_size, b_size) >= DIFF_LARGE_BYTES_THRESHOLD) {
+		diff->large = true;
+		diff->b = b;
+		diff->b_size = b_size;
+		return diff;
+	}
 	if (!set_b(diff, b, b_size)) {
 		rz_diff_free(diff);
 		return NULL;
@@ -488,49 +499,27 @@ static int cmp_matches(RzDiffMatch *m0, RzDiffMatch *m1) {
 	return 0;
 }
 
-/**
- * \brief generates a list of matching blocks
- *
- * Generates a list of matching blocks that are found in both inputs.
- * If non are found it returns a match result with size of 0
- * */
-RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *diff) {
-	rz_return_val_if_fail(diff, NULL);
-	RzList *stack = NULL;
-	RzList *matches = NULL;
-	RzList *non_adjacent = NULL;
-	RzListIter *it = NULL;
-	Block *block = NULL;
+/* Appends to matches the longest blocks found in both A and B, see the top of this file */
+static bool ratcliff_matches(RzDiff *diff, RzList *matches) {
 	RzDiffMatch *match = NULL;
-	ut32 adj_a = 0, adj_b = 0, adj_size = 0;
-
-	matches = rz_list_newf((RzListFree)free);
-	if (!matches) {
-		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate matches\n");
-		goto rz_diff_matches_new_fail;
-	}
-	non_adjacent = rz_list_newf((RzListFree)free);
-	if (!matches) {
-		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate non_adjacent\n");
-		goto rz_diff_matches_new_fail;
-	}
-
-	stack = rz_list_newf((RzListFree)free);
+	Block *block = NULL;
+	RzList *stack = rz_list_newf((RzListFree)free);
 	if (!stack) {
 		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate stack\n");
-		goto rz_diff_matches_new_fail;
+		return false;
 	}
 
 	if (!stack_append_block(stack, 0, diff->a_size, 0, diff->b_size)) {
 		RZ_LOG_ERROR("rz_diff_matches_new: cannot append initial block "
 			     "into stack\n");
-		goto rz_diff_matches_new_fail;
+		goto ratcliff_matches_fail;
 	}
 
 	while (rz_list_length(stack) > 0) {
 		block = (Block *)rz_list_pop(stack);
 		match = find_longest_match(diff, block);
 		if (!match) {
+			free(block);
 			continue;
 		}
 
@@ -538,18 +527,18 @@ RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *d
 			if (!rz_list_append(matches, match)) {
 				RZ_LOG_ERROR("rz_diff_matches_new: cannot append match into matches\n");
 				free(match);
-				goto rz_diff_matches_new_fail;
+				goto ratcliff_matches_fail;
 			}
 			if (block->a_low < match->a && block->b_low < match->b) {
 				if (!stack_append_block(stack, block->a_low, match->a, block->b_low, match->b)) {
 					RZ_LOG_ERROR("rz_diff_matches_new: cannot append low block into stack\n");
-					goto rz_diff_matches_new_fail;
+					goto ratcliff_matches_fail;
 				}
 			}
 			if (match->a + match->size < block->a_hi && match->b + match->size < block->b_hi) {
 				if (!stack_append_block(stack, match->a + match->size, block->a_hi, match->b + match->size, block->b_hi)) {
 					RZ_LOG_ERROR("rz_diff_matches_new: cannot append high block into stack\n");
-					goto rz_diff_matches_new_fail;
+					goto ratcliff_matches_fail;
 				}
 			}
 		} else {
@@ -557,6 +546,47 @@ RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *d
 		}
 		free(block);
 	}
+	rz_list_free(stack);
+	return true;
+
+ratcliff_matches_fail:
+	free(block);
+	rz_list_free(stack);
+	return false;
+}
+
+/**
+ * \brief generates a list of matching blocks
+ *
+ * Generates a list of matching blocks that are found in both inputs.
+ * If non are found it returns a match result with size of 0
+ * */
+RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *diff) {
+	rz_return_val_if_fail(diff, NULL);
+	RzList *matches = NULL;
+	RzList *non_adjacent = NULL;
+	RzListIter *it = NULL;
+	RzDiffMatch *match = NULL;
+	ut32 adj_a = 0, adj_b = 0, adj_size = 0;
+
+	matches = rz_list_newf((RzListFree)free);
+	if (!matches) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate matches\n");
+		goto rz_diff_matches_new_fail;
+	}
+	non_adjacent = rz_list_newf((RzListFree)free);
+	if (!matches) {
+		RZ_LOG_ERROR("rz_diff_matches_new: cannot allocate non_adjacent\n");
+		goto rz_diff_matches_new_fail;
+	}
+
+	if (diff->large) {
+		if (!rz_diff_large_bytes_matches(diff->a, diff->a_size, diff->b, diff->b_size, matches)) {
+			goto rz_diff_matches_new_fail;
+		}
+	} else if (!ratcliff_matches(diff, matches)) {
+		goto rz_diff_matches_new_fail;
+	}
 	rz_list_sort(matches, (RzListComparator)cmp_matches);
 
 	adj_a = 0;
@@ -592,13 +622,11 @@ RZ_API RZ_OWN RzList /*<RzDiffMatch>*/ *rz_diff_matches_new(RZ_NONNULL RzDiff *d
 	}
 
 	rz_list_free(matches);
-	rz_list_free(stack);
 	return non_adjacent;
 
 rz_diff_matches_new_fail:
 	rz_list_free(non_adjacent);
 	rz_list_free(matches);
-	rz_list_free(stack);
 	return NULL;
 }
 
@@ -0,0 +1,14 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_DIFF_PRIVATE_H
+#define RZ_DIFF_PRIVATE_H
+
+#include <rz_diff.h>
+
+/* byte diffs where one of the inputs is at least this long use large_diff.c */
+#define DIFF_LARGE_BYTES_THRESHOLD 0x40000
+
+RZ_IPI bool rz_diff_large_bytes_matches(const ut8 *a, ut32 a_size, const ut8 *b, ut32 b_size, RzList /*<RzDiffMatch>*/ *matches);
+
+#endif /* RZ_DIFF_PRIVATE_H */
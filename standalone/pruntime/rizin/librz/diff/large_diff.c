@@ -0,0 +1,423 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/** \file large_diff.c
+ * Byte diff for large inputs.
+ *
+ * The Ratcliff/Obershelp implementation in diff.c keeps a list of positions
+ * for every byte of B and a map per byte of A, which does not scale past a
+ * few hundred KiB. Large inputs are instead:
+ * 1. split in content-defined chunks: a gear hash decides where chunks end,
+ *    so an insertion only changes the chunks around it;
+ * 2. chunks found exactly once in both A and B become anchors, of which the
+ *    longest sequence ordered the same way in A and B is kept;
+ * 3. the windows between the anchors are diffed with the linear space
+ *    variant of Myers' algorithm. When the edit script of a window is too
+ *    long to be found exactly, the window is split where the forward or the
+ *    reverse search got furthest and both halves are diffed again; only
+ *    windows that have next to nothing in common are left as a replace.
+ * The memory used is linear in the size of the inputs.
+ */
+
+#include "diff_private.h"
+#include <rz_util.h>
+#include <ht_uu.h>
+
+#define CHUNK_MIN      0x40
+#define CHUNK_MAX      0x2000
+#define CHUNK_MASK     0x3ff ///< about 1 KiB per chunk
+#define MYERS_MAX_COST 0x400
+
+typedef struct {
+	ut32 off;
+	ut32 size;
+	ut64 key; ///< hash and size of the chunk
+} Chunk;
+
+typedef struct {
+	ut32 a;
+	ut32 b;
+	ut32 size;
+} Anchor;
+
+typedef struct {
+	ut32 a_lo;
+	ut32 a_hi;
+	ut32 b_lo;
+	ut32 b_hi;
+	bool equal; ///< a match that is appended once the windows before it are done
+} Window;
+
+typedef struct {
+	const ut8 *a;
+	const ut8 *b;
+	RzList *matches;
+} Myers;
+
+static inline ut32 gear(ut8 c) {
+	ut32 h = c + 1;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static bool chunks_split(const ut8 *buf, ut32 size, RzVector /*<Chunk>*/ *chunks) {
+	ut32 h = 0, start = 0;
+	for (ut32 i = 0; i < size; i++) {
+		h = (h << 1) + gear(buf[i]);
+		ut32 len = i + 1 - start;
+		if ((len >= CHUNK_MIN && !(h & CHUNK_MASK)) || len >= CHUNK_MAX || i + 1 == size) {
+			Chunk *c = rz_vector_push(chunks, NULL);
+			if (!c) {
+				return false;
+			}
+			c->off = start;
+			c->size = len;
+			c->key = (ut64)rz_diff_hash_data(buf + start, len) << 32 | len;
+			start = i + 1;
+		}
+	}
+	return true;
+}
+
+// maps the key of every chunk to its index + 1, or to UT64_MAX when it is not unique
+static HtUU *chunks_index(RzVector /*<Chunk>*/ *chunks) {
+	HtUU *index = ht_uu_new0();
+	if (!index) {
+		return NULL;
+	}
+	ut64 i = 0;
+	Chunk *c;
+	rz_vector_foreach(chunks, c) {
+		i++;
+		if (!ht_uu_insert(index, c->key, i)) {
+			ht_uu_update(index, c->key, UT64_MAX);
+		}
+	}
+	return index;
+}
+
+static bool anchors_find(const ut8 *a, RzVector *a_chunks, const ut8 *b, RzVector *b_chunks, RzVector /*<Anchor>*/ *anchors) {
+	HtUU *a_index = chunks_index(a_chunks);
+	HtUU *b_index = chunks_index(b_chunks);
+	bool r = false;
+	if (!a_index || !b_index) {
+		goto beach;
+	}
+	ut64 i = 0;
+	Chunk *c;
+	rz_vector_foreach(a_chunks, c) {
+		i++;
+		ut64 j = ht_uu_find(b_index, c->key, NULL);
+		if (!j || j == UT64_MAX || ht_uu_find(a_index, c->key, NULL) != i) {
+			continue;
+		}
+		Chunk *c2 = rz_vector_index_ptr(b_chunks, j - 1);
+		if (memcmp(a + c->off, b + c2->off, c->size)) {
+			continue;
+		}
+		Anchor *anchor = rz_vector_push(anchors, NULL);
+		if (!anchor) {
+			goto beach;
+		}
+		anchor->a = c->off;
+		anchor->b = c2->off;
+		anchor->size = c->size;
+	}
+	r = true;
+beach:
+	ht_uu_free(a_index);
+	ht_uu_free(b_index);
+	return r;
+}
+
+// keeps the longest subsequence of anchors (ordered by A) that is also ordered by B
+static bool anchors_ordered(RzVector /*<Anchor>*/ *anchors) {
+	size_t n = rz_vector_len(anchors);
+	if (n < 2) {
+		return true;
+	}
+	Anchor *v = rz_vector_index_ptr(anchors, 0);
+	size_t *tails = RZ_NEWS(size_t, n);
+	size_t *prev = RZ_NEWS(size_t, n);
+	if (!tails || !prev) {
+		free(tails);
+		free(prev);
+		return false;
+	}
+	size_t i, len = 0;
+	for (i = 0; i < n; i++) {
+		size_t lo = 0, hi = len;
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (v[tails[mid]].b < v[i].b) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		prev[i] = lo ? tails[lo - 1] : SIZE_MAX;
+		tails[lo] = i;
+		if (lo == len) {
+			len++;
+		}
+	}
+	// walk back from the end of the longest sequence, filling the vector from its end
+	size_t k = tails[len - 1];
+	for (i = len; i > 0; i--) {
+		v[i - 1] = v[k];
+		k = prev[k];
+	}
+	free(tails);
+	free(prev);
+	rz_vector_remove_range(anchors, len, n - len, NULL);
+	return true;
+}
+
+static bool match_add(RzList *matches, ut32 a, ut32 b, ut32 size) {
+	RzDiffMatch *match = RZ_NEW0(RzDiffMatch);
+	if (!match) {
+		return false;
+	}
+	match->a = a;
+	match->b = b;
+	match->size = size;
+	if (!rz_list_append(matches, match)) {
+		free(match);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Finds the middle snake of a[a_lo:a_hi] and b[b_lo:b_hi], which splits the
+ * windows in two halves that can be diffed independently.
+ * When the edit script is longer than MYERS_MAX_COST * 2, the windows are
+ * split instead at the furthest point reached by the forward or the reverse
+ * search, so that at least one of the halves is diffed exactly. Returns false
+ * when even that point is mostly made of edits.
+ */
+static bool myers_bisect(Myers *m, ut32 a_lo, ut32 a_hi, ut32 b_lo, ut32 b_hi, ut32 *x, ut32 *y) {
+	const ut8 *a = m->a + a_lo, *b = m->b + b_lo;
+	const st64 n = a_hi - a_lo, mm = b_hi - b_lo;
+	const st64 max_d = RZ_MIN((n + mm + 1) / 2, MYERS_MAX_COST);
+	const st64 v_offset = max_d, v_length = 2 * max_d + 2;
+	const st64 delta = n - mm;
+	const bool front = delta & 1;
+	st64 k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+	st64 d, k1, k2, x1, y1, x2, y2;
+	st64 fx = 0, fy = 0, rx = 0, ry = 0; ///< furthest points of both searches
+	bool found = false;
+
+	st64 *v1 = RZ_NEWS(st64, v_length * 2);
+	if (!v1) {
+		return false;
+	}
+	st64 *v2 = v1 + v_length;
+	for (d = 0; d < v_length * 2; d++) {
+		v1[d] = -1;
+	}
+	v1[v_offset + 1] = 0;
+	v2[v_offset + 1] = 0;
+	for (d = 0; d < max_d && !found; d++) {
+		// walk the forward path one step
+		for (k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+			st64 k1_offset = v_offset + k1;
+			if (k1 == -d || (k1 != d && v1[k1_offset - 1] < v1[k1_offset + 1])) {
+				x1 = v1[k1_offset + 1];
+			} else {
+				x1 = v1[k1_offset - 1] + 1;
+			}
+			y1 = x1 - k1;
+			while (x1 < n && y1 < mm && a[x1] == b[y1]) {
+				x1++;
+				y1++;
+			}
+			v1[k1_offset] = x1;
+			if (x1 > n) {
+				k1end += 2;
+			} else if (y1 > mm) {
+				k1start += 2;
+			} else {
+				if (y1 >= 0 && x1 + y1 > fx + fy) {
+					fx = x1;
+					fy = y1;
+				}
+				if (front) {
+					st64 k2_offset = v_offset + delta - k1;
+					if (k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1 && x1 >= n - v2[k2_offset]) {
+						*x = x1;
+						*y = y1;
+						found = true;
+						break;
+					}
+				}
+			}
+		}
+		if (found) {
+			break;
+		}
+		// walk the reverse path one step
+		for (k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+			st64 k2_offset = v_offset + k2;
+			if (k2 == -d || (k2 != d && v2[k2_offset - 1] < v2[k2_offset + 1])) {
+				x2 = v2[k2_offset + 1];
+			} else {
+				x2 = v2[k2_offset - 1] + 1;
+			}
+			y2 = x2 - k2;
+			while (x2 < n && y2 < mm && a[n - x2 - 1] == b[mm - y2 - 1]) {
+				x2++;
+				y2++;
+			}
+			v2[k2_offset] = x2;
+			if (x2 > n) {
+				k2end += 2;
+			} else if (y2 > mm) {
+				k2start += 2;
+			} else {
+				if (y2 >= 0 && x2 + y2 > rx + ry) {
+					rx = x2;
+					ry = y2;
+				}
+				if (!front) {
+					st64 k1_offset = v_offset + delta - k2;
+					if (k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+						x1 = v1[k1_offset];
+						y1 = v_offset + x1 - k1_offset;
+						if (x1 >= n - x2) {
+							*x = x1;
+							*y = y1;
+							found = true;
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+	free(v1);
+	if (found) {
+		return true;
+	}
+	// a path of at most max_d edits reaching x + y has (x + y - max_d) / 2 matches
+	if (RZ_MAX(fx + fy, rx + ry) <= max_d + max_d / 2) {
+		return false;
+	}
+	if (fx + fy >= rx + ry) {
+		*x = fx;
+		*y = fy;
+	} else {
+		*x = n - rx;
+		*y = mm - ry;
+	}
+	return true;
+}
+
+static bool window_push(RzVector /*<Window>*/ *windows, ut32 a_lo, ut32 a_hi, ut32 b_lo, ut32 b_hi, bool equal) {
+	Window *w = rz_vector_push(windows, NULL);
+	if (!w) {
+		return false;
+	}
+	w->a_lo = a_lo;
+	w->a_hi = a_hi;
+	w->b_lo = b_lo;
+	w->b_hi = b_hi;
+	w->equal = equal;
+	return true;
+}
+
+/**
+ * Diffs a[a_lo:a_hi] and b[b_lo:b_hi]. The halves left to diff are kept on a
+ * stack rather than recursed into, since a chain of splits made once the
+ * edit script is too long can be as long as the window.
+ */
+static bool myers_diff(Myers *m, ut32 a_lo, ut32 a_hi, ut32 b_lo, ut32 b_hi) {
+	RzVector windows;
+	Window w;
+	bool r = false;
+	rz_vector_init(&windows, sizeof(Window), NULL, NULL);
+	if (!window_push(&windows, a_lo, a_hi, b_lo, b_hi, false)) {
+		goto beach;
+	}
+	while (!rz_vector_empty(&windows)) {
+		rz_vector_pop(&windows, &w);
+		if (w.equal) {
+			if (!match_add(m->matches, w.a_lo, w.b_lo, w.a_hi - w.a_lo)) {
+				goto beach;
+			}
+			continue;
+		}
+		ut32 prefix = 0, suffix = 0;
+		while (w.a_lo + prefix < w.a_hi && w.b_lo + prefix < w.b_hi && m->a[w.a_lo + prefix] == m->b[w.b_lo + prefix]) {
+			prefix++;
+		}
+		if (prefix && !match_add(m->matches, w.a_lo, w.b_lo, prefix)) {
+			goto beach;
+		}
+		w.a_lo += prefix;
+		w.b_lo += prefix;
+		while (w.a_hi - suffix > w.a_lo && w.b_hi - suffix > w.b_lo && m->a[w.a_hi - suffix - 1] == m->b[w.b_hi - suffix - 1]) {
+			suffix++;
+		}
+		w.a_hi -= suffix;
+		w.b_hi -= suffix;
+		if (suffix && !window_push(&windows, w.a_hi, w.a_hi + suffix, w.b_hi, w.b_hi + suffix, true)) {
+			goto beach;
+		}
+
+		ut32 x, y;
+		// a split at either end would not make the windows any smaller
+		if (w.a_lo < w.a_hi && w.b_lo < w.b_hi && myers_bisect(m, w.a_lo, w.a_hi, w.b_lo, w.b_hi, &x, &y) &&
+			(x || y) && (x < w.a_hi - w.a_lo || y < w.b_hi - w.b_lo)) {
+			if (!window_push(&windows, w.a_lo + x, w.a_hi, w.b_lo + y, w.b_hi, false) ||
+				!window_push(&windows, w.a_lo, w.a_lo + x, w.b_lo, w.b_lo + y, false)) {
+				goto beach;
+			}
+		}
+	}
+	r = true;
+beach:
+	rz_vector_fini(&windows);
+	return r;
+}
+
+/**
+ * \brief Appends to \p matches the blocks found in both \p a and \p b
+ *
+ * The matches are ordered and never overlap, but adjacent ones are not merged.
+ */
+RZ_IPI bool rz_diff_large_bytes_matches(const ut8 *a, ut32 a_size, const ut8 *b, ut32 b_size, RzList /*<RzDiffMatch>*/ *matches) {
+	RzVector a_chunks, b_chunks, anchors;
+	Myers m = { a, b, matches };
+	bool r = false;
+
+	rz_vector_init(&a_chunks, sizeof(Chunk), NULL, NULL);
+	rz_vector_init(&b_chunks, sizeof(Chunk), NULL, NULL);
+	rz_vector_init(&anchors, sizeof(Anchor), NULL, NULL);
+	if (!chunks_split(a, a_size, &a_chunks) || !chunks_split(b, b_size, &b_chunks) ||
+		!anchors_find(a, &a_chunks, b, &b_chunks, &anchors) || !anchors_ordered(&anchors)) {
+		RZ_LOG_ERROR("rz_diff_large_bytes_matches: cannot find anchors\n");
+		goto beach;
+	}
+
+	ut32 a_pos = 0, b_pos = 0;
+	Anchor *anchor;
+	rz_vector_foreach(&anchors, anchor) {
+		if (!myers_diff(&m, a_pos, anchor->a, b_pos, anchor->b) ||
+			!match_add(matches, anchor->a, anchor->b, anchor->size)) {
+			goto beach;
+		}
+		a_pos = anchor->a + anchor->size;
+		b_pos = anchor->b + anchor->size;
+	}
+	r = myers_diff(&m, a_pos, a_size, b_pos, b_size);
+beach:
+	rz_vector_fini(&a_chunks);
+	rz_vector_fini(&b_chunks);
+	rz_vector_fini(&anchors);
+	return r;
+}
@@ -535,6 +535,7 @@ typedef struct rz_analysis_options_t {
 	bool delay;
 	int tailcall;
 	bool retpoline;
+	bool op_arena; // analysis.arena
 } RzAnalysisOptions;
 
 typedef enum {
@@ -625,6 +626,8 @@ typedef struct rz_analysis_t {
 	RzArchPlatformTarget *platform_target;
 	HtPP *ht_global_var; // global variables
 	RBTree global_var_tree; // global variables by address. must not overlap
+	RzArena *op_arena; // temporaries of the RzAnalysisOps created inside rz_analysis_op_arena_begin/end
+	int op_arena_depth;
 } RzAnalysis;
 
 typedef enum rz_analysis_addr_hint_type_t {
@@ -845,6 +848,7 @@ typedef struct rz_analysis_op_t {
 	RzAnalysisSwitchOp *switch_op;
 	RzAnalysisHint hint;
 	RzAnalysisDataType datatype;
+	RzArena *arena; /* if set, mnemonic, src, dst and access live in this arena */
 } RzAnalysisOp;
 
 #define RZ_TYPE_COND_SINGLE(x) (!x->arg[1] || x->arg[0] == x->arg[1])
@@ -1219,6 +1223,7 @@ RZ_API RzAnalysisType *rz_analysis_type_loadfile(RzAnalysis *a, const char *path
 /* block.c */
 typedef bool (*RzAnalysisBlockCb)(RzAnalysisBlock *block, void *user);
 typedef bool (*RzAnalysisAddrCb)(ut64 addr, void *user);
+typedef bool (*RzAnalysisFunctionCb)(RzAnalysisFunction *fcn, void *user);
 
 // lifetime
 RZ_API void rz_analysis_block_ref(RzAnalysisBlock *bb);
@@ -1337,6 +1342,12 @@ RZ_API RzAnalysisFunction *rz_analysis_create_function(RzAnalysis *analysis, con
 // returns all functions that have a basic block containing the given address
 RZ_API RzList *rz_analysis_get_functions_in(RzAnalysis *analysis, ut64 addr);
 
+// calls cb for the functions of rz_analysis_get_functions_in() without allocating a list
+RZ_API bool rz_analysis_functions_foreach_in(RzAnalysis *analysis, ut64 addr, RzAnalysisFunctionCb cb, void *user);
+
+// returns the first function of rz_analysis_get_functions_in() or NULL
+RZ_API RZ_BORROW RzAnalysisFunction *rz_analysis_first_function_in(RzAnalysis *analysis, ut64 addr);
+
 // returns the function that has its entrypoint at addr or NULL
 RZ_API RzAnalysisFunction *rz_analysis_get_function_at(RzAnalysis *analysis, ut64 addr);
 
@@ -1417,6 +1428,13 @@ RZ_API RzList *rz_analysis_op_list_new(void);
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
 RZ_API RzAnalysisOp *rz_analysis_op_hexstr(RzAnalysis *analysis, ut64 addr, const char *hexstr);
 RZ_API char *rz_analysis_op_to_string(RzAnalysis *analysis, RzAnalysisOp *op);
+RZ_API bool rz_analysis_op_arena_begin(RzAnalysis *analysis, RzArenaMark *mark);
+RZ_API void rz_analysis_op_arena_release(RzAnalysis *analysis, RzArenaMark *mark);
+RZ_API void rz_analysis_op_arena_end(RzAnalysis *analysis, RzArenaMark *mark);
+RZ_API RzAnalysisValue *rz_analysis_op_value_new(RzAnalysisOp *op);
+RZ_API char *rz_analysis_op_strdup(RzAnalysisOp *op, const char *s);
+RZ_API char *rz_analysis_op_newf(RzAnalysisOp *op, const char *fmt, ...) RZ_PRINTF_CHECK(2, 3);
+RZ_API bool rz_analysis_op_access_add(RzAnalysisOp *op, RzAnalysisValue *val);
 
 RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned int addrsize);
 RZ_API bool rz_analysis_esil_set_pc(RzAnalysisEsil *esil, ut64 addr);
@@ -1581,6 +1599,7 @@ RZ_API RzList *rz_analysis_function_get_xrefs_to(RzAnalysisFunction *fcn);
 RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to);
+RZ_API void rz_analysis_xrefs_del_from(RzAnalysis *analysis, ut64 from, RzAnalysisXRefType type);
 
 RZ_API RzList *rz_analysis_get_fcns(RzAnalysis *analysis);
 
@@ -2103,6 +2122,7 @@ RZ_API bool rz_serialize_analysis_global_var_load(RZ_NONNULL Sdb *db, RZ_NONNULL
 RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res);
 
 typedef void *RzSerializeAnalVarParser;
+RZ_API void rz_serialize_analysis_var_save(RZ_NONNULL PJ *j, RZ_NONNULL RzAnalysisVar *var);
 RZ_API RzSerializeAnalVarParser rz_serialize_analysis_var_parser_new(void);
 RZ_API void rz_serialize_analysis_var_parser_free(RzSerializeAnalVarParser parser);
 RZ_API RZ_NULLABLE RzAnalysisVar *rz_serialize_analysis_var_load(RZ_NONNULL RzAnalysisFunction *fcn, RZ_NONNULL RzSerializeAnalVarParser parser, RZ_NONNULL const RzJson *json);
@@ -292,6 +292,8 @@ typedef struct rz_bin_object_t {
 	int lang;
 	RZ_DEPRECATE Sdb *kv; ///< deprecated, put info in C structures instead of this
 	HtUP *addrzklassmethod;
+	RzBinFile *bf; ///< file the object was loaded from, used to compute the lazy items
+	ut64 lazy_items; ///< RZ_BIN_REQ_* items deferred by RzBin.lazy and not computed yet
 	void *bin_obj; // internal pointer used by formats
 } RzBinObject;
 
@@ -362,6 +364,7 @@ struct rz_bin_t {
 	char *prefix; // bin.prefix
 	char *strenc;
 	ut64 filter_rules;
+	bool lazy; ///< compute strings and classes the first time they are asked for instead of at load
 	bool demanglercmd;
 	bool verbose;
 	bool use_xtr; // use extract plugins when loading a file?
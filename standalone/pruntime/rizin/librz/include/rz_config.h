@@ -44,6 +44,7 @@ typedef struct rz_config_t {
 	RzNum *num;
 	RzList *nodes;
 	HtPP *ht;
+	ut64 generation; ///< Incremented on every write, lets consumers cache values derived from the config
 } RzConfig;
 
 typedef struct rz_config_hold_num_t {
@@ -59,6 +59,7 @@ extern "C" {
 #define RZ_CONS_GREP_WORDS     10
 #define RZ_CONS_GREP_WORD_SIZE 64
 #define RZ_CONS_GREP_TOKENS    64
+#define RZ_CONS_GREP_STREAM    (64 * 1024) ///< bytes of output collected before a streaming grep filters them
 
 RZ_LIB_VERSION_HEADER(rz_cons);
 
@@ -108,6 +109,17 @@ typedef struct rz_cons_grep_t {
 	int icase;
 } RzConsGrep;
 
+/**
+ * \brief Grep applied to the output lines while a command prints them
+ */
+typedef struct rz_cons_grep_stream_t {
+	RzConsGrep grep;
+	size_t pos; ///< buffer offset up to which the output was filtered
+	size_t next; ///< buffer length at which the output is filtered again
+	int depth; ///< size of the cons stack when the stream began
+	int lines; ///< lines kept so far
+} RzConsGrepStream;
+
 #if 0
 // TODO Might be better than using rz_cons_pal_get_i
 // And have smaller RzConsPrintablePalette and RzConsPalette
@@ -461,6 +473,7 @@ typedef enum {
 
 typedef struct rz_cons_context_t {
 	RzConsGrep grep;
+	RzConsGrepStream *grep_stream;
 	RzStack *cons_stack;
 	char *buffer;
 	size_t buffer_len;
@@ -991,6 +1004,8 @@ RZ_API char *rz_cons_grep_strip(char *cmd, const char *quotestr);
 RZ_API void rz_cons_grep_process(char *grep);
 RZ_API int rz_cons_grep_line(char *buf, int len); // must be static
 RZ_API void rz_cons_grepbuf(void);
+RZ_API bool rz_cons_grep_stream_begin(const char *grep);
+RZ_API void rz_cons_grep_stream_end(void);
 
 RZ_API void rz_cons_rgb(ut8 r, ut8 g, ut8 b, ut8 a);
 RZ_API void rz_cons_rgb_init(void);
@@ -269,6 +269,17 @@ typedef struct rz_core_seek_history_t {
 	RzCoreSeekItem saved_item; ///< Position to save in history
 } RzCoreSeekHistory;
 
+typedef struct rz_core_analysis_cache_t {
+	Sdb *db; ///< functions cached in analysis.cache.dir, open while aa runs
+	ut32 config; ///< hash of the level and options the cached functions depend on
+	ut64 hits; ///< functions restored from the cache
+	ut64 misses; ///< function lookups that found nothing usable
+	ut64 stores; ///< cache entries added
+} RzCoreAnalysisCache;
+
+typedef struct rz_core_disasm_config_t RzCoreDisasmConfig;
+typedef struct rz_core_cmd_cache_t RzCoreCmdCache;
+
 struct rz_core_t {
 	RzBin *bin;
 	RzList *plugins; ///< List of registered core plugins
@@ -360,6 +371,9 @@ struct rz_core_t {
 	bool use_tree_sitter_rzcmd;
 	bool use_rzshell_autocompletion;
 	RzCoreSeekHistory seek_history;
+	RzCoreAnalysisCache analysis_cache;
+	RzCoreDisasmConfig *disasm_config; ///< disassembler settings read from config, see disasm.c
+	RzCoreCmdCache *cmd_cache; ///< parse trees of the last commands, see cmd.c
 
 	bool marks_init;
 	ut64 marks[UT8_MAX + 1];
@@ -690,6 +704,15 @@ RZ_API bool rz_core_analysis_graph(RzCore *core, ut64 addr, int opts);
 RZ_API RzList *rz_core_analysis_graph_to(RzCore *core, ut64 addr, int n);
 RZ_API int rz_core_analysis_all(RzCore *core);
 RZ_API bool rz_core_analysis_everything(RzCore *core, bool experimental, char *dh_orig);
+
+/* analysis_cache.c */
+RZ_API RZ_OWN char *rz_core_analysis_cache_key(RzCore *core);
+RZ_API RZ_OWN char *rz_core_analysis_cache_path(RzCore *core, const char *name);
+RZ_API bool rz_core_analysis_cache_open(RzCore *core, const char *level);
+RZ_API void rz_core_analysis_cache_close(RzCore *core, bool store);
+RZ_API bool rz_core_analysis_cache_function_load(RzCore *core, RzAnalysisFunction *fcn, int reftype);
+RZ_API bool rz_core_analysis_cache_function_save(RzCore *core, RzAnalysisFunction *fcn);
+
 RZ_API RzList *rz_core_analysis_cycles(RzCore *core, int ccl);
 RZ_API RzList *rz_core_analysis_fcn_get_calls(RzCore *core, RzAnalysisFunction *fcn); // get all calls from a function
 RZ_API void rz_cmd_analysis_calls(RzCore *core, const char *input, bool printCommands, bool importsOnly);
@@ -947,6 +970,7 @@ RZ_API void rz_core_rtr_session(RzCore *core, const char *input);
 RZ_API void rz_core_rtr_cmd(RzCore *core, const char *input);
 RZ_API int rz_core_rtr_http(RzCore *core, int launch, int browse, const char *path);
 RZ_API int rz_core_rtr_http_stop(RzCore *u);
+RZ_API bool rz_core_rtr_http_bench(RzCore *core, const char *args);
 RZ_API int rz_core_rtr_gdb(RzCore *core, int launch, const char *path);
 
 RZ_API int rz_core_visual_prevopsz(RzCore *core, ut64 addr);
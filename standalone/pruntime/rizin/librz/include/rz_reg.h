@@ -113,6 +113,25 @@ typedef struct rz_reg_set_t {
 	int maskregstype; /* which type of regs have this reg set (logic mask with RzRegisterType  RZ_REG_TYPE_XXX) */
 } RzRegSet;
 
+/**
+ * Stable integer identifier of a register, valid until the profile changes.
+ * Handles are the index of the RzRegItem (see rz_reg_reindex()).
+ */
+typedef int RzRegHandle;
+#define RZ_REG_HANDLE_INVALID -1
+
+/**
+ * Precomputed location of a register in its arena,
+ * used to read and write it without going through its name.
+ */
+typedef struct rz_reg_access_t {
+	RzRegItem *item;
+	int arena; ///< regset holding the register
+	int off; ///< byte offset inside the arena
+	int bytes; ///< 1, 2, 4 or 8 if the register can be accessed directly, 0 otherwise
+	bool ro; ///< listed in roregs
+} RzRegAccess;
+
 typedef struct rz_reg_t {
 	char *profile;
 	char *reg_profile_cmt;
@@ -121,6 +140,9 @@ typedef struct rz_reg_t {
 	RzRegSet regset[RZ_REG_TYPE_LAST];
 	RzList *allregs;
 	RzList *roregs;
+	HtPP *ht_handles; /* name or role alias:RzRegItem, all types at once */
+	RzRegAccess *access; /* indexed by RzRegHandle */
+	int access_count;
 	int iters;
 	int arch;
 	int bits;
@@ -165,6 +187,13 @@ RZ_API RzRegItem *rz_reg_next_diff(RzReg *reg, int type, const ut8 *buf, int buf
 
 RZ_API void rz_reg_reindex(RzReg *reg);
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx);
+RZ_API void rz_reg_set_roregs(RzReg *reg, RZ_OWN RzList *roregs);
+
+/* handles */
+RZ_API RzRegHandle rz_reg_handle(RzReg *reg, const char *name);
+RZ_API RzRegItem *rz_reg_handle_item(RzReg *reg, RzRegHandle handle);
+RZ_API ut64 rz_reg_handle_get_value(RzReg *reg, RzRegHandle handle);
+RZ_API bool rz_reg_handle_set_value(RzReg *reg, RzRegHandle handle, ut64 value);
 
 /* Item */
 RZ_API void rz_reg_item_free(RzRegItem *item);
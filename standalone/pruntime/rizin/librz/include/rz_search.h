@@ -23,6 +23,7 @@ enum {
 	RZ_SEARCH_PRIV_KEY,
 	RZ_SEARCH_DELTAKEY,
 	RZ_SEARCH_MAGIC,
+	RZ_SEARCH_MULTI,
 	RZ_SEARCH_LAST
 };
 
@@ -51,6 +52,8 @@ typedef struct rz_search_hit_t {
 
 typedef int (*RzSearchCallback)(RzSearchKeyword *kw, void *user, ut64 where);
 
+typedef struct rz_search_multi_t RzSearchMulti;
+
 typedef struct rz_search_t {
 	int n_kws; // hit${n_kws}_${count}
 	int mode;
@@ -72,6 +75,8 @@ typedef struct rz_search_t {
 	RzList *kws; // TODO: Use rz_search_kw_new ()
 	RzIOBind iob;
 	char bckwrds;
+	RzSearchMulti *multi; // matcher compiled from kws for RZ_SEARCH_MULTI, built on first use
+	RzPVector /*<RzRegex>*/ *regexes; // kws compiled for RZ_SEARCH_REGEXP, built on first use
 } RzSearch;
 
 #ifdef RZ_API
@@ -110,6 +115,7 @@ RZ_API int rz_search_bmh(const RzSearchKeyword *kw, const ut64 from, const ut8 *
 
 // TODO: is this an internal API?
 RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len);
+RZ_API int rz_search_multi_update(RzSearch *s, ut64 from, const ut8 *buf, int len);
 RZ_API int rz_search_aes_update(RzSearch *s, ut64 from, const ut8 *buf, int len);
 RZ_API int rz_search_privkey_update(RzSearch *s, ut64 from, const ut8 *buf, int len);
 RZ_API int rz_search_magic_update(RzSearch *_s, ut64 from, const ut8 *buf, int len);
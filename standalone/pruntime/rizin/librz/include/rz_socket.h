@@ -4,6 +4,7 @@
 #include "rz_types.h"
 #include "rz_bind.h"
 #include "rz_list.h"
+#include "rz_vector.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,8 +56,37 @@ typedef struct {
 	int output[2];
 #endif
 	RzCoreBind coreb;
+	bool framed; ///< commands are sent as RzPipeFrame, see rzpipe_framed()
+	ut32 next_id; ///< id of the last request frame sent
 } RzPipe;
 
+/* framed rzpipe protocol */
+#define RZPIPE_FRAME_MAGIC       0xfd
+#define RZPIPE_FRAME_HEADER_SIZE 12
+#define RZPIPE_FRAME_MAX         (256 * 1024 * 1024) ///< larger payloads are considered a corrupted stream
+
+typedef enum {
+	RZPIPE_FRAME_CMD = 1, ///< a command, answered by a RESULT frame with the same id
+	RZPIPE_FRAME_BATCH, ///< several commands, answered by a single BATCH_RESULT frame
+	RZPIPE_FRAME_RESULT, ///< output of a command
+	RZPIPE_FRAME_BATCH_RESULT, ///< outputs of a batch, in the order of the commands
+	RZPIPE_FRAME_ERROR, ///< the request could not be understood, or its result is larger than RZPIPE_FRAME_MAX
+} RzPipeFrameType;
+
+/**
+ * A frame is a 12 bytes header (ut8 magic, ut8 type, ut16 reserved, ut32 id
+ * and ut32 payload size, little endian) followed by the payload. Batch
+ * payloads are a ut32 count followed by count ut32 length-prefixed strings.
+ */
+typedef struct rzpipe_frame_t {
+	RzPipeFrameType type;
+	ut32 id;
+	ut32 size;
+	ut8 *data; ///< payload, always followed by a NUL byte not counted in size
+} RzPipeFrame;
+
+typedef char *(*RzPipeFrameCmd)(void *user, const char *cmd);
+
 typedef struct rz_socket_t {
 #ifdef _MSC_VER
 	SOCKET fd;
@@ -151,12 +181,36 @@ typedef struct rz_socket_http_request {
 	ut8 *data;
 	int data_length;
 	bool auth;
+	bool keep_alive; ///< the connection stays open after the response
+	int minor_version; ///< x of the HTTP/1.x of the request, answered with the same version
 } RzSocketHTTPRequest;
 
+/**
+ * Serves the requests of several clients from a single thread: new
+ * connections and keep-alive connections waiting for their next request
+ * are polled together.
+ */
+typedef struct rz_socket_http_server_t {
+	RzSocket *s; ///< listening socket, not owned
+	RzSocketHTTPOptions *so;
+	RzVector /*<RzSocketHTTPIdle>*/ idle; ///< keep-alive connections between two requests
+} RzSocketHTTPServer;
+
+typedef struct rz_socket_http_bench_t {
+	int ok; ///< requests answered with a 200
+	int failed;
+	double seconds;
+} RzSocketHTTPBench;
+
 RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptions *so);
 RZ_API void rz_socket_http_response(RzSocketHTTPRequest *rs, int code, const char *out, int x, const char *headers);
 RZ_API void rz_socket_http_close(RzSocketHTTPRequest *rs);
 RZ_API ut8 *rz_socket_http_handle_upload(const ut8 *str, int len, int *olen);
+RZ_API RzSocketHTTPServer *rz_socket_http_server_new(RzSocket *s, RzSocketHTTPOptions *so);
+RZ_API void rz_socket_http_server_free(RzSocketHTTPServer *hs);
+RZ_API RzSocketHTTPRequest *rz_socket_http_server_accept(RzSocketHTTPServer *hs, int timeout);
+RZ_API void rz_socket_http_server_done(RzSocketHTTPServer *hs, RzSocketHTTPRequest *rs);
+RZ_API bool rz_socket_http_bench(const char *host, const char *port, const char *path, int requests, int conns, RzSocketHTTPBench *res);
 
 typedef int (*rap_server_open)(void *user, const char *file, int flg, int mode);
 typedef int (*rap_server_seek)(void *user, ut64 offset, int whence);
@@ -279,6 +333,17 @@ RZ_API RzPipe *rzpipe_open(const char *cmd);
 RZ_API RzPipe *rzpipe_open_dl(const char *file);
 RZ_API char *rzpipe_cmd(RzPipe *rzpipe, const char *str);
 RZ_API char *rzpipe_cmdf(RzPipe *rzpipe, const char *fmt, ...) RZ_PRINTF_CHECK(2, 3);
+RZ_API bool rzpipe_framed(RzPipe *rzpipe);
+RZ_API ut32 rzpipe_send(RzPipe *rzpipe, const char *str);
+RZ_API ut32 rzpipe_send_batch(RzPipe *rzpipe, RzPVector *cmds);
+RZ_API RzPipeFrame *rzpipe_recv(RzPipe *rzpipe);
+
+RZ_API RzPipeFrame *rzpipe_frame_read(int fd);
+RZ_API bool rzpipe_frame_write(int fd, RzPipeFrameType type, ut32 id, const ut8 *data, ut32 size);
+RZ_API void rzpipe_frame_free(RzPipeFrame *frame);
+RZ_API ut8 *rzpipe_batch_pack(RzPVector *strs, ut32 *size);
+RZ_API RzPVector *rzpipe_batch_unpack(const ut8 *data, ut32 size);
+RZ_API bool rzpipe_frame_serve(int in, int out, RzPipeFrameCmd cmd, void *user);
 #endif
 
 #ifdef __cplusplus
@@ -52,6 +52,7 @@ typedef enum { RZ_TH_FREED = -1,
 	RZ_TH_STOP = 0,
 	RZ_TH_REPEAT = 1 } RzThreadFunctionRet;
 #define RZ_TH_FUNCTION(x) RzThreadFunctionRet (*x)(struct rz_th_t *)
+typedef void (*RzThreadIterCb)(void *user, size_t i);
 
 #ifdef __cplusplus
 extern "C" {
@@ -98,6 +99,8 @@ RZ_API RZ_TH_TID rz_th_self(void);
 RZ_API bool rz_th_setname(RzThread *th, const char *name);
 RZ_API bool rz_th_getname(RzThread *th, char *name, size_t len);
 RZ_API bool rz_th_setaffinity(RzThread *th, int cpuid);
+RZ_API size_t rz_th_logical_core_number(void);
+RZ_API void rz_th_parallel_for(size_t n, RzThreadIterCb fn, void *user);
 
 RZ_API RzThreadSemaphore *rz_th_sem_new(unsigned int initial);
 RZ_API void rz_th_sem_free(RzThreadSemaphore *sem);
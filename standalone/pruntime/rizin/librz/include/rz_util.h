@@ -32,6 +32,7 @@ int gettimeofday(struct timeval *p, void *tz);
 #include "rz_util/rz_itv.h"
 #include "rz_util/rz_signal.h"
 #include "rz_util/rz_alloc.h"
+#include "rz_util/rz_arena.h"
 #include "rz_util/rz_rbtree.h"
 #include "rz_util/rz_intervaltree.h"
 #include "rz_util/rz_big.h"
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_ARENA_H
+#define RZ_ARENA_H
+
+#include <rz_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RzArena is a bump allocator for short-lived objects.
+ *
+ * Memory is handed out linearly from big chunks and is never freed
+ * piecewise: everything allocated after a given RzArenaMark is dropped
+ * at once with rz_arena_release(), which is O(1) and keeps the chunks
+ * around for the next round. This makes it a good fit for loops that
+ * create and destroy the same kind of temporaries over and over.
+ *
+ * Marks must be released in LIFO order, like a stack.
+ */
+
+typedef struct rz_arena_chunk_t RzArenaChunk;
+
+typedef struct rz_arena_mark_t {
+	RzArenaChunk *chunk;
+	size_t used;
+	size_t in_use;
+} RzArenaMark;
+
+typedef struct rz_arena_stats_t {
+	ut64 allocs; ///< allocations served from the arena
+	ut64 bytes; ///< bytes served from the arena
+	ut64 chunks; ///< chunks requested from the system allocator
+	ut64 releases; ///< number of rz_arena_release()/rz_arena_reset() calls
+	size_t peak; ///< highest amount of bytes in use at the same time
+} RzArenaStats;
+
+typedef struct rz_arena_t {
+	RzArenaChunk *head; ///< first chunk, never freed before rz_arena_free()
+	RzArenaChunk *cur; ///< chunk where the next allocation is attempted
+	size_t used; ///< bytes used in the current chunk
+	size_t chunk_size; ///< default size of new chunks
+	size_t in_use; ///< bytes currently handed out (including padding)
+	RzArenaStats stats;
+} RzArena;
+
+RZ_API RzArena *rz_arena_new(size_t chunk_size);
+RZ_API void rz_arena_free(RzArena *arena);
+RZ_API void *rz_arena_alloc(RzArena *arena, size_t size);
+RZ_API void *rz_arena_calloc(RzArena *arena, size_t count, size_t size);
+RZ_API char *rz_arena_strdup(RzArena *arena, const char *s);
+RZ_API char *rz_arena_strndup(RzArena *arena, const char *s, size_t n);
+RZ_API char *rz_arena_vnewf(RzArena *arena, const char *fmt, va_list ap);
+RZ_API char *rz_arena_newf(RzArena *arena, const char *fmt, ...) RZ_PRINTF_CHECK(2, 3);
+RZ_API RzArenaMark rz_arena_mark(RzArena *arena);
+RZ_API void rz_arena_release(RzArena *arena, RzArenaMark mark);
+RZ_API void rz_arena_reset(RzArena *arena);
+RZ_API bool rz_arena_contains(RzArena *arena, const void *ptr);
+
+#define RZ_ARENA_NEW(arena, x)  (x *)rz_arena_alloc(arena, sizeof(x))
+#define RZ_ARENA_NEW0(arena, x) (x *)rz_arena_calloc(arena, 1, sizeof(x))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //  RZ_ARENA_H
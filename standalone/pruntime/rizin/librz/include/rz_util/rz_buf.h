@@ -23,6 +23,7 @@ typedef bool (*RzBufferResize)(RzBuffer *b, ut64 newsize);
 typedef st64 (*RzBufferSeek)(RzBuffer *b, st64 addr, int whence);
 typedef ut8 *(*RzBufferGetWholeBuf)(RzBuffer *b, ut64 *sz);
 typedef void (*RzBufferFreeWholeBuf)(RzBuffer *b);
+typedef const ut8 *(*RzBufferGetView)(RzBuffer *b, ut64 *sz);
 typedef RzList *(*RzBufferNonEmptyList)(RzBuffer *b);
 
 typedef struct rz_buffer_methods_t {
@@ -35,6 +36,7 @@ typedef struct rz_buffer_methods_t {
 	RzBufferSeek seek;
 	RzBufferGetWholeBuf get_whole_buf;
 	RzBufferFreeWholeBuf free_whole_buf;
+	RzBufferGetView get_view; ///< contiguous bytes of the buffer without copies, NULL if they are not in memory
 } RzBufferMethods;
 
 struct rz_buf_t {
@@ -144,6 +146,7 @@ RZ_API void rz_buf_free(RzBuffer *b);
 RZ_API void rz_buf_set_overflow_byte(RZ_NONNULL RzBuffer *b, ut8 Oxff);
 
 RZ_DEPRECATE RZ_API RZ_BORROW const ut8 *rz_buf_data(RZ_NONNULL RzBuffer *b, ut64 *size);
+RZ_API RZ_BORROW const ut8 *rz_buf_view(RZ_NONNULL RzBuffer *b, RZ_NONNULL RZ_OUT ut64 *size);
 
 RZ_API st64 rz_buf_uleb128(RzBuffer *b, ut64 *v);
 RZ_API st64 rz_buf_sleb128(RzBuffer *b, st64 *v);
@@ -6,7 +6,9 @@
 #define RZ_JSON_H
 
 #include <rz_types.h>
+#include <rz_vector.h>
 #include <rz_util/pj.h>
+#include <ht_pp.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,8 +25,14 @@ extern "C" {
  * removing the need to copy them.
  *
  * It also supports both line and block style comments.
+ *
+ * To only extract a few values, RzJsonReader and RzJsonPath walk through
+ * the text without building a tree and without modifying it.
  */
 
+// objects with more properties than this get their keys hashed
+#define RZ_JSON_HASH_MIN 8
+
 typedef enum rz_json_type_t {
 	RZ_JSON_NULL,
 	RZ_JSON_OBJECT, // properties can be found in child nodes
@@ -51,6 +59,7 @@ typedef struct rz_json_t {
 			size_t count;
 			struct rz_json_t *first;
 			struct rz_json_t *last;
+			HtPP *keys; // first child by key, for objects with more than RZ_JSON_HASH_MIN children
 		} children;
 	};
 	struct rz_json_t *next; // points to next child
@@ -65,6 +74,45 @@ RZ_API const RzJson *rz_json_item(const RzJson *json, size_t idx); // get array
 RZ_API const RzJson *rz_json_get_path(const RzJson *json, const char *path); // reach into an object by (simple) JSON path like [0].methods[1].flags[0]
 RZ_API RZ_OWN char *rz_json_as_string(const RzJson *json); // shows the string representation of RzJson
 
+typedef enum rz_json_event_t {
+	RZ_JSON_EVENT_ERROR, // the text is not valid json, the reader stays there
+	RZ_JSON_EVENT_END, // the root value has been read
+	RZ_JSON_EVENT_OBJECT, // an object begins
+	RZ_JSON_EVENT_ARRAY, // an array begins
+	RZ_JSON_EVENT_CLOSE, // the innermost object or array ends
+	RZ_JSON_EVENT_VALUE // a string, number, boolean or null
+} RzJsonEvent;
+
+typedef struct rz_json_reader_t {
+	const char *p; // where reading continues
+	RzJsonEvent event; // what has just been read
+	RzJsonType type; // type of the value, or of the object or array that begins or ends
+	const char *key; // key of the value in its object, still escaped and not zero-terminated; NULL in arrays
+	size_t key_len;
+	ut64 index; // position of the value in its object or array
+	const char *value; // text of the value; strings are still escaped and without quotes
+	size_t value_len; // on CLOSE, value and value_len span the whole object or array
+	size_t depth; // number of objects and arrays the value is in
+	RzVector levels; // the objects and arrays being read
+} RzJsonReader;
+
+RZ_API void rz_json_reader_init(RzJsonReader *r, const char *text);
+RZ_API void rz_json_reader_fini(RzJsonReader *r);
+RZ_API RzJsonEvent rz_json_reader_next(RzJsonReader *r);
+RZ_API bool rz_json_reader_skip(RzJsonReader *r); // skip the object or array that just began
+RZ_API bool rz_json_reader_key_eq(const RzJsonReader *r, const char *key);
+RZ_API ut64 rz_json_reader_num(const RzJsonReader *r); // value of an INTEGER or BOOLEAN
+
+typedef struct rz_json_path_t RzJsonPath;
+
+// called for each value matching one of the paths; return false to stop
+typedef bool (*RzJsonPathCb)(void *user, size_t path, const RzJsonReader *r);
+
+RZ_API RzJsonPath *rz_json_path_new(const char *path); // compile a path like [0].methods[*].name or bin.arch
+RZ_API void rz_json_path_free(RzJsonPath *path);
+RZ_API bool rz_json_path_scan(const char *text, RzJsonPath **paths, size_t count, RzJsonPathCb cb, void *user);
+RZ_API RZ_OWN char *rz_json_path_get(const char *text, const char *path);
+
 #ifdef __cplusplus
 }
 #endif
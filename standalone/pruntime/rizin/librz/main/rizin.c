@@ -1225,7 +1225,8 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 				}
 			}
 		}
-		if (o && o->info && compute_hashes) {
+		// with bin.lazy the hashes are computed by the first `it`
+		if (o && o->info && compute_hashes && !r->bin->lazy) {
 			// TODO: recall with limit=0 ?
 			ut64 limit = rz_config_get_i(r->config, "bin.hashlimit");
 			RzBinFile *bf = r->bin->cur;
@@ -129,10 +129,13 @@ RZ_API int rz_reg_get_name_idx(const char *type) {
 	return -1;
 }
 
+static void handles_alias_update(RzReg *reg, int role);
+
 RZ_API bool rz_reg_set_name(RzReg *reg, int role, const char *name) {
 	rz_return_val_if_fail(reg && name, false);
 	if (role >= 0 && role < RZ_REG_NAME_LAST) {
 		reg->name[role] = rz_str_dup(reg->name[role], name);
+		handles_alias_update(reg, role);
 		return true;
 	}
 	return false;
@@ -161,10 +164,18 @@ RZ_API const char *rz_reg_get_role(int role) {
 	return NULL;
 }
 
+static void handles_free(RzReg *reg) {
+	ht_pp_free(reg->ht_handles);
+	reg->ht_handles = NULL;
+	RZ_FREE(reg->access);
+	reg->access_count = 0;
+}
+
 RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	rz_return_if_fail(reg);
 	ut32 i;
 
+	handles_free(reg);
 	rz_list_free(reg->roregs);
 	reg->roregs = NULL;
 	RZ_FREE(reg->reg_profile_str);
@@ -203,6 +214,86 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	reg->size = 0;
 }
 
+static bool is_in_roregs(RzReg *reg, RzRegItem *item) {
+	const char *name;
+	RzListIter *iter;
+	rz_list_foreach (reg->roregs, iter, name) {
+		if (!strcmp(item->name, name)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Set the role alias (e.g. "PC") in the handles table, mirroring what
+ * rz_reg_get() does when looking up an alias by name.
+ */
+static void handles_alias_update(RzReg *reg, int role) {
+	if (!reg->ht_handles) {
+		return;
+	}
+	const char *role_name = rz_reg_get_role(role);
+	const char *name = reg->name[role];
+	if (!role_name || !name) {
+		return;
+	}
+	RzRegItem *item = NULL;
+	int i;
+	for (i = 0; i < RZ_REG_TYPE_LAST && !item; i++) {
+		if (reg->regset[i].ht_regs) {
+			item = ht_pp_find(reg->regset[i].ht_regs, name, NULL);
+		}
+	}
+	// an alias to a missing register hides any register with the alias' name
+	ht_pp_update(reg->ht_handles, role_name, item);
+}
+
+/*
+ * Build a single table mapping every register name and alias to its item,
+ * and the direct access information of every handle.
+ */
+static void handles_build(RzReg *reg) {
+	RzListIter *iter;
+	RzRegItem *item;
+	int i;
+	handles_free(reg);
+	int count = rz_list_length(reg->allregs);
+	reg->ht_handles = ht_pp_new0();
+	reg->access = RZ_NEWS0(RzRegAccess, RZ_MAX(count, 1));
+	if (!reg->ht_handles || !reg->access) {
+		handles_free(reg);
+		return;
+	}
+	reg->access_count = count;
+	rz_list_foreach (reg->allregs, iter, item) {
+		RzRegAccess *a = &reg->access[item->index];
+		a->item = item;
+		a->arena = item->arena;
+		if (item->offset >= 0 && !(item->offset % 8)) {
+			switch (item->size) {
+			case 8:
+			case 16:
+			case 32:
+			case 64:
+				a->off = item->offset / 8;
+				a->bytes = item->size / 8;
+				break;
+			}
+		}
+		a->ro = is_in_roregs(reg, item);
+	}
+	// first match wins, like the per-type lookup of rz_reg_get()
+	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		rz_list_foreach (reg->regset[i].regs, iter, item) {
+			ht_pp_insert(reg->ht_handles, item->name, item);
+		}
+	}
+	for (i = 0; i < RZ_REG_NAME_LAST; i++) {
+		handles_alias_update(reg, i);
+	}
+}
+
 static int regcmp(RzRegItem *a, RzRegItem *b) {
 	int offa = (a->offset * 16) + a->size;
 	int offb = (b->offset * 16) + b->size;
@@ -226,6 +317,7 @@ RZ_API void rz_reg_reindex(RzReg *reg) {
 	}
 	rz_list_free(reg->allregs);
 	reg->allregs = all;
+	handles_build(reg);
 }
 
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx) {
@@ -278,28 +370,46 @@ RZ_API RzReg *rz_reg_new(void) {
 }
 
 RZ_API bool rz_reg_is_readonly(RzReg *reg, RzRegItem *item) {
-	const char *name;
-	RzListIter *iter;
 	if (!reg->roregs) {
 		return false;
 	}
-	// XXX O(n)
-	rz_list_foreach (reg->roregs, iter, name) {
-		if (!strcmp(item->name, name)) {
-			return true;
-		}
+	if (item->index >= 0 && item->index < reg->access_count && reg->access[item->index].item == item) {
+		return reg->access[item->index].ro;
+	}
+	return is_in_roregs(reg, item);
+}
+
+/**
+ * \brief Set the list of names of the registers that can't be written
+ * \param roregs list of register names, owned by \p reg from now on
+ */
+RZ_API void rz_reg_set_roregs(RzReg *reg, RZ_OWN RzList *roregs) {
+	rz_return_if_fail(reg);
+	rz_list_free(reg->roregs);
+	reg->roregs = roregs;
+	int i;
+	for (i = 0; i < reg->access_count; i++) {
+		RzRegAccess *a = &reg->access[i];
+		a->ro = a->item && is_in_roregs(reg, a->item);
 	}
-	return false;
 }
 
 RZ_API ut64 rz_reg_setv(RzReg *reg, const char *name, ut64 val) {
 	rz_return_val_if_fail(reg && name, UT64_MAX);
+	RzRegHandle h = rz_reg_handle(reg, name);
+	if (h != RZ_REG_HANDLE_INVALID) {
+		return rz_reg_handle_set_value(reg, h, val);
+	}
 	RzRegItem *ri = rz_reg_get(reg, name, -1);
 	return ri ? rz_reg_set_value(reg, ri, val) : UT64_MAX;
 }
 
 RZ_API ut64 rz_reg_getv(RzReg *reg, const char *name) {
 	rz_return_val_if_fail(reg && name, UT64_MAX);
+	RzRegHandle h = rz_reg_handle(reg, name);
+	if (h != RZ_REG_HANDLE_INVALID) {
+		return rz_reg_handle_get_value(reg, h);
+	}
 	RzRegItem *ri = rz_reg_get(reg, name, -1);
 	return ri ? rz_reg_get_value(reg, ri) : UT64_MAX;
 }
@@ -311,6 +421,9 @@ RZ_API RzRegItem *rz_reg_get(RzReg *reg, const char *name, int type) {
 	if (type == RZ_REG_TYPE_FLG) {
 		type = RZ_REG_TYPE_GPR;
 	}
+	if (type == -1 && reg->ht_handles) {
+		return ht_pp_find(reg->ht_handles, name, NULL);
+	}
 	if (type == -1) {
 		i = 0;
 		e = RZ_REG_TYPE_LAST;
@@ -338,6 +451,32 @@ RZ_API RzRegItem *rz_reg_get(RzReg *reg, const char *name, int type) {
 	return NULL;
 }
 
+/**
+ * \brief Resolve a register name or role alias to a handle
+ *
+ * Resolve registers once and use rz_reg_handle_get_value() and
+ * rz_reg_handle_set_value() to access them without any name lookup.
+ * Handles stay valid until the register profile changes.
+ *
+ * \return the handle or RZ_REG_HANDLE_INVALID if there is no such register
+ */
+RZ_API RzRegHandle rz_reg_handle(RzReg *reg, const char *name) {
+	rz_return_val_if_fail(reg && name, RZ_REG_HANDLE_INVALID);
+	if (!reg->ht_handles) {
+		return RZ_REG_HANDLE_INVALID;
+	}
+	RzRegItem *item = ht_pp_find(reg->ht_handles, name, NULL);
+	return item ? item->index : RZ_REG_HANDLE_INVALID;
+}
+
+RZ_API RzRegItem *rz_reg_handle_item(RzReg *reg, RzRegHandle handle) {
+	rz_return_val_if_fail(reg, NULL);
+	if (handle < 0 || handle >= reg->access_count) {
+		return NULL;
+	}
+	return reg->access[handle].item;
+}
+
 RZ_API const RzList *rz_reg_get_list(RzReg *reg, int type) {
 	if (type == RZ_REG_TYPE_ALL) {
 		return reg->allregs;
@@ -228,6 +228,72 @@ RZ_API bool rz_reg_set_value_by_role(RzReg *reg, RzRegisterId role, ut64 val) {
 	return rz_reg_set_value(reg, r, val);
 }
 
+/**
+ * \brief Read the value of the register identified by \p handle
+ *
+ * Byte aligned registers of 8 to 64 bits are read straight from the arena,
+ * any other register goes through rz_reg_get_value().
+ */
+RZ_API ut64 rz_reg_handle_get_value(RzReg *reg, RzRegHandle handle) {
+	rz_return_val_if_fail(reg, 0);
+	if (handle < 0 || handle >= reg->access_count) {
+		return 0;
+	}
+	const RzRegAccess *a = &reg->access[handle];
+	RzRegArena *arena = reg->regset[a->arena].arena;
+	if (a->bytes && arena && arena->bytes && a->off + a->bytes <= arena->size) {
+		const ut8 *src = arena->bytes + a->off;
+		switch (a->bytes) {
+		case 1:
+			return *src;
+		case 2:
+			return rz_read_ble16(src, reg->big_endian);
+		case 4:
+			return rz_read_ble32(src, reg->big_endian);
+		case 8:
+			return rz_read_ble64(src, reg->big_endian);
+		}
+	}
+	return rz_reg_get_value(reg, a->item);
+}
+
+/**
+ * \brief Write the value of the register identified by \p handle
+ *
+ * Same semantics as rz_reg_set_value(), with a direct path for
+ * byte aligned registers of 8 to 64 bits.
+ */
+RZ_API bool rz_reg_handle_set_value(RzReg *reg, RzRegHandle handle, ut64 value) {
+	rz_return_val_if_fail(reg, false);
+	if (handle < 0 || handle >= reg->access_count) {
+		return false;
+	}
+	const RzRegAccess *a = &reg->access[handle];
+	if (a->ro) {
+		return true;
+	}
+	RzRegArena *arena = reg->regset[a->arena].arena;
+	if (a->bytes && arena && arena->bytes && a->off + a->bytes <= arena->size) {
+		ut8 *dst = arena->bytes + a->off;
+		switch (a->bytes) {
+		case 1:
+			*dst = (ut8)value;
+			break;
+		case 2:
+			rz_write_ble16(dst, (ut16)value, reg->big_endian);
+			break;
+		case 4:
+			rz_write_ble32(dst, (ut32)value, reg->big_endian);
+			break;
+		case 8:
+			rz_write_ble64(dst, value, reg->big_endian);
+			break;
+		}
+		return true;
+	}
+	return rz_reg_set_value(reg, a->item, value);
+}
+
 RZ_API ut64 rz_reg_set_bvalue(RzReg *reg, RzRegItem *item, const char *str) {
 	ut64 num = UT64_MAX;
 	if (item && item->flags && str) {
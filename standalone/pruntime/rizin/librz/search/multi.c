@@ -0,0 +1,412 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/*
+ * Multi-keyword search.
+ *
+ * Every keyword contributes its longest run of fully specified bytes (the
+ * "anchor") to an Aho-Corasick automaton, so a block is scanned once whatever
+ * the number of keywords. Each anchor hit is then verified against the whole
+ * keyword with the same matcher used by RZ_SEARCH_KEYWORD, which takes care of
+ * binmasks and icase. The automaton works on lowercased bytes, so icase
+ * keywords are found too and case sensitive ones are just verified once more.
+ *
+ * Only the root has a full table of 256 transitions. The other states keep
+ * their children in a list and follow the failure links when a byte is not
+ * among them, so the automaton stays small with thousands of keywords (e.g.
+ * zignatures) and the scan is still linear.
+ *
+ * A lone keyword skips the automaton and jumps between occurrences of its
+ * rarest byte with memchr(), which libc implements with vector instructions.
+ */
+
+#include <rz_search.h>
+#include <ctype.h>
+#include "search_private.h"
+
+#define MULTI_ANCHOR_MAX 16
+
+typedef struct {
+	RzSearchKeyword *kw;
+	ut32 off; ///< offset of the anchor inside the keyword
+	ut32 len; ///< length of the anchor
+	st32 next; ///< next output of the same state, -1 if none
+} MultiOutput;
+
+struct rz_search_multi_t {
+	ut32 root[256]; ///< transitions of the root state
+	ut32 *child; ///< first child of each state, 0 if none
+	ut32 *sibling; ///< next child of the same parent, 0 if none
+	ut8 *label; ///< byte leading to each state from its parent
+	ut32 *fail; ///< failure link of each state
+	st32 *out; ///< first output of each state, -1 if none
+	ut32 *dict; ///< nearest state with outputs on the failure chain, 0 if none
+	ut32 n_states;
+	MultiOutput *outputs;
+	RzList /*<RzSearchKeyword>*/ *unanchored; ///< keywords without any fully specified byte
+	RzSearchKeyword *single; ///< the only keyword, when the memchr() path can be used
+	ut32 single_off; ///< offset of the rare byte inside single
+	ut8 single_byte;
+	int longest;
+	ut8 fold[256];
+};
+
+static inline bool kw_exact_byte(RzSearchKeyword *kw, ut32 i) {
+	return !kw->binmask_length || kw->bin_binmask[i % kw->binmask_length] == 0xff;
+}
+
+/* Longest run of fully specified bytes, or false if there is none */
+static bool kw_anchor(RzSearchKeyword *kw, ut32 *off, ut32 *len) {
+	ut32 i, start = 0, best_off = 0, best_len = 0;
+	for (i = 0; i <= kw->keyword_length; i++) {
+		if (i < kw->keyword_length && kw_exact_byte(kw, i)) {
+			continue;
+		}
+		if (i - start > best_len) {
+			best_off = start;
+			best_len = i - start;
+		}
+		start = i + 1;
+	}
+	*off = best_off;
+	*len = RZ_MIN(best_len, MULTI_ANCHOR_MAX);
+	return best_len > 0;
+}
+
+/* Rough rank of how common a byte is in binaries, lower is rarer */
+static int byte_rank(ut8 b) {
+	if (!b) {
+		return 5;
+	}
+	if (b == 0xff) {
+		return 4;
+	}
+	if (isalpha(b) || b == ' ') {
+		return 3;
+	}
+	if (isdigit(b) || b < 0x10) {
+		return 2;
+	}
+	return 1;
+}
+
+static bool single_prepare(RzSearchMulti *m, RzSearchKeyword *kw, ut32 aoff, ut32 alen) {
+	ut32 i;
+	int best = INT_MAX;
+	for (i = aoff; i < aoff + alen; i++) {
+		ut8 b = kw->bin_keyword[i];
+		if (kw->icase && isalpha(b)) {
+			// memchr() cannot look for both cases at once
+			continue;
+		}
+		if (byte_rank(b) < best) {
+			best = byte_rank(b);
+			m->single_off = i;
+			m->single_byte = b;
+		}
+	}
+	if (best == INT_MAX) {
+		return false;
+	}
+	m->single = kw;
+	return true;
+}
+
+static inline ut32 multi_child(RzSearchMulti *m, ut32 st, ut8 b) {
+	ut32 c;
+	for (c = m->child[st]; c; c = m->sibling[c]) {
+		if (m->label[c] == b) {
+			return c;
+		}
+	}
+	return 0;
+}
+
+/* Transition of the automaton from st on b, following the failure links */
+static inline ut32 multi_next(RzSearchMulti *m, ut32 st, ut8 b) {
+	while (st) {
+		ut32 c = multi_child(m, st, b);
+		if (c) {
+			return c;
+		}
+		st = m->fail[st];
+	}
+	return m->root[b];
+}
+
+RZ_IPI void rz_search_multi_free(RzSearchMulti *m) {
+	if (!m) {
+		return;
+	}
+	free(m->child);
+	free(m->sibling);
+	free(m->label);
+	free(m->fail);
+	free(m->out);
+	free(m->dict);
+	free(m->outputs);
+	rz_list_free(m->unanchored);
+	free(m);
+}
+
+static RzSearchMulti *multi_build(RzSearch *s) {
+	RzSearchMulti *m = RZ_NEW0(RzSearchMulti);
+	if (!m) {
+		return NULL;
+	}
+	m->unanchored = rz_list_new();
+	int n_kws = rz_list_length(s->kws);
+	m->outputs = RZ_NEWS0(MultiOutput, n_kws + 1);
+	if (!m->unanchored || !m->outputs) {
+		goto err;
+	}
+	ut32 i, max_states = 1;
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, iter, kw) {
+		max_states += RZ_MIN(kw->keyword_length, MULTI_ANCHOR_MAX);
+		m->longest = RZ_MAX(m->longest, kw->keyword_length);
+	}
+	for (i = 0; i < 256; i++) {
+		m->fold[i] = tolower(i);
+	}
+	if (n_kws == 1) {
+		ut32 aoff, alen;
+		kw = rz_list_first(s->kws);
+		if (kw_anchor(kw, &aoff, &alen) && single_prepare(m, kw, aoff, alen)) {
+			return m;
+		}
+	}
+
+	m->child = calloc(max_states, sizeof(ut32));
+	m->sibling = calloc(max_states, sizeof(ut32));
+	m->label = calloc(max_states, sizeof(ut8));
+	m->fail = calloc(max_states, sizeof(ut32));
+	m->out = malloc(max_states * sizeof(st32));
+	m->dict = calloc(max_states, sizeof(ut32));
+	ut32 *queue = malloc(max_states * sizeof(ut32));
+	if (!m->child || !m->sibling || !m->label || !m->fail || !m->out || !m->dict || !queue) {
+		free(queue);
+		goto err;
+	}
+	memset(m->root, 0xff, sizeof(m->root));
+	memset(m->out, 0xff, max_states * sizeof(st32));
+	m->n_states = 1;
+
+	// trie of the anchors
+	int n_out = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		ut32 aoff, alen;
+		if (!kw_anchor(kw, &aoff, &alen)) {
+			rz_list_append(m->unanchored, kw);
+			continue;
+		}
+		ut32 st = 0;
+		for (i = aoff; i < aoff + alen; i++) {
+			ut8 b = m->fold[kw->bin_keyword[i]];
+			ut32 next = st ? multi_child(m, st, b) : m->root[b];
+			if (!next || next == UT32_MAX) {
+				next = m->n_states++;
+				m->label[next] = b;
+				if (st) {
+					m->sibling[next] = m->child[st];
+					m->child[st] = next;
+				} else {
+					m->root[b] = next;
+				}
+			}
+			st = next;
+		}
+		MultiOutput *o = &m->outputs[n_out];
+		o->kw = kw;
+		o->off = aoff;
+		o->len = alen;
+		o->next = m->out[st];
+		m->out[st] = n_out++;
+	}
+
+	// failure links, in breadth-first order so that the links of the
+	// shallower states are known when they are followed
+	ut32 head = 0, tail = 0;
+	for (i = 0; i < 256; i++) {
+		if (m->root[i] == UT32_MAX) {
+			m->root[i] = 0;
+		} else {
+			queue[tail++] = m->root[i];
+		}
+	}
+	while (head < tail) {
+		ut32 st = queue[head++];
+		ut32 f = m->fail[st];
+		m->dict[st] = m->out[f] >= 0 ? f : m->dict[f];
+		ut32 c;
+		for (c = m->child[st]; c; c = m->sibling[c]) {
+			m->fail[c] = multi_next(m, f, m->label[c]);
+			queue[tail++] = c;
+		}
+	}
+	free(queue);
+	return m;
+err:
+	rz_search_multi_free(m);
+	return NULL;
+}
+
+/*
+ * Report a match of kw starting at pos, relative to the start of the current
+ * block. Returns like rz_search_hit_new(), hits skipped because of
+ * search.overlap count as 1.
+ */
+static int multi_hit(RzSearch *s, RzSearchKeyword *kw, ut64 from, st64 pos) {
+	ut64 addr = s->bckwrds ? from - kw->keyword_length - pos : from + pos;
+	// kw->last is also moved by sequential hits, which are not counted
+	if (!s->overlap && (kw->count || kw->last)) {
+		if (s->bckwrds ? addr + kw->keyword_length > kw->last : addr < kw->last) {
+			return 1;
+		}
+	}
+	return rz_search_hit_new(s, kw, addr);
+}
+
+/*
+ * Verify and report kw at offset p of data. When data holds the tail of the
+ * previous block, shift is its length and only the matches that start there
+ * and end in the current block are considered.
+ */
+static int multi_candidate(RzSearch *s, RzSearchKeyword *kw, const ut8 *data, int n, st64 p, int shift, ut64 from) {
+	if (p < 0 || p + kw->keyword_length > n) {
+		return 1;
+	}
+	if (shift && (p >= shift || p + kw->keyword_length <= shift)) {
+		return 1;
+	}
+	if (!rz_search_brute_force_match(s, kw, data, p)) {
+		return 1;
+	}
+	return multi_hit(s, kw, from, p - shift);
+}
+
+/*
+ * Find the keywords in data, see multi_candidate() for shift.
+ * Returns 1 to go on, 2 when search.maxhits is reached and 0 on error.
+ */
+static int multi_scan(RzSearch *s, RzSearchMulti *m, const ut8 *data, int n, int shift, ut64 from) {
+	int t;
+	if (m->single) {
+		const ut8 *p = data, *end = data + n;
+		while (p < end && (p = memchr(p, m->single_byte, end - p))) {
+			t = multi_candidate(s, m->single, data, n, (p - data) - m->single_off, shift, from);
+			if (t != 1) {
+				return t;
+			}
+			p++;
+		}
+		return 1;
+	}
+	if (m->n_states > 1) {
+		ut32 st = 0;
+		int i;
+		for (i = 0; i < n; i++) {
+			st = multi_next(m, st, m->fold[data[i]]);
+			ut32 o_st;
+			for (o_st = m->out[st] >= 0 ? st : m->dict[st]; o_st; o_st = m->dict[o_st]) {
+				st32 o;
+				for (o = m->out[o_st]; o >= 0; o = m->outputs[o].next) {
+					MultiOutput *out = &m->outputs[o];
+					st64 p = (st64)i + 1 - out->len - out->off;
+					t = multi_candidate(s, out->kw, data, n, p, shift, from);
+					if (t != 1) {
+						return t;
+					}
+				}
+			}
+		}
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (m->unanchored, iter, kw) {
+		st64 p;
+		for (p = 0; p + kw->keyword_length <= n; p++) {
+			t = multi_candidate(s, kw, data, n, p, shift, from);
+			if (t != 1) {
+				return t;
+			}
+		}
+	}
+	return 1;
+}
+
+// Supported search variants: backward, binmask, icase, overlap
+// inverse and distance searches are delegated to rz_search_mybinparse_update()
+RZ_API int rz_search_multi_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+	if (s->inverse || s->distance) {
+		// every offset is a candidate there, the automaton cannot skip anything
+		return rz_search_mybinparse_update(s, from, buf, len);
+	}
+	RzSearchLeftover *left;
+	const int old_nhits = s->nhits;
+	if (!s->multi) {
+		s->multi = multi_build(s);
+		if (!s->multi) {
+			return -1;
+		}
+	}
+	RzSearchMulti *m = s->multi;
+	int longest = m->longest;
+	if (!longest) {
+		return 0;
+	}
+	if (s->data) {
+		left = s->data;
+		if (left->end != from) {
+			left->len = 0;
+		}
+	} else {
+		left = malloc(sizeof(RzSearchLeftover) + (size_t)2 * (longest - 1));
+		if (!left) {
+			return -1;
+		}
+		s->data = left;
+		left->len = 0;
+	}
+	if (s->bckwrds) {
+		// XXX Change function signature from const ut8 * to ut8 *
+		ut8 *i = (ut8 *)buf, *j = i + len;
+		while (i < j) {
+			ut8 t = *i;
+			*i++ = *--j;
+			*j = t;
+		}
+	}
+
+	ut64 len1 = left->len + RZ_MIN(longest - 1, len);
+	memcpy(left->data + left->len, buf, len1 - left->len);
+	// matches across the boundary with the previous block, then the block itself
+	int t = 1;
+	if (left->len) {
+		t = multi_scan(s, m, left->data, len1, left->len, from);
+	}
+	if (t == 1) {
+		t = multi_scan(s, m, buf, len, 0, from);
+	}
+	if (!t) {
+		return -1;
+	}
+	if (t > 1) {
+		return s->nhits - old_nhits;
+	}
+	if (len < longest - 1) {
+		if (len1 < longest) {
+			left->len = len1;
+		} else {
+			left->len = longest - 1;
+			memmove(left->data, left->data + len1 - longest + 1, longest - 1);
+		}
+	} else {
+		left->len = longest - 1;
+		memcpy(left->data, buf + len - longest + 1, longest - 1);
+	}
+	left->end = s->bckwrds ? from - len : from + len;
+
+	return s->nhits - old_nhits;
+}
@@ -5,48 +5,158 @@
 #include "rz_search.h"
 #include <rz_regex.h>
 
-RZ_API int rz_search_regexp_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
-	RzSearchKeyword *kw;
-	RzListIter *iter;
-	RzRegexMatch match;
-	RzRegex compiled = { 0 };
-	const int old_nhits = s->nhits;
-	int ret = 0;
+// longest match that can be found across two chunks
+#define REGEXP_CARRY_MAX 0x100
 
+typedef struct {
+	ut64 end; ///< address following the previous chunk
+	int len; ///< bytes of the previous chunk at the start of data
+	int n_kws;
+	char data[REGEXP_CARRY_MAX * 2]; ///< tail of the previous chunk followed by the head of the current one
+	ut64 tail_hit[]; ///< for every keyword, the hit that reached the end of the previous chunk
+} RegexpCarry;
+
+static RzPVector *regexp_compile(RzSearch *s) {
+	RzPVector *res = rz_pvector_new((RzPVectorFree)rz_regex_free);
+	if (!res) {
+		return NULL;
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
 	rz_list_foreach (s->kws, iter, kw) {
 		int reflags = RZ_REGEX_EXTENDED;
-
 		if (kw->icase) {
 			reflags |= RZ_REGEX_ICASE;
 		}
-
-		if (rz_regex_comp(&compiled, (char *)kw->bin_keyword, reflags)) {
+		RzRegex *re = RZ_NEW0(RzRegex);
+		if (!re || rz_regex_comp(re, (char *)kw->bin_keyword, reflags)) {
 			eprintf("Cannot compile '%s' regexp\n", kw->bin_keyword);
-			return -1;
+			free(re);
+			rz_pvector_free(res);
+			return NULL;
 		}
+		rz_pvector_push(res, re);
+	}
+	return res;
+}
 
-		match.rm_so = 0;
-		match.rm_eo = len;
+static RegexpCarry *regexp_carry(RzSearch *s, ut64 from) {
+	int n_kws = rz_pvector_len(s->regexes);
+	RegexpCarry *carry = s->data;
+	if (carry && carry->n_kws != n_kws) {
+		RZ_FREE(s->data);
+		carry = NULL;
+	}
+	if (!carry) {
+		carry = malloc(sizeof(RegexpCarry) + n_kws * sizeof(ut64));
+		if (!carry) {
+			return NULL;
+		}
+		carry->end = from;
+		carry->len = 0;
+		carry->n_kws = n_kws;
+		s->data = carry;
+	}
+	if (carry->end != from) {
+		carry->len = 0;
+	}
+	if (!carry->len) {
+		int i;
+		for (i = 0; i < n_kws; i++) {
+			carry->tail_hit[i] = UT64_MAX;
+		}
+	}
+	return carry;
+}
+
+static inline void regexp_next(RzRegexMatch *match, int len) {
+	// an empty match would be found again at the same place
+	match->rm_so = match->rm_eo > match->rm_so ? match->rm_eo : match->rm_eo + 1;
+	match->rm_eo = len;
+}
+
+// Keywords are compiled once per search and matches can span two chunks,
+// as long as they are no longer than REGEXP_CARRY_MAX. Empty matches are ignored.
+RZ_API int rz_search_regexp_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+	RzRegexMatch match;
+	const int old_nhits = s->nhits;
 
-		while (!rz_regex_exec(&compiled, (char *)buf, 1, &match, RZ_REGEX_STARTEND)) {
-			int t = rz_search_hit_new(s, kw, from + match.rm_so);
-			if (!t) {
-				ret = -1;
-				goto beach;
+	if (!s->regexes) {
+		s->regexes = regexp_compile(s);
+		if (!s->regexes) {
+			return -1;
+		}
+	}
+	RegexpCarry *carry = regexp_carry(s, from);
+	if (!carry) {
+		return -1;
+	}
+	int head = RZ_MIN(len, REGEXP_CARRY_MAX);
+	int joined = carry->len + head;
+	memcpy(carry->data + carry->len, buf, head);
+
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	int i = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		RzRegex *re = rz_pvector_at(s->regexes, i);
+		st64 start = 0;
+		int t;
+		if (carry->len) {
+			// only the matches that start in the previous chunk and end in this one
+			match.rm_so = 0;
+			match.rm_eo = joined;
+			while (match.rm_so < carry->len && !rz_regex_exec(re, carry->data, 1, &match, RZ_REGEX_STARTEND)) {
+				if (match.rm_so >= carry->len) {
+					break;
+				}
+				if (match.rm_eo > carry->len) {
+					ut64 addr = from - carry->len + match.rm_so;
+					// a match cut by the end of the previous chunk was already reported
+					if (addr != carry->tail_hit[i]) {
+						t = rz_search_hit_new(s, kw, addr);
+						if (!t) {
+							return -1;
+						}
+						if (t > 1) {
+							return s->nhits - old_nhits;
+						}
+					}
+					start = match.rm_eo - carry->len;
+					break;
+				}
+				regexp_next(&match, joined);
 			}
-			if (t > 1) {
-				goto beach;
+		}
+
+		carry->tail_hit[i] = UT64_MAX;
+		match.rm_so = start;
+		match.rm_eo = len;
+		while (match.rm_so <= len && !rz_regex_exec(re, (char *)buf, 1, &match, RZ_REGEX_STARTEND)) {
+			if (match.rm_eo > match.rm_so) {
+				t = rz_search_hit_new(s, kw, from + match.rm_so);
+				if (!t) {
+					return -1;
+				}
+				if (t > 1) {
+					return s->nhits - old_nhits;
+				}
+				if (match.rm_eo == len) {
+					carry->tail_hit[i] = from + match.rm_so;
+				}
 			}
-			/* Setup the boundaries for RZ_REGEX_STARTEND */
-			match.rm_so = match.rm_eo;
-			match.rm_eo = len;
+			regexp_next(&match, len);
 		}
+		i++;
 	}
 
-beach:
-	rz_regex_fini(&compiled);
-	if (!ret) {
-		ret = s->nhits - old_nhits;
+	if (len >= REGEXP_CARRY_MAX) {
+		carry->len = REGEXP_CARRY_MAX;
+		memcpy(carry->data, buf + len - REGEXP_CARRY_MAX, REGEXP_CARRY_MAX);
+	} else {
+		carry->len = RZ_MIN(joined, REGEXP_CARRY_MAX);
+		memmove(carry->data, carry->data + joined - carry->len, carry->len);
 	}
-	return ret;
+	carry->end = from + len;
+	return s->nhits - old_nhits;
 }
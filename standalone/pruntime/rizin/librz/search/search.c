@@ -4,18 +4,13 @@
 #include <rz_search.h>
 #include <rz_list.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
 
 RZ_LIB_VERSION(rz_search);
 
-typedef struct {
-	ut64 end;
-	int len;
-	ut8 data[];
-} RzSearchLeftover;
-
 RZ_API RzSearch *rz_search_new(int mode) {
 	RzSearch *s = RZ_NEW0(RzSearch);
 	if (!s) {
@@ -55,6 +50,8 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	}
 	rz_list_free(s->hits);
 	rz_list_free(s->kws);
+	rz_search_multi_free(s->multi);
+	rz_pvector_free(s->regexes);
 	//rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free(s->data);
 	free(s);
@@ -79,6 +76,7 @@ RZ_API int rz_search_set_mode(RzSearch *s, int mode) {
 	s->update = NULL;
 	switch (mode) {
 	case RZ_SEARCH_KEYWORD: s->update = rz_search_mybinparse_update; break;
+	case RZ_SEARCH_MULTI: s->update = rz_search_multi_update; break;
 	case RZ_SEARCH_REGEXP: s->update = rz_search_regexp_update; break;
 	case RZ_SEARCH_AES: s->update = rz_search_aes_update; break;
 	case RZ_SEARCH_PRIV_KEY: s->update = rz_search_privkey_update; break;
@@ -93,9 +91,18 @@ RZ_API int rz_search_set_mode(RzSearch *s, int mode) {
 	return false;
 }
 
+/* Drop whatever was compiled from the keywords, it is rebuilt on the next update */
+static void kws_invalidate(RzSearch *s) {
+	rz_search_multi_free(s->multi);
+	s->multi = NULL;
+	rz_pvector_free(s->regexes);
+	s->regexes = NULL;
+}
+
 RZ_API int rz_search_begin(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
+	kws_invalidate(s);
 	rz_list_foreach (s->kws, iter, kw) {
 		kw->count = 0;
 		kw->last = 0;
@@ -298,7 +305,7 @@ static int rz_search_horspool(RzSearch *s, RzSearchKeyword *kw, ut64 from, const
 }
 #endif
 
-static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf, int i) {
+RZ_IPI bool rz_search_brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf, int i) {
 	int j = 0;
 	if (s->distance) { // slow path, more work in the loop
 		int dist = 0;
@@ -399,7 +406,7 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 			: from - kw->last < left->len         ? kw->last + left->len - from
 							      : 0;
 		for (; i + kw->keyword_length <= len1 && i < left->len; i++) {
-			if (brute_force_match(s, kw, left->data, i) != s->inverse) {
+			if (rz_search_brute_force_match(s, kw, left->data, i) != s->inverse) {
 				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
 				if (!t) {
 					return -1;
@@ -416,7 +423,7 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 			: from < kw->last                     ? kw->last - from
 							      : 0;
 		for (; i + kw->keyword_length <= len; i++) {
-			if (brute_force_match(s, kw, buf, i) != s->inverse) {
+			if (rz_search_brute_force_match(s, kw, buf, i) != s->inverse) {
 				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
 				if (!t) {
 					return -1;
@@ -509,6 +516,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append(s->kws, kw);
+	kws_invalidate(s);
 	return true;
 }
 
@@ -517,6 +525,7 @@ RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
 	// Precondition: !kw->binmask_length || kw->keyword_length % kw->binmask_length == 0
+	kws_invalidate(s);
 	rz_list_foreach (s->kws, iter, kw) {
 		ut8 *i = kw->bin_keyword, *j = kw->bin_keyword + kw->keyword_length;
 		while (i < j) {
@@ -545,4 +554,5 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge(s->kws);
 	rz_list_purge(s->hits);
 	RZ_FREE(s->data);
+	kws_invalidate(s);
 }
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_SEARCH_PRIVATE_H
+#define RZ_SEARCH_PRIVATE_H
+
+#include <rz_search.h>
+
+/* Bytes of the previous block kept to find matches across block boundaries */
+typedef struct {
+	ut64 end;
+	int len;
+	ut8 data[];
+} RzSearchLeftover;
+
+RZ_IPI bool rz_search_brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf, int i);
+RZ_IPI void rz_search_multi_free(RzSearchMulti *m);
+
+#endif
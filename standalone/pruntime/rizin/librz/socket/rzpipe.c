@@ -313,8 +313,113 @@ RZ_API RzPipe *rzpipe_open(const char *cmd) {
 	return rzp;
 }
 
+/**
+ * \brief Switch the pipe to the framed protocol
+ *
+ * The other end must be a rizin prompt loop started with -0. Once framed,
+ * commands can be sent with rzpipe_send() and rzpipe_send_batch() without
+ * waiting for the previous results, which are read with rzpipe_recv().
+ */
+RZ_API bool rzpipe_framed(RzPipe *rzp) {
+	rz_return_val_if_fail(rzp, false);
+#if __WINDOWS__
+	return false;
+#else
+	if (rzp->framed) {
+		return true;
+	}
+	if (!rzpipe_write(rzp, "e cmd.framed=true")) {
+		return false;
+	}
+	free(rzpipe_read(rzp));
+	rzp->framed = true;
+	return true;
+#endif
+}
+
+/**
+ * \brief Send a command frame on a framed pipe
+ * \return the id of the request, or 0 on failure
+ */
+RZ_API ut32 rzpipe_send(RzPipe *rzp, const char *str) {
+	rz_return_val_if_fail(rzp && str, 0);
+#if __WINDOWS__
+	return 0;
+#else
+	if (!rzp->framed) {
+		return 0;
+	}
+	ut32 id = ++rzp->next_id ? rzp->next_id : ++rzp->next_id;
+	return rzpipe_frame_write(rzp->input[1], RZPIPE_FRAME_CMD, id, (const ut8 *)str, strlen(str)) ? id : 0;
+#endif
+}
+
+/**
+ * \brief Send several commands in a single frame on a framed pipe
+ *
+ * The answer is a single RZPIPE_FRAME_BATCH_RESULT frame holding the outputs,
+ * to be split with rzpipe_batch_unpack().
+ *
+ * \return the id of the request, or 0 on failure
+ */
+RZ_API ut32 rzpipe_send_batch(RzPipe *rzp, RzPVector *cmds) {
+	rz_return_val_if_fail(rzp && cmds, 0);
+#if __WINDOWS__
+	return 0;
+#else
+	if (!rzp->framed) {
+		return 0;
+	}
+	ut32 size = 0;
+	ut8 *payload = rzpipe_batch_pack(cmds, &size);
+	if (!payload) {
+		return 0;
+	}
+	ut32 id = ++rzp->next_id ? rzp->next_id : ++rzp->next_id;
+	bool ok = rzpipe_frame_write(rzp->input[1], RZPIPE_FRAME_BATCH, id, payload, size);
+	free(payload);
+	return ok ? id : 0;
+#endif
+}
+
+/**
+ * \brief Read the next answer on a framed pipe
+ *
+ * Answers come in the order the requests were sent.
+ */
+RZ_API RzPipeFrame *rzpipe_recv(RzPipe *rzp) {
+	rz_return_val_if_fail(rzp, NULL);
+#if __WINDOWS__
+	return NULL;
+#else
+	return rzp->framed ? rzpipe_frame_read(rzp->output[0]) : NULL;
+#endif
+}
+
+static char *rzpipe_cmd_framed(RzPipe *rzp, const char *str) {
+	ut32 id = rzpipe_send(rzp, str);
+	if (!id) {
+		return NULL;
+	}
+	// skip the answers to requests still in flight
+	RzPipeFrame *frame;
+	while ((frame = rzpipe_recv(rzp)) && frame->id != id) {
+		rzpipe_frame_free(frame);
+	}
+	if (!frame || frame->type != RZPIPE_FRAME_RESULT) {
+		rzpipe_frame_free(frame);
+		return NULL;
+	}
+	char *res = (char *)frame->data;
+	free(frame);
+	return res;
+}
+
 RZ_API char *rzpipe_cmd(RzPipe *rzp, const char *str) {
 	rz_return_val_if_fail(rzp && str, NULL);
+	if (rzp->framed) {
+		return *str ? rzpipe_cmd_framed(rzp, str) : NULL;
+	}
 	if (!*str || !rzpipe_write(rzp, str)) {
 		perror("rzpipe_write");
 		return NULL;
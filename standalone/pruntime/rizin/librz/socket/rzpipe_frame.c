@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_socket.h>
+
+static bool read_all(int fd, ut8 *buf, size_t len) {
+	while (len > 0) {
+		ssize_t r = read(fd, buf, len);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			return false;
+		}
+		buf += r;
+		len -= r;
+	}
+	return true;
+}
+
+static bool write_all(int fd, const ut8 *buf, size_t len) {
+	while (len > 0) {
+		ssize_t r = write(fd, buf, len);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			return false;
+		}
+		buf += r;
+		len -= r;
+	}
+	return true;
+}
+
+/**
+ * \brief Read the next frame from \p fd
+ * \return the frame, or NULL on end of stream or if the header is invalid
+ */
+RZ_API RzPipeFrame *rzpipe_frame_read(int fd) {
+	ut8 hdr[RZPIPE_FRAME_HEADER_SIZE];
+	if (!read_all(fd, hdr, sizeof(hdr)) || hdr[0] != RZPIPE_FRAME_MAGIC) {
+		return NULL;
+	}
+	ut32 size = rz_read_le32(hdr + 8);
+	if (size > RZPIPE_FRAME_MAX) {
+		return NULL;
+	}
+	RzPipeFrame *frame = RZ_NEW0(RzPipeFrame);
+	if (!frame) {
+		return NULL;
+	}
+	frame->type = hdr[1];
+	frame->id = rz_read_le32(hdr + 4);
+	frame->size = size;
+	frame->data = malloc(size + 1);
+	if (!frame->data || !read_all(fd, frame->data, size)) {
+		rzpipe_frame_free(frame);
+		return NULL;
+	}
+	frame->data[size] = 0;
+	return frame;
+}
+
+/**
+ * \brief Write a frame to \p fd with a single write, so that frames
+ * written by different processes on the same pipe are not mixed up.
+ * \return false on a write error or if \p size is over RZPIPE_FRAME_MAX,
+ * which the reader would reject
+ */
+RZ_API bool rzpipe_frame_write(int fd, RzPipeFrameType type, ut32 id, const ut8 *data, ut32 size) {
+	rz_return_val_if_fail(data || !size, false);
+	if (size > RZPIPE_FRAME_MAX) {
+		return false;
+	}
+	ut8 *buf = malloc(RZPIPE_FRAME_HEADER_SIZE + (size_t)size);
+	if (!buf) {
+		return false;
+	}
+	buf[0] = RZPIPE_FRAME_MAGIC;
+	buf[1] = type;
+	buf[2] = buf[3] = 0;
+	rz_write_le32(buf + 4, id);
+	rz_write_le32(buf + 8, size);
+	if (size) {
+		memcpy(buf + RZPIPE_FRAME_HEADER_SIZE, data, size);
+	}
+	bool ret = write_all(fd, buf, RZPIPE_FRAME_HEADER_SIZE + (size_t)size);
+	free(buf);
+	return ret;
+}
+
+RZ_API void rzpipe_frame_free(RzPipeFrame *frame) {
+	if (!frame) {
+		return;
+	}
+	free(frame->data);
+	free(frame);
+}
+
+/**
+ * \brief Serialize the strings in \p strs as the payload of a batch frame
+ * \param size set to the size of the returned buffer
+ */
+RZ_API ut8 *rzpipe_batch_pack(RzPVector *strs, ut32 *size) {
+	rz_return_val_if_fail(strs && size, NULL);
+	size_t total = 4;
+	void **it;
+	rz_pvector_foreach (strs, it) {
+		const char *s = *it;
+		total += 4 + (s ? strlen(s) : 0);
+	}
+	if (total > RZPIPE_FRAME_MAX) {
+		return NULL;
+	}
+	ut8 *buf = malloc(total);
+	if (!buf) {
+		return NULL;
+	}
+	rz_write_le32(buf, rz_pvector_len(strs));
+	ut8 *p = buf + 4;
+	rz_pvector_foreach (strs, it) {
+		const char *s = *it;
+		ut32 len = s ? strlen(s) : 0;
+		rz_write_le32(p, len);
+		if (len) {
+			memcpy(p + 4, s, len);
+		}
+		p += 4 + len;
+	}
+	*size = total;
+	return buf;
+}
+
+/**
+ * \brief Split the payload of a batch frame
+ * \return a vector of strings, or NULL if the payload is truncated
+ */
+RZ_API RzPVector *rzpipe_batch_unpack(const ut8 *data, ut32 size) {
+	rz_return_val_if_fail(data || !size, NULL);
+	if (size < 4) {
+		return NULL;
+	}
+	ut32 count = rz_read_le32(data);
+	if (count > (size - 4) / 4) {
+		return NULL;
+	}
+	RzPVector *res = rz_pvector_new(free);
+	if (!res || !rz_pvector_reserve(res, count)) {
+		rz_pvector_free(res);
+		return NULL;
+	}
+	ut32 off = 4, i;
+	for (i = 0; i < count; i++) {
+		if (size - off < 4) {
+			goto fail;
+		}
+		ut32 len = rz_read_le32(data + off);
+		off += 4;
+		if (len > size - off) {
+			goto fail;
+		}
+		char *s = rz_str_ndup((const char *)data + off, len);
+		if (!s) {
+			goto fail;
+		}
+		rz_pvector_push(res, s);
+		off += len;
+	}
+	return res;
+fail:
+	rz_pvector_free(res);
+	return NULL;
+}
+
+static bool serve_batch(int out, RzPipeFrame *frame, RzPipeFrameCmd cmd, void *user) {
+	RzPVector *cmds = rzpipe_batch_unpack(frame->data, frame->size);
+	if (!cmds) {
+		return rzpipe_frame_write(out, RZPIPE_FRAME_ERROR, frame->id, NULL, 0);
+	}
+	RzPVector *outs = rz_pvector_new(free);
+	if (!outs) {
+		rz_pvector_free(cmds);
+		return false;
+	}
+	void **it;
+	rz_pvector_foreach (cmds, it) {
+		rz_pvector_push(outs, cmd(user, *it));
+	}
+	ut32 size = 0;
+	ut8 *payload = rzpipe_batch_pack(outs, &size);
+	bool ret = payload
+		? rzpipe_frame_write(out, RZPIPE_FRAME_BATCH_RESULT, frame->id, payload, size)
+		: rzpipe_frame_write(out, RZPIPE_FRAME_ERROR, frame->id, NULL, 0);
+	free(payload);
+	rz_pvector_free(outs);
+	rz_pvector_free(cmds);
+	return ret;
+}
+
+/**
+ * \brief Answer the request frames read from \p in until the stream ends
+ *
+ * Requests are run in the order they arrive, so a client can send several
+ * of them before reading the results, which come back in the same order.
+ * A result larger than RZPIPE_FRAME_MAX is answered by an ERROR frame.
+ *
+ * \param cmd runs a command and returns its output
+ * \return true if the stream ended cleanly, false on a write error
+ */
+RZ_API bool rzpipe_frame_serve(int in, int out, RzPipeFrameCmd cmd, void *user) {
+	rz_return_val_if_fail(cmd, false);
+	RzPipeFrame *frame;
+	while ((frame = rzpipe_frame_read(in))) {
+		bool ok;
+		if (frame->type == RZPIPE_FRAME_CMD) {
+			char *res = cmd(user, (const char *)frame->data);
+			size_t len = res ? strlen(res) : 0;
+			ok = len <= RZPIPE_FRAME_MAX
+				? rzpipe_frame_write(out, RZPIPE_FRAME_RESULT, frame->id, (ut8 *)res, len)
+				: rzpipe_frame_write(out, RZPIPE_FRAME_ERROR, frame->id, NULL, 0);
+			free(res);
+		} else if (frame->type == RZPIPE_FRAME_BATCH) {
+			ok = serve_batch(out, frame, cmd, user);
+		} else {
+			ok = rzpipe_frame_write(out, RZPIPE_FRAME_ERROR, frame->id, NULL, 0);
+		}
+		rzpipe_frame_free(frame);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
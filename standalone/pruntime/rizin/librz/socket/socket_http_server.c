@@ -3,6 +3,9 @@
 
 #include <rz_socket.h>
 #include <rz_util.h>
+#if __UNIX__
+#include <netinet/tcp.h>
+#endif
 
 static bool *breaked = NULL;
 
@@ -10,26 +13,47 @@ RZ_API void rz_socket_http_server_set_breaked(bool *b) {
 	breaked = b;
 }
 
-RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptions *so) {
-	int content_length = 0, xx, yy;
-	int pxx = 1, first = 0;
+// keep-alive connections kept open at most, the oldest one is closed first
+#define HTTP_MAX_IDLE 64
+
+typedef struct {
+	RzSocket *s;
+	ut64 since; ///< rz_time_now_mono() when the last response was sent
+} RzSocketHTTPIdle;
+
+/* read a line ending with \n or \r\n, without the line terminator */
+static int http_gets(RzSocket *s, char *buf, int size) {
+	int i = 0;
+	while (i < size - 1) {
+		ut8 c;
+		if (rz_socket_read(s, &c, 1) != 1) {
+			if (!i) {
+				return -1;
+			}
+			break;
+		}
+		if (c == '\n') {
+			break;
+		}
+		buf[i++] = c;
+	}
+	if (i > 0 && buf[i - 1] == '\r') {
+		i--;
+	}
+	buf[i] = 0;
+	return i;
+}
+
+static RzSocketHTTPRequest *http_read_request(RzSocket *client, RzSocketHTTPOptions *so, bool keep_alive) {
+	int content_length = 0, xx;
+	bool first = true;
 	char buf[1500], *p, *q;
 	RzSocketHTTPRequest *hr = RZ_NEW0(RzSocketHTTPRequest);
 	if (!hr) {
+		rz_socket_free(client);
 		return NULL;
 	}
-	if (so->accept_timeout) {
-		hr->s = rz_socket_accept_timeout(s, 1);
-	} else {
-		hr->s = rz_socket_accept(s);
-	}
-	if (!hr->s) {
-		free(hr);
-		return NULL;
-	}
-	if (so->timeout > 0) {
-		rz_socket_block_time(hr->s, true, so->timeout, 0);
-	}
+	hr->s = client;
 	hr->auth = !so->httpauth;
 	for (;;) {
 #if __WINDOWS__
@@ -38,17 +62,20 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptio
 			return NULL;
 		}
 #endif
-		memset(buf, 0, sizeof(buf));
-		xx = rz_socket_gets(hr->s, buf, sizeof(buf));
-		yy = rz_socket_ready(hr->s, 0, 20 * 1000); //this function uses usecs as argument
-		//		eprintf ("READ %d (%s) READY %d\n", xx, buf, yy);
-		if (!yy || (!xx && !pxx)) {
+		xx = http_gets(hr->s, buf, sizeof(buf));
+		if (xx < 0) {
+			if (first) {
+				rz_socket_http_close(hr);
+				return NULL;
+			}
 			break;
 		}
-		pxx = xx;
-
-		if (first == 0) {
-			first = 1;
+		if (first) {
+			if (!xx) {
+				// tolerate empty lines before the request line
+				continue;
+			}
+			first = false;
 			if (strlen(buf) < 3) {
 				rz_socket_http_close(hr);
 				return NULL;
@@ -62,9 +89,15 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptio
 				q = strstr(p + 1, " HTTP"); //strchr (p+1, ' ');
 				if (q) {
 					*q = 0;
+					hr->minor_version = !strcmp(q + 1, "HTTP/1.1");
+					// HTTP/1.1 connections are persistent unless told otherwise
+					hr->keep_alive = keep_alive && hr->minor_version;
 				}
 				hr->path = strdup(p + 1);
 			}
+		} else if (!xx) {
+			// end of the headers
+			break;
 		} else {
 			if (!hr->referer && !strncmp(buf, "Referer: ", 9)) {
 				hr->referer = strdup(buf + 9);
@@ -74,6 +107,12 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptio
 				hr->host = strdup(buf + 6);
 			} else if (!strncmp(buf, "Content-Length: ", 16)) {
 				content_length = atoi(buf + 16);
+			} else if (!rz_str_ncasecmp(buf, "Connection: ", 12)) {
+				if (!rz_str_casecmp(buf + 12, "close")) {
+					hr->keep_alive = false;
+				} else if (!rz_str_casecmp(buf + 12, "keep-alive")) {
+					hr->keep_alive = keep_alive;
+				}
 			} else if (so->httpauth && !strncmp(buf, "Authorization: Basic ", 21)) {
 				char *authtoken = buf + 21;
 				size_t authlen = strlen(authtoken);
@@ -105,13 +144,16 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptio
 		}
 	}
 	if (content_length > 0) {
-		rz_socket_read_block(hr->s, (ut8 *)buf, 1); // one missing byte
 		if (ST32_ADD_OVFCHK(content_length, 1)) {
 			rz_socket_http_close(hr);
 			eprintf("Could not allocate hr data\n");
 			return NULL;
 		}
 		hr->data = malloc(content_length + 1);
+		if (!hr->data) {
+			rz_socket_http_close(hr);
+			return NULL;
+		}
 		hr->data_length = content_length;
 		rz_socket_read_block(hr->s, hr->data, hr->data_length);
 		hr->data[content_length] = 0;
@@ -119,6 +161,19 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptio
 	return hr;
 }
 
+RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptions *so) {
+	RzSocket *client = so->accept_timeout
+		? rz_socket_accept_timeout(s, 1)
+		: rz_socket_accept(s);
+	if (!client) {
+		return NULL;
+	}
+	if (so->timeout > 0) {
+		rz_socket_block_time(client, true, so->timeout, 0);
+	}
+	return http_read_request(client, so, false);
+}
+
 RZ_API void rz_socket_http_response(RzSocketHTTPRequest *rs, int code, const char *out, int len, const char *headers) {
 	const char *strcode =
 		code == 200 ? "ok" : code == 301 ? "Moved permanently"
@@ -133,12 +188,25 @@ RZ_API void rz_socket_http_response(RzSocketHTTPRequest *rs, int code, const cha
 	if (!headers) {
 		headers = code == 401 ? "WWW-Authenticate: Basic realm=\"R2 Web UI Access\"\n" : "";
 	}
-	rz_socket_printf(rs->s, "HTTP/1.0 %d %s\r\n%s"
-				"Connection: close\r\nContent-Length: %d\r\n\r\n",
-		code, strcode, headers, len);
+	char *hdr = rz_str_newf("HTTP/1.%d %d %s\r\n%s"
+				"Connection: %s\r\nContent-Length: %d\r\n\r\n",
+		rs->minor_version, code, strcode, headers, rs->keep_alive ? "keep-alive" : "close", len);
+	if (!hdr) {
+		return;
+	}
+	// a single write, a header sent apart from the body would wait for the delayed ack of the client
+	int hdrlen = strlen(hdr);
+	char *msg = (out && len > 0) ? realloc(hdr, hdrlen + len) : hdr;
+	if (!msg) {
+		free(hdr);
+		return;
+	}
 	if (out && len > 0) {
-		rz_socket_write(rs->s, (void *)out, len);
+		memcpy(msg + hdrlen, out, len);
+		hdrlen += len;
 	}
+	rz_socket_write(rs->s, msg, hdrlen);
+	free(msg);
 }
 
 RZ_API ut8 *rz_socket_http_handle_upload(const ut8 *str, int len, int *retlen) {
@@ -189,15 +257,239 @@ RZ_API ut8 *rz_socket_http_handle_upload(const ut8 *str, int len, int *retlen) {
 
 /* close client socket and free struct */
 RZ_API void rz_socket_http_close(RzSocketHTTPRequest *rs) {
+	if (!rs) {
+		return;
+	}
 	rz_socket_free(rs->s);
 	free(rs->path);
 	free(rs->host);
 	free(rs->agent);
 	free(rs->method);
+	free(rs->referer);
 	free(rs->data);
 	free(rs);
 }
 
+/**
+ * \brief Create a server answering the requests received on the listening socket \p s
+ *
+ * Connections stay open between requests when the client asks for it, and
+ * are closed after so->timeout seconds of inactivity.
+ */
+RZ_API RzSocketHTTPServer *rz_socket_http_server_new(RzSocket *s, RzSocketHTTPOptions *so) {
+	rz_return_val_if_fail(s && so, NULL);
+	RzSocketHTTPServer *hs = RZ_NEW0(RzSocketHTTPServer);
+	if (!hs) {
+		return NULL;
+	}
+	hs->s = s;
+	hs->so = so;
+	rz_vector_init(&hs->idle, sizeof(RzSocketHTTPIdle), NULL, NULL);
+	return hs;
+}
+
+RZ_API void rz_socket_http_server_free(RzSocketHTTPServer *hs) {
+	if (!hs) {
+		return;
+	}
+	RzSocketHTTPIdle *idle;
+	rz_vector_foreach(&hs->idle, idle) {
+		rz_socket_free(idle->s);
+	}
+	rz_vector_fini(&hs->idle);
+	free(hs);
+}
+
+// Close the idle connections kept for so->timeout seconds, return the milliseconds until the next one is due or -1
+static int http_server_expire(RzSocketHTTPServer *hs) {
+	if (hs->so->timeout <= 0) {
+		return -1;
+	}
+	ut64 now = rz_time_now_mono();
+	ut64 timeout = (ut64)hs->so->timeout * RZ_USEC_PER_SEC;
+	ut64 next = UT64_MAX;
+	size_t i = 0;
+	while (i < rz_vector_len(&hs->idle)) {
+		RzSocketHTTPIdle *idle = rz_vector_index_ptr(&hs->idle, i);
+		if (now - idle->since < timeout) {
+			next = RZ_MIN(next, timeout - (now - idle->since));
+			i++;
+			continue;
+		}
+		rz_socket_free(idle->s);
+		rz_vector_remove_at(&hs->idle, i, NULL);
+	}
+	return next == UT64_MAX ? -1 : (int)((next + 999) / 1000);
+}
+
+/**
+ * \brief Wait at most \p timeout milliseconds (-1 for ever) for the next request
+ *
+ * The wait ends earlier when an idle connection has to be closed, so that
+ * connections are not kept past so->timeout by a server with nothing to do.
+ *
+ * \return the request, or NULL if none arrived or a connection went away.
+ * Pass it to rz_socket_http_server_done() once answered.
+ */
+RZ_API RzSocketHTTPRequest *rz_socket_http_server_accept(RzSocketHTTPServer *hs, int timeout) {
+	rz_return_val_if_fail(hs, NULL);
+#if __UNIX__
+	int due = http_server_expire(hs);
+	if (due >= 0 && (timeout < 0 || due < timeout)) {
+		timeout = due;
+	}
+	size_t i, n = rz_vector_len(&hs->idle);
+	struct pollfd *fds = calloc(n + 1, sizeof(struct pollfd));
+	if (!fds) {
+		return NULL;
+	}
+	fds[0].fd = hs->s->fd;
+	fds[0].events = POLLIN;
+	for (i = 0; i < n; i++) {
+		RzSocketHTTPIdle *idle = rz_vector_index_ptr(&hs->idle, i);
+		fds[i + 1].fd = idle->s->fd;
+		fds[i + 1].events = POLLIN;
+	}
+	if (poll(fds, n + 1, timeout) <= 0) {
+		free(fds);
+		http_server_expire(hs);
+		return NULL;
+	}
+	RzSocket *client = NULL;
+	// clients already connected first, the one that waited the longest
+	for (i = 0; i < n; i++) {
+		if (fds[i + 1].revents) {
+			RzSocketHTTPIdle *idle = rz_vector_index_ptr(&hs->idle, i);
+			client = idle->s;
+			rz_vector_remove_at(&hs->idle, i, NULL);
+			break;
+		}
+	}
+	bool accept = !client && (fds[0].revents & POLLIN);
+	free(fds);
+	if (accept) {
+		client = rz_socket_accept(hs->s);
+		if (!client) {
+			return NULL;
+		}
+		int one = 1;
+		setsockopt(client->fd, IPPROTO_TCP, TCP_NODELAY, (void *)&one, sizeof(one));
+		if (hs->so->timeout > 0) {
+			rz_socket_block_time(client, true, hs->so->timeout, 0);
+		}
+	}
+	return client ? http_read_request(client, hs->so, true) : NULL;
+#else
+	return rz_socket_http_accept(hs->s, hs->so);
+#endif
+}
+
+/**
+ * \brief Release a request answered by the caller, keeping its connection
+ * open for the next request if the client asked for it.
+ */
+RZ_API void rz_socket_http_server_done(RzSocketHTTPServer *hs, RzSocketHTTPRequest *rs) {
+	rz_return_if_fail(hs && rs);
+	if (rs->keep_alive && rs->s && rs->s->fd != RZ_INVALID_SOCKET) {
+		if (rz_vector_len(&hs->idle) >= HTTP_MAX_IDLE) {
+			RzSocketHTTPIdle oldest;
+			rz_vector_remove_at(&hs->idle, 0, &oldest);
+			rz_socket_free(oldest.s);
+		}
+		RzSocketHTTPIdle idle = { .s = rs->s, .since = rz_time_now_mono() };
+		if (rz_vector_push(&hs->idle, &idle)) {
+			rs->s = NULL;
+		}
+	}
+	rz_socket_http_close(rs);
+}
+
+static int http_bench_response(RzSocket *s, bool *keep_alive) {
+	char line[1024];
+	int code = -1, len = 0;
+	if (http_gets(s, line, sizeof(line)) < 0 || strncmp(line, "HTTP/1.", 7)) {
+		return -1;
+	}
+	code = atoi(line + 9);
+	*keep_alive = line[7] == '1';
+	int r;
+	while ((r = http_gets(s, line, sizeof(line))) > 0) {
+		if (!rz_str_ncasecmp(line, "Content-Length: ", 16)) {
+			len = atoi(line + 16);
+		} else if (!rz_str_casecmp(line, "Connection: close")) {
+			*keep_alive = false;
+		}
+	}
+	if (r < 0 || len < 0) {
+		return -1;
+	}
+	ut8 *body = malloc(len + 1);
+	if (!body) {
+		return -1;
+	}
+	r = len ? rz_socket_read_block(s, body, len) : 0;
+	free(body);
+	return r == len ? code : -1;
+}
+
+/**
+ * \brief Load test an http server
+ *
+ * Sends \p requests GET requests for \p path, spread over \p conns keep-alive
+ * connections that all have a request in flight at the same time.
+ */
+RZ_API bool rz_socket_http_bench(const char *host, const char *port, const char *path, int requests, int conns, RzSocketHTTPBench *res) {
+	rz_return_val_if_fail(host && port && path && res && conns > 0, false);
+	memset(res, 0, sizeof(*res));
+	RzSocket **socks = RZ_NEWS0(RzSocket *, conns);
+	if (!socks) {
+		return false;
+	}
+	char *req = rz_str_newf("GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n", path, host);
+	int reqlen = req ? strlen(req) : 0;
+	ut64 start = rz_time_now_mono();
+	int i, sent = 0;
+	while (req && sent < requests) {
+		int round = RZ_MIN(conns, requests - sent);
+		for (i = 0; i < round; i++) {
+			if (!socks[i]) {
+				socks[i] = rz_socket_new(false);
+				if (!socks[i] || !rz_socket_connect_tcp(socks[i], host, port, 0)) {
+					rz_socket_free(socks[i]);
+					socks[i] = NULL;
+					continue;
+				}
+			}
+			if (rz_socket_write(socks[i], req, reqlen) != reqlen) {
+				rz_socket_free(socks[i]);
+				socks[i] = NULL;
+			}
+		}
+		for (i = 0; i < round; i++) {
+			bool keep_alive = false;
+			int code = socks[i] ? http_bench_response(socks[i], &keep_alive) : -1;
+			if (code == 200) {
+				res->ok++;
+			} else {
+				res->failed++;
+			}
+			if (!keep_alive || code < 0) {
+				rz_socket_free(socks[i]);
+				socks[i] = NULL;
+			}
+		}
+		sent += round;
+	}
+	res->seconds = (double)(rz_time_now_mono() - start) / RZ_USEC_PER_SEC;
+	for (i = 0; i < conns; i++) {
+		rz_socket_free(socks[i]);
+	}
+	free(socks);
+	bool ret = req && res->ok > 0;
+	free(req);
+	return ret;
+}
+
 #if MAIN
 int main() {
 	RzSocket *s = rz_socket_new(false);
@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+#define ARENA_DEFAULT_CHUNK_SIZE 4096
+#define ARENA_ALIGN              (2 * sizeof(void *))
+
+struct rz_arena_chunk_t {
+	RzArenaChunk *next;
+	size_t size;
+	ut8 data[];
+};
+
+static inline size_t align_up(size_t n) {
+	return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+/*
+ * Get a chunk able to hold at least size bytes right after the current one.
+ * Chunks left over from previous releases are reused when they are big enough.
+ */
+static RzArenaChunk *next_chunk(RzArena *arena, size_t size) {
+	RzArenaChunk *next = arena->cur ? arena->cur->next : arena->head;
+	if (next && next->size >= size) {
+		return next;
+	}
+	size_t csize = RZ_MAX(arena->chunk_size, size);
+	RzArenaChunk *c = malloc(sizeof(RzArenaChunk) + csize);
+	if (!c) {
+		return NULL;
+	}
+	c->size = csize;
+	c->next = next;
+	if (arena->cur) {
+		arena->cur->next = c;
+	} else {
+		arena->head = c;
+	}
+	arena->stats.chunks++;
+	return c;
+}
+
+/**
+ * \brief Create a new arena
+ * \param chunk_size size of the chunks requested to the system allocator, 0 for the default
+ */
+RZ_API RzArena *rz_arena_new(size_t chunk_size) {
+	RzArena *arena = RZ_NEW0(RzArena);
+	if (!arena) {
+		return NULL;
+	}
+	arena->chunk_size = align_up(chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE);
+	return arena;
+}
+
+RZ_API void rz_arena_free(RzArena *arena) {
+	if (!arena) {
+		return;
+	}
+	RzArenaChunk *c = arena->head;
+	while (c) {
+		RzArenaChunk *next = c->next;
+		free(c);
+		c = next;
+	}
+	free(arena);
+}
+
+/**
+ * \brief Allocate \p size bytes from the arena
+ *
+ * The returned memory is suitably aligned for any basic type and
+ * must not be passed to free().
+ */
+RZ_API void *rz_arena_alloc(RzArena *arena, size_t size) {
+	rz_return_val_if_fail(arena, NULL);
+	if (size > SIZE_MAX - ARENA_ALIGN) {
+		return NULL;
+	}
+	size = align_up(size ? size : 1);
+	if (!arena->cur || arena->used + size > arena->cur->size) {
+		RzArenaChunk *c = next_chunk(arena, size);
+		if (!c) {
+			return NULL;
+		}
+		if (arena->cur) {
+			// the tail of the old chunk stays unused until the next release
+			arena->in_use += arena->cur->size - arena->used;
+		}
+		arena->cur = c;
+		arena->used = 0;
+	}
+	void *r = arena->cur->data + arena->used;
+	arena->used += size;
+	arena->in_use += size;
+	arena->stats.allocs++;
+	arena->stats.bytes += size;
+	if (arena->in_use > arena->stats.peak) {
+		arena->stats.peak = arena->in_use;
+	}
+	return r;
+}
+
+RZ_API void *rz_arena_calloc(RzArena *arena, size_t count, size_t size) {
+	rz_return_val_if_fail(arena, NULL);
+	if (size && count > SIZE_MAX / size) {
+		return NULL;
+	}
+	void *r = rz_arena_alloc(arena, count * size);
+	if (r) {
+		memset(r, 0, count * size);
+	}
+	return r;
+}
+
+RZ_API char *rz_arena_strndup(RzArena *arena, const char *s, size_t n) {
+	rz_return_val_if_fail(arena && s, NULL);
+	size_t len = rz_str_nlen(s, n);
+	char *r = rz_arena_alloc(arena, len + 1);
+	if (r) {
+		memcpy(r, s, len);
+		r[len] = 0;
+	}
+	return r;
+}
+
+RZ_API char *rz_arena_strdup(RzArena *arena, const char *s) {
+	rz_return_val_if_fail(arena && s, NULL);
+	return rz_arena_strndup(arena, s, strlen(s));
+}
+
+RZ_API char *rz_arena_vnewf(RzArena *arena, const char *fmt, va_list ap) {
+	rz_return_val_if_fail(arena && fmt, NULL);
+	va_list ap2;
+	va_copy(ap2, ap);
+	int len = vsnprintf(NULL, 0, fmt, ap);
+	char *r = NULL;
+	if (len >= 0) {
+		r = rz_arena_alloc(arena, len + 1);
+		if (r) {
+			vsnprintf(r, len + 1, fmt, ap2);
+		}
+	}
+	va_end(ap2);
+	return r;
+}
+
+RZ_API char *rz_arena_newf(RzArena *arena, const char *fmt, ...) {
+	rz_return_val_if_fail(arena && fmt, NULL);
+	va_list ap;
+	va_start(ap, fmt);
+	char *r = rz_arena_vnewf(arena, fmt, ap);
+	va_end(ap);
+	return r;
+}
+
+/**
+ * \brief Remember the current allocation state of the arena
+ *
+ * Pass the returned mark to rz_arena_release() to drop everything
+ * that has been allocated in the meantime.
+ */
+RZ_API RzArenaMark rz_arena_mark(RzArena *arena) {
+	RzArenaMark mark = { 0 };
+	rz_return_val_if_fail(arena, mark);
+	mark.chunk = arena->cur;
+	mark.used = arena->used;
+	mark.in_use = arena->in_use;
+	return mark;
+}
+
+/**
+ * \brief Drop every allocation done after \p mark was taken, in O(1)
+ *
+ * Chunks are kept for reuse, only rz_arena_free() gives them back to the system.
+ */
+RZ_API void rz_arena_release(RzArena *arena, RzArenaMark mark) {
+	rz_return_if_fail(arena);
+	arena->cur = mark.chunk;
+	arena->used = mark.used;
+	arena->in_use = mark.in_use;
+	arena->stats.releases++;
+}
+
+RZ_API void rz_arena_reset(RzArena *arena) {
+	RzArenaMark empty = { 0 };
+	rz_arena_release(arena, empty);
+}
+
+/**
+ * \brief Check whether \p ptr points into memory owned by the arena
+ */
+RZ_API bool rz_arena_contains(RzArena *arena, const void *ptr) {
+	rz_return_val_if_fail(arena, false);
+	RzArenaChunk *c;
+	for (c = arena->head; c; c = c->next) {
+		if ((const ut8 *)ptr >= c->data && (const ut8 *)ptr < c->data + c->size) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -1429,6 +1429,18 @@ RZ_API st64 rz_buf_read(RZ_NONNULL RzBuffer *b, RZ_NONNULL ut8 RZ_OUT *buf, ut64
 RZ_API st64 rz_buf_read_at(RZ_NONNULL RzBuffer *b, ut64 addr, RZ_NONNULL RZ_OUT ut8 *buf, ut64 len) {
 	rz_return_val_if_fail(b && buf, -1);
 
+	// contiguous buffers are copied from directly, without moving the cursor back and forth
+	ut64 size;
+	const ut8 *view = b->methods->get_view ? b->methods->get_view(b, &size) : NULL;
+	if (view && addr < size) {
+		ut64 real_len = RZ_MIN(size - addr, len);
+		memcpy(buf, view + addr, real_len);
+		if (len > real_len) {
+			memset(buf + real_len, b->Oxff_priv, len - real_len);
+		}
+		return real_len;
+	}
+
 	st64 tmp = rz_buf_tell(b);
 	if (tmp < 0) {
 		return -1;
@@ -1580,6 +1592,20 @@ RZ_DEPRECATE RZ_API RZ_BORROW const ut8 *rz_buf_data(RZ_NONNULL RzBuffer *b, ut6
 	return get_whole_buf(b, size);
 }
 
+/**
+ * \brief Return the bytes of the buffer if they are contiguous in memory, without copying them.
+ * \param b ...
+ * \param size Set to the number of bytes of the view
+ * \return The bytes or NULL if the buffer is not backed by memory (e.g. io or sparse buffers)
+ *
+ * The view is only valid until the buffer is written, resized or freed.
+ */
+RZ_API RZ_BORROW const ut8 *rz_buf_view(RZ_NONNULL RzBuffer *b, RZ_NONNULL RZ_OUT ut64 *size) {
+	rz_return_val_if_fail(b && b->methods && size, NULL);
+
+	return b->methods->get_view ? b->methods->get_view(b, size) : NULL;
+}
+
 /**
  * \brief ...
  * \param b ...
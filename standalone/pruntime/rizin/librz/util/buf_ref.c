@@ -93,6 +93,17 @@ static st64 buf_ref_seek(RzBuffer *b, st64 addr, int whence) {
 	return priv->cur;
 }
 
+static const ut8 *buf_ref_get_view(RzBuffer *b, ut64 *sz) {
+	struct buf_ref_priv *priv = get_priv_ref(b);
+	ut64 parent_sz;
+	const ut8 *view = rz_buf_view(priv->parent, &parent_sz);
+	if (!view || parent_sz < priv->base) {
+		return NULL;
+	}
+	*sz = RZ_MIN(priv->size, parent_sz - priv->base);
+	return view + priv->base;
+}
+
 static const RzBufferMethods buffer_ref_methods = {
 	.init = buf_ref_init,
 	.fini = buf_ref_fini,
@@ -100,4 +111,5 @@ static const RzBufferMethods buffer_ref_methods = {
 	.get_size = buf_ref_get_size,
 	.resize = buf_ref_resize,
 	.seek = buf_ref_seek,
+	.get_view = buf_ref_get_view,
 };
@@ -9,6 +9,7 @@
 #include <rz_util/rz_json.h>
 #include <rz_util/rz_assert.h>
 #include <rz_util/pj.h>
+#include <sdb.h>
 
 #if 0
 // optional error printing
@@ -47,6 +48,7 @@ RZ_API void rz_json_free(RzJson *js) {
 		return;
 	}
 	if (js->type == RZ_JSON_OBJECT || js->type == RZ_JSON_ARRAY) {
+		ht_pp_free(js->children.keys);
 		RzJson *p = js->children.first;
 		RzJson *p1;
 		while (p) {
@@ -58,6 +60,21 @@ RZ_API void rz_json_free(RzJson *js) {
 	free(js);
 }
 
+static void hash_keys(RzJson *js) {
+	HtPPOptions opt = { 0 };
+	opt.cmp = (HtPPListComparator)strcmp;
+	opt.hashfn = (HtPPHashFunction)sdb_hash;
+	js->children.keys = ht_pp_new_opt(&opt);
+	if (!js->children.keys) {
+		return;
+	}
+	RzJson *child;
+	for (child = js->children.first; child; child = child->next) {
+		// the first child wins, as when looking them up one by one
+		ht_pp_insert(js->children.keys, child->key, child);
+	}
+}
+
 static char *unescape_string(char *s, char **end) {
 	char *p = s;
 	char *d = s;
@@ -263,6 +280,9 @@ static char *parse_value(RzJson *parent, const char *key, char *p) {
 					return NULL;
 				}
 			} else if (*p == '}') {
+				if (js->children.count > RZ_JSON_HASH_MIN) {
+					hash_keys(js);
+				}
 				return p + 1; // end of object
 			} else {
 				RZ_JSON_REPORT_ERROR("unexpected chars", p);
@@ -393,9 +413,17 @@ RZ_API RzJson *rz_json_parse(char *text) {
 // getter with explicit size parameter, since in rz_json_get_path our key is
 // not zero-terminated.
 static const RzJson *rz_json_get_len(const RzJson *json, const char *key, size_t keysize) {
+	if (json->type == RZ_JSON_OBJECT && json->children.keys) {
+		char buf[128];
+		if (keysize < sizeof(buf)) {
+			memcpy(buf, key, keysize);
+			buf[keysize] = 0;
+			return ht_pp_find(json->children.keys, buf, NULL);
+		}
+	}
 	RzJson *js;
 	for (js = json->children.first; js; js = js->next) {
-		if (js->key && !strncmp(js->key, key, keysize)) {
+		if (js->key && !strncmp(js->key, key, keysize) && !js->key[keysize]) {
 			return js;
 		}
 	}
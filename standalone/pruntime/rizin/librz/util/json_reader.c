@@ -0,0 +1,519 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <errno.h>
+
+#include <rz_util/rz_json.h>
+#include <rz_util/rz_str.h>
+#include <rz_util/rz_assert.h>
+
+typedef struct {
+	bool array;
+	bool comma; ///< a value must follow
+	ut64 count; ///< values read so far
+	const char *start; ///< the opening bracket
+} ReaderLevel;
+
+static const char *skip_whitespace(const char *p) {
+	while (*p) {
+		if (*p == '/' && p[1] == '/') {
+			p = strchr(p + 2, '\n');
+			if (!p) {
+				return NULL;
+			}
+		} else if (*p == '/' && p[1] == '*') {
+			p = strstr(p + 2, "*/");
+			if (!p) {
+				return NULL;
+			}
+			p += 2;
+			continue;
+		} else if (!IS_WHITECHAR(*p)) {
+			break;
+		}
+		p++;
+	}
+	return p;
+}
+
+// returns the closing quote of the string starting after p
+static const char *skip_string(const char *p) {
+	for (;;) {
+		p += strcspn(p, "\"\\");
+		if (*p == '"') {
+			return p;
+		}
+		if (*p != '\\') {
+			return NULL;
+		}
+		p++;
+		if (*p == 'u') {
+			int i;
+			for (i = 1; i <= 4; i++) {
+				if (!IS_HEXCHAR(p[i])) {
+					return NULL;
+				}
+			}
+			p += 5;
+		} else if (*p && strchr("\\/\"bfnrt", *p)) {
+			p++;
+		} else if (*p) {
+			// left untouched by rz_json_parse() as well
+			p++;
+		} else {
+			return NULL;
+		}
+	}
+}
+
+static RzJsonEvent reader_error(RzJsonReader *r) {
+	r->event = RZ_JSON_EVENT_ERROR;
+	return r->event;
+}
+
+static RzJsonEvent read_value(RzJsonReader *r, const char *p) {
+	const char *e;
+	r->value = p;
+	switch (*p) {
+	case '{':
+	case '[': {
+		ReaderLevel *level = rz_vector_push(&r->levels, NULL);
+		if (!level) {
+			return reader_error(r);
+		}
+		level->array = *p == '[';
+		level->comma = false;
+		level->count = 0;
+		level->start = p;
+		r->p = p + 1;
+		r->value_len = 1;
+		r->type = level->array ? RZ_JSON_ARRAY : RZ_JSON_OBJECT;
+		r->event = level->array ? RZ_JSON_EVENT_ARRAY : RZ_JSON_EVENT_OBJECT;
+		return r->event;
+	}
+	case '"':
+		e = skip_string(p + 1);
+		if (!e) {
+			return reader_error(r);
+		}
+		r->type = RZ_JSON_STRING;
+		r->value = p + 1;
+		r->value_len = e - p - 1;
+		r->p = e + 1;
+		break;
+	case 't':
+	case 'f':
+	case 'n':
+		if (!strncmp(p, "true", 4) || !strncmp(p, "null", 4)) {
+			r->value_len = 4;
+		} else if (!strncmp(p, "false", 5)) {
+			r->value_len = 5;
+		} else {
+			return reader_error(r);
+		}
+		r->type = *p == 'n' ? RZ_JSON_NULL : RZ_JSON_BOOLEAN;
+		r->p = p + r->value_len;
+		break;
+	default:
+		e = p + (*p == '-');
+		if (!IS_DIGIT(*e)) {
+			return reader_error(r);
+		}
+		r->type = RZ_JSON_INTEGER;
+		while (IS_DIGIT(*e) || *e == '.' || *e == 'e' || *e == 'E' || ((*e == '-' || *e == '+') && (e[-1] == 'e' || e[-1] == 'E'))) {
+			if (!IS_DIGIT(*e)) {
+				r->type = RZ_JSON_DOUBLE;
+			}
+			e++;
+		}
+		r->value_len = e - p;
+		r->p = e;
+		if (r->type == RZ_JSON_INTEGER && r->value_len > 18) {
+			// rejected by rz_json_parse() as well
+			errno = 0;
+			if (*p == '-') {
+				strtoll(p, NULL, 10);
+			} else {
+				strtoull(p, NULL, 10);
+			}
+			if (errno == ERANGE) {
+				return reader_error(r);
+			}
+		}
+		break;
+	}
+	r->event = RZ_JSON_EVENT_VALUE;
+	return r->event;
+}
+
+// ends the innermost object or array, whose closing bracket is right before p
+static RzJsonEvent reader_close(RzJsonReader *r, const char *p) {
+	ReaderLevel *level = rz_vector_tail(&r->levels);
+	r->type = level->array ? RZ_JSON_ARRAY : RZ_JSON_OBJECT;
+	r->key = NULL;
+	r->key_len = 0;
+	r->value = level->start;
+	r->value_len = p - level->start;
+	r->p = p;
+	rz_vector_pop(&r->levels, NULL);
+	r->depth = rz_vector_len(&r->levels);
+	level = rz_vector_empty(&r->levels) ? NULL : rz_vector_tail(&r->levels);
+	r->index = level ? level->count - 1 : 0;
+	r->event = RZ_JSON_EVENT_CLOSE;
+	return r->event;
+}
+
+/**
+ * \brief Prepare \p r to read the json document \p text, which is not modified.
+ */
+RZ_API void rz_json_reader_init(RzJsonReader *r, const char *text) {
+	rz_return_if_fail(r && text);
+	memset(r, 0, sizeof(*r));
+	r->p = text;
+	r->event = RZ_JSON_EVENT_END;
+	r->type = RZ_JSON_NULL;
+	r->index = UT64_MAX; // nothing read yet
+	rz_vector_init(&r->levels, sizeof(ReaderLevel), NULL, NULL);
+}
+
+RZ_API void rz_json_reader_fini(RzJsonReader *r) {
+	rz_return_if_fail(r);
+	rz_vector_fini(&r->levels);
+}
+
+/**
+ * \brief Read the next event of the document
+ *
+ * After the root value has been read, RZ_JSON_EVENT_END is returned
+ * and whatever follows it is ignored.
+ */
+RZ_API RzJsonEvent rz_json_reader_next(RzJsonReader *r) {
+	rz_return_val_if_fail(r, RZ_JSON_EVENT_ERROR);
+	if (r->event == RZ_JSON_EVENT_ERROR) {
+		return r->event;
+	}
+	ReaderLevel *level = rz_vector_empty(&r->levels) ? NULL : rz_vector_tail(&r->levels);
+	if (!level && r->index != UT64_MAX) {
+		r->event = RZ_JSON_EVENT_END;
+		return r->event;
+	}
+	const char *p = skip_whitespace(r->p);
+	if (!p) {
+		return reader_error(r);
+	}
+	r->depth = rz_vector_len(&r->levels);
+	r->key = NULL;
+	r->key_len = 0;
+	if (!level) {
+		r->index = 0;
+		return read_value(r, p);
+	}
+	char close = level->array ? ']' : '}';
+	if (*p == close && !level->comma) {
+		return reader_close(r, p + 1);
+	}
+	if (level->count && !level->comma) {
+		if (*p != ',') {
+			return reader_error(r);
+		}
+		level->comma = true;
+		p = skip_whitespace(p + 1);
+		if (!p) {
+			return reader_error(r);
+		}
+	}
+	if (!level->array) {
+		if (*p != '"') {
+			return reader_error(r);
+		}
+		const char *e = skip_string(p + 1);
+		if (!e) {
+			return reader_error(r);
+		}
+		r->key = p + 1;
+		r->key_len = e - p - 1;
+		p = skip_whitespace(e + 1);
+		if (!p || *p != ':') {
+			return reader_error(r);
+		}
+		p = skip_whitespace(p + 1);
+		if (!p) {
+			return reader_error(r);
+		}
+	}
+	level->comma = false;
+	r->index = level->count++;
+	const char *key = r->key;
+	size_t key_len = r->key_len;
+	if (read_value(r, p) == RZ_JSON_EVENT_ERROR) {
+		return r->event;
+	}
+	r->key = key;
+	r->key_len = key_len;
+	return r->event;
+}
+
+/**
+ * \brief Skip the contents of the object or array that has just begun,
+ * as if its RZ_JSON_EVENT_CLOSE had been read.
+ */
+RZ_API bool rz_json_reader_skip(RzJsonReader *r) {
+	rz_return_val_if_fail(r, false);
+	if (r->event != RZ_JSON_EVENT_OBJECT && r->event != RZ_JSON_EVENT_ARRAY) {
+		return false;
+	}
+	// brackets only need to be counted, validating is left to the full reader
+	const char *p = r->p;
+	size_t nest = 1;
+	while (nest) {
+		p += strcspn(p, "\"{}[]/");
+		switch (*p) {
+		case '"':
+			p = skip_string(p + 1);
+			if (!p) {
+				return reader_error(r) != RZ_JSON_EVENT_ERROR;
+			}
+			p++;
+			break;
+		case '{':
+		case '[':
+			nest++;
+			p++;
+			break;
+		case '}':
+		case ']':
+			nest--;
+			p++;
+			break;
+		case '/':
+			p = skip_whitespace(p);
+			if (!p) {
+				return reader_error(r) != RZ_JSON_EVENT_ERROR;
+			}
+			if (*p == '/') {
+				return reader_error(r) != RZ_JSON_EVENT_ERROR;
+			}
+			break;
+		default:
+			return reader_error(r) != RZ_JSON_EVENT_ERROR;
+		}
+	}
+	ReaderLevel *level = rz_vector_tail(&r->levels);
+	char close = level->array ? ']' : '}';
+	if (p[-1] != close) {
+		return reader_error(r) != RZ_JSON_EVENT_ERROR;
+	}
+	reader_close(r, p);
+	return true;
+}
+
+/**
+ * \brief Check if the key of the value just read is \p key
+ */
+RZ_API bool rz_json_reader_key_eq(const RzJsonReader *r, const char *key) {
+	rz_return_val_if_fail(r && key, false);
+	return r->key && !strncmp(r->key, key, r->key_len) && !key[r->key_len];
+}
+
+RZ_API ut64 rz_json_reader_num(const RzJsonReader *r) {
+	rz_return_val_if_fail(r, 0);
+	if (r->type == RZ_JSON_BOOLEAN) {
+		return *r->value == 't';
+	}
+	if (r->type != RZ_JSON_INTEGER) {
+		return 0;
+	}
+	return *r->value == '-' ? (ut64)strtoll(r->value, NULL, 10) : strtoull(r->value, NULL, 10);
+}
+
+typedef struct {
+	const char *key; ///< NULL for an array index
+	size_t key_len;
+	ut64 index; ///< UT64_MAX matches any item
+} PathPart;
+
+struct rz_json_path_t {
+	size_t count;
+	PathPart parts[];
+};
+
+/**
+ * \brief Compile \p path, made of `.key` and `[index]` parts, for rz_json_path_scan()
+ *
+ * The leading dot may be omitted and `[*]` matches every item of an array.
+ */
+RZ_API RzJsonPath *rz_json_path_new(const char *path) {
+	rz_return_val_if_fail(path, NULL);
+	size_t n = 0;
+	const char *p;
+	for (p = path; *p; p++) {
+		n += *p == '.' || *p == '[';
+	}
+	RzJsonPath *res = malloc(sizeof(RzJsonPath) + (n + 1) * sizeof(PathPart));
+	if (!res) {
+		return NULL;
+	}
+	res->count = 0;
+	p = path;
+	while (*p) {
+		PathPart *part = &res->parts[res->count];
+		if (*p == '[') {
+			part->key = NULL;
+			part->key_len = 0;
+			if (p[1] == '*' && p[2] == ']') {
+				part->index = UT64_MAX;
+				p += 3;
+			} else {
+				char *end;
+				part->index = strtoull(p + 1, &end, 10);
+				if (end == p + 1 || *end != ']') {
+					goto fail;
+				}
+				p = end + 1;
+			}
+		} else {
+			if (*p == '.') {
+				p++;
+			} else if (p != path) {
+				goto fail;
+			}
+			part->key = p;
+			part->key_len = strcspn(p, ".[");
+			if (!part->key_len) {
+				goto fail;
+			}
+			p += part->key_len;
+		}
+		res->count++;
+	}
+	if (!res->count) {
+		goto fail;
+	}
+	return res;
+fail:
+	free(res);
+	return NULL;
+}
+
+RZ_API void rz_json_path_free(RzJsonPath *path) {
+	free(path);
+}
+
+static bool part_matches(const PathPart *part, const RzJsonReader *r) {
+	if (!part->key) {
+		return !r->key && (part->index == UT64_MAX || part->index == r->index);
+	}
+	return r->key && r->key_len == part->key_len && !memcmp(r->key, part->key, r->key_len);
+}
+
+/**
+ * \brief Find the values matching \p paths in \p text in a single pass
+ *
+ * \p cb is called with the reader on each match: on RZ_JSON_EVENT_VALUE for
+ * strings, numbers, booleans and null, on RZ_JSON_EVENT_CLOSE for objects
+ * and arrays, whose text is then spanned by value and value_len. Parts of
+ * the document no path can match are skipped without being parsed.
+ *
+ * \return false if the text is not valid json up to where the scan stopped
+ */
+RZ_API bool rz_json_path_scan(const char *text, RzJsonPath **paths, size_t count, RzJsonPathCb cb, void *user) {
+	rz_return_val_if_fail(text && paths && cb, false);
+	// for each path, how many of its parts the current value matches
+	size_t *matched = calloc(count + 1, sizeof(size_t));
+	RzVector pending; // for each open container, whether it was matched by a path and which one
+	if (!matched) {
+		return false;
+	}
+	rz_vector_init(&pending, sizeof(size_t), NULL, NULL);
+	RzJsonReader r;
+	rz_json_reader_init(&r, text);
+	bool ret = true;
+	size_t i;
+	while (ret) {
+		RzJsonEvent ev = rz_json_reader_next(&r);
+		if (ev == RZ_JSON_EVENT_END) {
+			break;
+		}
+		if (ev == RZ_JSON_EVENT_ERROR) {
+			ret = false;
+			break;
+		}
+		if (ev == RZ_JSON_EVENT_CLOSE) {
+			size_t hit;
+			rz_vector_pop(&pending, &hit);
+			if (hit < count && !cb(user, hit, &r)) {
+				break;
+			}
+			continue;
+		}
+		size_t depth = r.depth;
+		size_t hit = count;
+		bool deeper = false;
+		for (i = 0; i < count; i++) {
+			const RzJsonPath *path = paths[i];
+			if (!depth) {
+				matched[i] = 0;
+				continue;
+			}
+			if (matched[i] >= depth) {
+				// left over from the previous sibling
+				matched[i] = depth - 1;
+			}
+			if (matched[i] == depth - 1 && depth <= path->count && part_matches(&path->parts[depth - 1], &r)) {
+				matched[i] = depth;
+				if (depth == path->count) {
+					if (hit == count) {
+						hit = i;
+					}
+				} else {
+					deeper = true;
+				}
+			}
+		}
+		if (ev == RZ_JSON_EVENT_VALUE) {
+			if (hit < count && !cb(user, hit, &r)) {
+				break;
+			}
+			continue;
+		}
+		if (!depth) {
+			deeper = true;
+		}
+		if (!deeper) {
+			if (!rz_json_reader_skip(&r)) {
+				ret = false;
+				break;
+			}
+			if (hit < count && !cb(user, hit, &r)) {
+				break;
+			}
+			continue;
+		}
+		rz_vector_push(&pending, &hit);
+	}
+	rz_json_reader_fini(&r);
+	rz_vector_fini(&pending);
+	free(matched);
+	return ret;
+}
+
+static bool path_get_cb(void *user, size_t path, const RzJsonReader *r) {
+	*(char **)user = rz_str_ndup(r->value, r->value_len);
+	return false;
+}
+
+/**
+ * \brief Get the text of the first value matching \p path in \p text,
+ * strings are returned without quotes and still escaped.
+ */
+RZ_API RZ_OWN char *rz_json_path_get(const char *text, const char *path) {
+	rz_return_val_if_fail(text && path, NULL);
+	RzJsonPath *p = rz_json_path_new(path);
+	if (!p) {
+		return NULL;
+	}
+	char *res = NULL;
+	rz_json_path_scan(text, &p, 1, path_get_cb, &res);
+	rz_json_path_free(p);
+	return res;
+}
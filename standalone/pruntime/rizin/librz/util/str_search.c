@@ -233,7 +233,7 @@ static RzDetectedString *process_one_string(const ut8 *buf, const ut64 from, ut6
 	return NULL;
 }
 
-static inline bool can_be_utf16_le(ut8 *buf, ut64 size) {
+static inline bool can_be_utf16_le(const ut8 *buf, ut64 size) {
 	int rc = rz_utf8_decode(buf, size, NULL);
 	if (!rc) {
 		return false;
@@ -246,14 +246,14 @@ static inline bool can_be_utf16_le(ut8 *buf, ut64 size) {
 	return !w[0] && w[1] && !w[2] && w[3] && !w[4];
 }
 
-static inline bool can_be_utf16_be(ut8 *buf, ut64 size) {
+static inline bool can_be_utf16_be(const ut8 *buf, ut64 size) {
 	if (size < 7) {
 		return false;
 	}
 	return !buf[0] && buf[1] && !buf[2] && buf[3] && !buf[4] && buf[5] && !buf[6];
 }
 
-static inline bool can_be_utf32_le(ut8 *buf, ut64 size) {
+static inline bool can_be_utf32_le(const ut8 *buf, ut64 size) {
 	int rc = rz_utf8_decode(buf, size, NULL);
 	if (!rc) {
 		return false;
@@ -266,7 +266,7 @@ static inline bool can_be_utf32_le(ut8 *buf, ut64 size) {
 	return !w[0] && !w[1] && !w[2] && w[3] && !w[4];
 }
 
-static inline bool can_be_utf32_be(ut8 *buf, ut64 size) {
+static inline bool can_be_utf32_be(const ut8 *buf, ut64 size) {
 	if (size < 7) {
 		return false;
 	}
@@ -274,44 +274,26 @@ static inline bool can_be_utf32_be(ut8 *buf, ut64 size) {
 }
 
 /**
- * \brief Look for strings in an RzBuffer.
- * \param buf_to_scan Pointer to a RzBuffer to scan
+ * \brief Look for strings in the bytes at addresses \p from to \p to
+ * \param buf The to - from bytes to scan, the first one being at \p from
  * \param list Pointer to a list that will be populated with the found strings
  * \param opt Pointer to a RzUtilStrScanOptions that specifies search parameters
- * \param from Minimum address to scan
- * \param to Maximum address to scan
+ * \param from Address of the first byte of \p buf
+ * \param to Address following the last byte of \p buf
  * \param type Type of strings to search
  * \return Number of strings found
  *
- * Used to look for strings in a give RzBuffer. The function can also automatically detect string types.
+ * Same as rz_scan_strings() once the bytes have been read, so it can run on
+ * any thread.
  */
-RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrScanOptions *opt,
+RZ_API int rz_scan_strings_raw(RZ_NONNULL const ut8 *buf, RZ_NONNULL RzList *list, RZ_NONNULL const RzUtilStrScanOptions *opt,
 	const ut64 from, const ut64 to, RzStrEnc type) {
-
-	rz_return_val_if_fail(opt, -1);
-	rz_return_val_if_fail(list, -1);
-	rz_return_val_if_fail(buf_to_scan, -1);
-
-	if (from == to) {
-		return 0;
-	}
-	if (from > to) {
-		RZ_LOG_ERROR("Invalid range to find strings 0x%" PFMT64x " .. 0x%" PFMT64x "\n", from, to);
-		return -1;
-	}
+	rz_return_val_if_fail(buf && opt && list && from <= to, -1);
 
 	ut64 needle;
 	int count = 0;
 	RzStrEnc str_type = type;
 
-	int len = to - from;
-	ut8 *buf = calloc(len, 1);
-	if (!buf) {
-		return -1;
-	}
-
-	rz_buf_read_at(buf_to_scan, from, buf, len);
-
 	needle = from;
 	while (needle < to) {
 		if (type == RZ_STRING_ENC_GUESS) {
@@ -413,6 +395,43 @@ RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrS
 		rz_list_append(list, ds);
 		needle += ds->size;
 	}
+	return count;
+}
+
+/**
+ * \brief Look for strings in an RzBuffer.
+ * \param buf_to_scan Pointer to a RzBuffer to scan
+ * \param list Pointer to a list that will be populated with the found strings
+ * \param opt Pointer to a RzUtilStrScanOptions that specifies search parameters
+ * \param from Minimum address to scan
+ * \param to Maximum address to scan
+ * \param type Type of strings to search
+ * \return Number of strings found
+ *
+ * Used to look for strings in a give RzBuffer. The function can also automatically detect string types.
+ */
+RZ_API int rz_scan_strings(RzBuffer *buf_to_scan, RzList *list, const RzUtilStrScanOptions *opt,
+	const ut64 from, const ut64 to, RzStrEnc type) {
+
+	rz_return_val_if_fail(opt, -1);
+	rz_return_val_if_fail(list, -1);
+	rz_return_val_if_fail(buf_to_scan, -1);
+
+	if (from == to) {
+		return 0;
+	}
+	if (from > to) {
+		RZ_LOG_ERROR("Invalid range to find strings 0x%" PFMT64x " .. 0x%" PFMT64x "\n", from, to);
+		return -1;
+	}
+	int len = to - from;
+	ut8 *buf = calloc(len, 1);
+	if (!buf) {
+		return -1;
+	}
+
+	rz_buf_read_at(buf_to_scan, from, buf, len);
+	int count = rz_scan_strings_raw(buf, list, opt, from, to, type);
 	free(buf);
 	return count;
 }
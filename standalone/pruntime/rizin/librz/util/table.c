@@ -3,10 +3,7 @@
 
 #include <rz_util/rz_table.h>
 #include "rz_cons.h"
-
-// cant do that without globals because RzList doesnt have void *user :(
-static int Gnth = 0;
-static RzListComparator Gcmp = NULL;
+#include <ht_pp.h>
 
 static int sortString(const void *a, const void *b) {
 	return strcmp(a, b);
@@ -630,9 +627,10 @@ RZ_API void rz_table_filter(RzTable *t, int nth, int op, const char *un) {
 		uv = page_items * (page);
 	}
 	size_t nrow = 0;
+	bool numeric = op && strchr("+><)(=!", op);
 	rz_list_foreach_safe (t->rows, iter, iter2, row) {
 		const char *nn = rz_list_get_n(row->items, nth);
-		ut64 nv = rz_num_math(NULL, nn);
+		ut64 nv = numeric ? rz_num_math(NULL, nn) : 0;
 		bool match = true;
 		switch (op) {
 		case 'p':
@@ -713,52 +711,100 @@ RZ_API void rz_table_filter(RzTable *t, int nth, int op, const char *un) {
 	}
 }
 
-static int cmp(const void *_a, const void *_b) {
-	RzTableRow *a = (RzTableRow *)_a;
-	RzTableRow *b = (RzTableRow *)_b;
-	const char *wa = rz_list_get_n(a->items, Gnth);
-	const char *wb = rz_list_get_n(b->items, Gnth);
-	int res = Gcmp(wa, wb);
-	return res;
+/* A row and the value of the cell it is sorted by, parsed once per sort */
+typedef struct {
+	RzTableRow *row;
+	const char *str;
+	ut64 num; ///< value of str for numeric columns, its length for sortlen
+} TableSortKey;
+
+typedef int (*TableSortKeyCmp)(const TableSortKey *a, const TableSortKey *b, RzListComparator cmp);
+
+static int key_cmp_num(const TableSortKey *a, const TableSortKey *b, RzListComparator cmp) {
+	return a->num < b->num ? -1 : a->num > b->num;
 }
 
-RZ_API void rz_table_sort(RzTable *t, int nth, bool dec) {
-	RzTableColumn *col = rz_list_get_n(t->cols, nth);
-	if (col) {
-		Gnth = nth;
-		if (col->type && col->type->cmp) {
-			Gcmp = col->type->cmp;
-			t->rows->sorted = false; //force sorting
-			rz_list_sort(t->rows, cmp);
-			if (dec) {
-				rz_list_reverse(t->rows);
+static int key_cmp_str(const TableSortKey *a, const TableSortKey *b, RzListComparator cmp) {
+	return strcmp(a->str, b->str);
+}
+
+static int key_cmp_type(const TableSortKey *a, const TableSortKey *b, RzListComparator cmp) {
+	return cmp(a->str, b->str);
+}
+
+/* bottom-up merge sort, equal keys keep their order in both directions */
+static TableSortKey *keys_sort(TableSortKey *keys, TableSortKey *tmp, size_t n, TableSortKeyCmp kcmp, RzListComparator cmp, bool dec) {
+	size_t width, i;
+	for (width = 1; width < n; width *= 2) {
+		for (i = 0; i < n; i += 2 * width) {
+			size_t l = i, mid = RZ_MIN(i + width, n), r = mid, end = RZ_MIN(i + 2 * width, n), o = i;
+			while (l < mid && r < end) {
+				int c = kcmp(&keys[l], &keys[r], cmp);
+				tmp[o++] = (dec ? c >= 0 : c <= 0) ? keys[l++] : keys[r++];
+			}
+			while (l < mid) {
+				tmp[o++] = keys[l++];
+			}
+			while (r < end) {
+				tmp[o++] = keys[r++];
 			}
 		}
-		Gnth = 0;
-		Gcmp = NULL;
+		TableSortKey *swap = keys;
+		keys = tmp;
+		tmp = swap;
 	}
+	return keys;
 }
 
-static int cmplen(const void *_a, const void *_b) {
-	RzTableRow *a = (RzTableRow *)_a;
-	RzTableRow *b = (RzTableRow *)_b;
-	const char *wa = rz_list_get_n(a->items, Gnth);
-	const char *wb = rz_list_get_n(b->items, Gnth);
-	int res = strlen(wa) - strlen(wb);
-	return res;
+static void table_sort(RzTable *t, int nth, bool dec, bool bylen) {
+	RzTableColumn *col = rz_list_get_n(t->cols, nth);
+	if (!col || (!bylen && !(col->type && col->type->cmp))) {
+		return;
+	}
+	size_t n = rz_list_length(t->rows);
+	if (n < 2) {
+		return;
+	}
+	TableSortKey *keys = RZ_NEWS(TableSortKey, n * 2);
+	if (!keys) {
+		return;
+	}
+	RzListComparator cmp = bylen ? NULL : col->type->cmp;
+	TableSortKeyCmp kcmp = bylen || cmp == sortNumber ? key_cmp_num
+		: cmp == sortString                       ? key_cmp_str
+							  : key_cmp_type;
+	RzListIter *iter;
+	RzTableRow *row;
+	size_t i = 0;
+	rz_list_foreach (t->rows, iter, row) {
+		const char *str = rz_list_get_n(row->items, nth);
+		keys[i].row = row;
+		keys[i].str = str ? str : "";
+		keys[i].num = bylen ? strlen(keys[i].str) : kcmp == key_cmp_num ? rz_num_get(NULL, keys[i].str) : 0;
+		i++;
+	}
+	TableSortKey *sorted = keys_sort(keys, keys + n, n, kcmp, cmp, dec);
+	i = 0;
+	rz_list_foreach (t->rows, iter, row) {
+		iter->data = sorted[i++].row;
+	}
+	free(keys);
+}
+
+/**
+ * \brief Sort the rows by the values of the column \p nth
+ *
+ * The values are parsed once, the sort is stable so that sorting by several
+ * columns in turn orders the rows by the last one, then the previous ones.
+ */
+RZ_API void rz_table_sort(RzTable *t, int nth, bool dec) {
+	rz_return_if_fail(t);
+	table_sort(t, nth, dec, false);
 }
 
 RZ_API void rz_table_sortlen(RzTable *t, int nth, bool dec) {
-	RzTableColumn *col = rz_list_get_n(t->cols, nth);
-	if (col) {
-		Gnth = nth;
-		t->rows->sorted = false; //force sorting
-		rz_list_sort(t->rows, cmplen);
-		if (dec) {
-			rz_list_reverse(t->rows);
-		}
-		Gnth = 0;
-	}
+	rz_return_if_fail(t);
+	table_sort(t, nth, dec, true);
 }
 
 static int rz_rows_cmp(RzList *lhs, RzList *rhs, RzList *cols, int nth) {
@@ -806,6 +852,51 @@ RZ_API void rz_table_uniq(RzTable *t) {
 	rz_table_group(t, -1, NULL);
 }
 
+static bool table_group_hashable(RzTable *t, int nth) {
+	RzListIter *iter;
+	RzTableColumn *col;
+	int i = 0;
+	rz_list_foreach (t->cols, iter, col) {
+		if ((nth == -1 || i == nth) && (!col->type || (col->type->cmp != sortString && col->type->cmp != sortNumber))) {
+			return false;
+		}
+		i++;
+	}
+	return true;
+}
+
+/*
+ * Key of the cells compared by rz_rows_cmp(), equal for rows that compare equal,
+ * or NULL if the row cannot be equal to any other.
+ */
+static char *table_group_key(RzTable *t, RzTableRow *row, int nth, RzStrBuf *sb) {
+	int len = rz_list_length(row->items);
+	if (len > rz_list_length(t->cols)) {
+		return NULL;
+	}
+	rz_strbuf_setf(sb, "%d", len);
+	RzListIter *iter_item, *iter_col;
+	int i = 0;
+	for (iter_item = row->items->head, iter_col = t->cols->head; iter_item && iter_col;
+		iter_item = iter_item->n, iter_col = iter_col->n, i++) {
+		if (nth != -1 && i != nth) {
+			continue;
+		}
+		RzTableColumn *col = iter_col->data;
+		const char *item = iter_item->data;
+		if (col->type->cmp == sortNumber) {
+			rz_strbuf_appendf(sb, "|%" PFMT64x, rz_num_get(NULL, item));
+		} else {
+			rz_strbuf_appendf(sb, "|%" PFMTSZu ":%s", strlen(item), item);
+		}
+	}
+	return rz_strbuf_get(sb);
+}
+
+/**
+ * \brief Keep the first row of each group of rows with the same value in the
+ * column \p nth (or in all the columns with -1), merging the others in it with \p fcn
+ */
 RZ_API void rz_table_group(RzTable *t, int nth, RzTableSelector fcn) {
 	RzListIter *iter;
 	RzListIter *tmp;
@@ -816,6 +907,30 @@ RZ_API void rz_table_group(RzTable *t, int nth, RzTableSelector fcn) {
 
 	RzList *rows = t->rows;
 
+	HtPP *groups = table_group_hashable(t, nth) ? ht_pp_new0() : NULL;
+	if (groups) {
+		RzStrBuf sb;
+		rz_strbuf_init(&sb);
+		rz_list_foreach_safe (rows, iter, tmp, row) {
+			const char *key = table_group_key(t, row, nth, &sb);
+			if (!key) {
+				continue;
+			}
+			uniq_row = ht_pp_find(groups, key, NULL);
+			if (!uniq_row) {
+				ht_pp_insert(groups, key, row);
+				continue;
+			}
+			if (fcn) {
+				fcn(uniq_row, row, nth);
+			}
+			rz_list_delete(rows, iter);
+		}
+		rz_strbuf_fini(&sb);
+		ht_pp_free(groups);
+		return;
+	}
+
 	rz_list_foreach_safe (rows, iter, tmp, row) {
 		for (iter_inner = rows->head;
 			iter_inner && iter_inner != iter;
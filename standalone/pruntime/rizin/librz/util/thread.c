@@ -125,6 +125,89 @@ RZ_API bool rz_th_getname(RzThread *th, char *name, size_t len) {
 	return true;
 }
 
+/**
+ * \brief Returns the number of online logical processors, at least 1
+ *
+ * Every hardware thread counts, so with SMT this is a multiple of the number
+ * of physical cores. It is the number of threads that can run at once.
+ */
+RZ_API size_t rz_th_logical_core_number(void) {
+#if __WINDOWS__
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return RZ_MAX(info.dwNumberOfProcessors, 1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? n : 1;
+#else
+	return 1;
+#endif
+}
+
+typedef struct {
+	RzThreadIterCb fn;
+	void *user;
+	size_t n;
+	size_t next; ///< next index to hand out
+	RzThreadLock *lock; ///< protects next
+} ParallelFor;
+
+static void parallel_for_run(ParallelFor *pf) {
+	while (true) {
+		rz_th_lock_enter(pf->lock);
+		size_t i = pf->next++;
+		rz_th_lock_leave(pf->lock);
+		if (i >= pf->n) {
+			break;
+		}
+		pf->fn(pf->user, i);
+	}
+}
+
+static RzThreadFunctionRet parallel_for_th(RzThread *th) {
+	parallel_for_run(th->user);
+	return RZ_TH_STOP;
+}
+
+/**
+ * \brief Call \p fn for every index in [0, \p n) on up to rz_th_logical_core_number() threads
+ *
+ * The indexes are handed out one at a time to whichever thread is free, the
+ * calling thread included. Index 0 always runs on the calling thread, so it
+ * is the one that can poll for ^C. If no thread can be started, every index
+ * runs on the calling thread. Returns once all of them are done.
+ */
+RZ_API void rz_th_parallel_for(size_t n, RzThreadIterCb fn, void *user) {
+	rz_return_if_fail(fn);
+	if (!n) {
+		return;
+	}
+	ParallelFor pf = { fn, user, n, 1, NULL };
+	size_t i, n_th = RZ_MIN(rz_th_logical_core_number(), n);
+	RzThread **ths = n_th > 1 ? RZ_NEWS0(RzThread *, n_th) : NULL;
+	pf.lock = ths ? rz_th_lock_new(false) : NULL;
+	if (!pf.lock) {
+		for (i = 0; i < n; i++) {
+			fn(user, i);
+		}
+		free(ths);
+		return;
+	}
+	for (i = 1; i < n_th; i++) {
+		ths[i] = rz_th_new(parallel_for_th, &pf, 0);
+	}
+	fn(user, 0);
+	parallel_for_run(&pf);
+	for (i = 1; i < n_th; i++) {
+		if (ths[i]) {
+			rz_th_wait(ths[i]);
+			rz_th_free(ths[i]);
+		}
+	}
+	rz_th_lock_free(pf.lock);
+	free(ths);
+}
+
 RZ_API bool rz_th_setaffinity(RzThread *th, int cpuid) {
 #if __linux__
 #if defined(__GLIBC__) && defined(__GLIBC_MINOR__) && (__GLIBC__ <= 2) && (__GLIBC_MINOR__ <= 2)
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "minunit.h"
+
+#define N_FCNS 120
+
+static RzAnalysisFunction *fcn_new(RzAnalysis *analysis, ut64 addr, const char *name, const ut8 *fp, size_t size) {
+	RzAnalysisFunction *fcn = rz_analysis_function_new(analysis);
+	fcn->addr = addr;
+	fcn->name = name ? strdup(name) : NULL;
+	fcn->type = RZ_ANALYSIS_FCN_TYPE_FCN;
+	fcn->fingerprint = rz_mem_dup(fp, size);
+	fcn->fingerprint_size = size;
+	return fcn;
+}
+
+static ut32 rnd_next(ut32 *state) {
+	*state = *state * 1103515245 + 12345;
+	return *state >> 16;
+}
+
+bool test_analysis_diff_fcn(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzList *fcns1 = rz_list_newf(rz_analysis_function_free);
+	RzList *fcns2 = rz_list_newf(rz_analysis_function_free);
+	ut8 fp[0x200];
+	ut32 seed = 1;
+	int i, j;
+	for (i = 0; i < N_FCNS; i++) {
+		size_t size = 0x80 + rnd_next(&seed) % 0x100;
+		for (j = 0; j < size; j++) {
+			fp[j] = rnd_next(&seed);
+		}
+		char *name = rz_str_newf("fcn.%d", i);
+		rz_list_append(fcns1, fcn_new(analysis, 0x1000 + i * 0x1000, name, fp, size));
+		if (i >= N_FCNS / 3) {
+			// renamed, found by fingerprint
+			free(name);
+			name = rz_str_newf("renamed.%d", i);
+		}
+		if (i >= N_FCNS * 2 / 3) {
+			// and slightly changed, found by similarity
+			fp[size / 2] ^= 0xff;
+			fp[size / 3] ^= 0xff;
+		}
+		// reversed, so that matches are not in the same order
+		rz_list_prepend(fcns2, fcn_new(analysis, 0x80000 + i * 0x1000, name, fp, size));
+		free(name);
+	}
+	rz_list_append(fcns2, fcn_new(analysis, 0x800000, "unrelated", (const ut8 *)"\x01\x02\x03\x04\x05\x06", 6));
+
+	mu_assert_true(rz_analysis_diff_fcn(analysis, fcns1, fcns2), "diff");
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	i = 0;
+	rz_list_foreach (fcns1, it, fcn) {
+		mu_assert_eq(fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_MATCH, "matched");
+		mu_assert_eq(fcn->diff->addr, 0x80000 + i * 0x1000, "matched with the right function");
+		if (i < N_FCNS * 2 / 3) {
+			mu_assert_eq(fcn->diff->dist, 1.0, "identical");
+		} else {
+			mu_assert_true(fcn->diff->dist > 0.9 && fcn->diff->dist < 1.0, "similar");
+		}
+		i++;
+	}
+	fcn = rz_list_last(fcns2);
+	mu_assert_eq(fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "unrelated function is not matched");
+
+	rz_list_free(fcns1);
+	rz_list_free(fcns2);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_diff_fcn_names(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzList *fcns1 = rz_list_newf(rz_analysis_function_free);
+	RzList *fcns2 = rz_list_newf(rz_analysis_function_free);
+	const ut8 *fp = (const ut8 *)"\x55\x89\xe5\x83\xec\x10\xc9\xc3";
+	RzAnalysisFunction *dup1 = fcn_new(analysis, 0x1000, "dup", fp, 8);
+	RzAnalysisFunction *dup2 = fcn_new(analysis, 0x2000, "dup", fp, 8);
+	RzAnalysisFunction *noname = fcn_new(analysis, 0x3000, NULL, fp, 8);
+	RzAnalysisFunction *other = fcn_new(analysis, 0x4000, "other", fp, 8);
+	rz_list_append(fcns1, dup1);
+	rz_list_append(fcns1, dup2);
+	rz_list_append(fcns1, noname);
+	rz_list_append(fcns1, other);
+	RzAnalysisFunction *dup = fcn_new(analysis, 0x10000, "dup", fp, 8);
+	RzAnalysisFunction *unnamed = fcn_new(analysis, 0x20000, NULL, fp, 8);
+	RzAnalysisFunction *other2 = fcn_new(analysis, 0x30000, "other", fp, 8);
+	rz_list_append(fcns2, dup);
+	rz_list_append(fcns2, unnamed);
+	rz_list_append(fcns2, other2);
+
+	mu_assert_true(rz_analysis_diff_fcn(analysis, fcns1, fcns2), "diff");
+	mu_assert_eq(dup1->diff->addr, 0x10000, "same name");
+	mu_assert_eq(dup1->diff->dist, 1.0, "same name");
+	// the same function of fcns2 is paired again, without its fingerprint by then
+	mu_assert_eq(dup2->diff->addr, 0x10000, "same name, paired again");
+	mu_assert_eq(dup2->diff->dist, 0.0, "same name, paired again");
+	// no name, paired with the first function
+	mu_assert_eq(noname->diff->addr, 0x10000, "no name");
+	mu_assert_eq(noname->diff->dist, 0.0, "no name");
+	// the function without a name comes before the one with the same name
+	mu_assert_eq(other->diff->addr, 0x20000, "first of same name or no name");
+	mu_assert_eq(other->diff->dist, 1.0, "first of same name or no name");
+	mu_assert_eq(other2->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "not reached");
+
+	rz_list_free(fcns1);
+	rz_list_free(fcns2);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_analysis_diff_fcn_candidates(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzList *fcns1 = rz_list_newf(rz_analysis_function_free);
+	RzList *fcns2 = rz_list_newf(rz_analysis_function_free);
+	ut8 fp[0x100], changed[0x100];
+	ut32 seed = 7;
+	int i, j;
+	for (j = 0; j < sizeof(fp); j++) {
+		fp[j] = rnd_next(&seed);
+	}
+	RzAnalysisFunction *fcn = fcn_new(analysis, 0x1000, "fcn", fp, sizeof(fp));
+	rz_list_append(fcns1, fcn);
+	// more less similar functions than candidates are kept, found first in every band
+	for (i = 0; i < 200; i++) {
+		memcpy(changed, fp, sizeof(fp));
+		size_t at = rnd_next(&seed) % (sizeof(fp) - 12);
+		for (j = 0; j < 12; j++) {
+			changed[at + j] = rnd_next(&seed);
+		}
+		char *name = rz_str_newf("decoy.%d", i);
+		rz_list_append(fcns2, fcn_new(analysis, 0x80000 + i * 0x1000, name, changed, sizeof(changed)));
+		free(name);
+	}
+	memcpy(changed, fp, sizeof(fp));
+	changed[0x80] ^= 0xff;
+	rz_list_append(fcns2, fcn_new(analysis, 0x800000, "best", changed, sizeof(changed)));
+
+	mu_assert_true(rz_analysis_diff_fcn(analysis, fcns1, fcns2), "diff");
+	mu_assert_eq(fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_MATCH, "matched");
+	mu_assert_eq(fcn->diff->addr, 0x800000, "matched with the most similar function");
+
+	rz_list_free(fcns1);
+	rz_list_free(fcns2);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_diff_fcn);
+	mu_run_test(test_analysis_diff_fcn_names);
+	mu_run_test(test_analysis_diff_fcn_candidates);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
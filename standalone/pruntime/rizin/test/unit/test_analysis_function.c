@@ -168,6 +168,130 @@ bool test_rz_analysis_function_labels() {
 	mu_end;
 }
 
+static bool count_fcns_cb(RzAnalysisFunction *fcn, void *user) {
+	size_t *count = user;
+	(*count)++;
+	return true;
+}
+
+// checks the maximum end cached in each node of the block tree
+static bool block_tree_max_end_valid(RBNode *node, ut64 *max_end) {
+	*max_end = 0;
+	if (!node) {
+		return true;
+	}
+	RzAnalysisBlock *block = container_of(node, RzAnalysisBlock, _rb);
+	ut64 left, right;
+	if (!block_tree_max_end_valid(node->child[0], &left) || !block_tree_max_end_valid(node->child[1], &right)) {
+		return false;
+	}
+	*max_end = RZ_MAX(block->addr + block->size, RZ_MAX(left, right));
+	return block->_max_end == *max_end;
+}
+
+bool test_rz_analysis_functions_in() {
+	RzAnalysis *analysis = rz_analysis_new();
+
+	RzAnalysisFunction *fa = rz_analysis_create_function(analysis, "fa", 0x100, 0, NULL);
+	RzAnalysisFunction *fb = rz_analysis_create_function(analysis, "fb", 0x118, 0, NULL);
+	RzAnalysisBlock *b1 = rz_analysis_create_block(analysis, 0x100, 0x20);
+	RzAnalysisBlock *b2 = rz_analysis_create_block(analysis, 0x110, 0x20);
+	RzAnalysisBlock *b3 = rz_analysis_create_block(analysis, 0x118, 0x28);
+	rz_analysis_function_add_block(fa, b1);
+	rz_analysis_function_add_block(fa, b2);
+	rz_analysis_function_add_block(fb, b2);
+	rz_analysis_function_add_block(fb, b3);
+	assert_invariants(analysis);
+
+	// three blocks contain 0x118, each function is reported once
+	size_t count = 0;
+	rz_analysis_functions_foreach_in(analysis, 0x118, count_fcns_cb, &count);
+	mu_assert_eq(count, 2, "functions in");
+	RzList *fcns = rz_analysis_get_functions_in(analysis, 0x118);
+	mu_assert_eq(rz_list_length(fcns), 2, "functions in list");
+	mu_assert_ptreq(rz_analysis_first_function_in(analysis, 0x118), rz_list_first(fcns), "first function in");
+	rz_list_free(fcns);
+	mu_assert_null(rz_analysis_first_function_in(analysis, 0x140), "no function in");
+
+	mu_assert_ptreq(rz_analysis_get_fcn_in(analysis, 0x100, RZ_ANALYSIS_FCN_TYPE_ROOT), fa, "root");
+	mu_assert_ptreq(rz_analysis_get_fcn_in(analysis, 0x118, RZ_ANALYSIS_FCN_TYPE_ROOT), fb, "root");
+	mu_assert_null(rz_analysis_get_fcn_in(analysis, 0x110, RZ_ANALYSIS_FCN_TYPE_ROOT), "no root");
+	mu_assert_ptreq(rz_analysis_get_fcn_in(analysis, 0x105, 0), fa, "in");
+
+	// the cached range must follow resizes of any block
+	mu_assert_eq(rz_analysis_function_max_addr(fa), 0x130, "max");
+	rz_analysis_block_set_size(b2, 0x8);
+	mu_assert_eq(rz_analysis_function_max_addr(fa), 0x120, "max after shrinking");
+	mu_assert_true(rz_analysis_function_contains(fa, 0x11c), "contains");
+	rz_analysis_block_set_size(b1, 0x50);
+	mu_assert_eq(rz_analysis_function_max_addr(fa), 0x150, "max after growing");
+	mu_assert_true(rz_analysis_function_contains(fa, 0x148), "contains");
+	mu_assert_false(rz_analysis_function_contains(fb, 0x148), "not contains");
+	mu_assert_ptreq(rz_analysis_first_function_in(analysis, 0x148), fa, "first function in after growing");
+	assert_invariants(analysis);
+
+	// rz_analysis_function_contains() trusts the cached range, which must follow a block relocated below the minimum
+	RzAnalysisFunction *fr = rz_analysis_create_function(analysis, "fr", 0x300, 0, NULL);
+	RzAnalysisBlock *r1 = rz_analysis_create_block(analysis, 0x300, 0x10);
+	RzAnalysisBlock *r2 = rz_analysis_create_block(analysis, 0x320, 0x10);
+	RzAnalysisBlock *r3 = rz_analysis_create_block(analysis, 0x340, 0x10);
+	rz_analysis_function_add_block(fr, r1);
+	rz_analysis_function_add_block(fr, r2);
+	rz_analysis_function_add_block(fr, r3);
+	mu_assert_eq(rz_analysis_function_min_addr(fr), 0x300, "min");
+	mu_assert_true(rz_analysis_block_relocate(r2, 0x2f0, 0x10), "relocate");
+	mu_assert_eq(fr->meta._min, 0x2f0, "cached min after relocating below it");
+	mu_assert_true(rz_analysis_function_contains(fr, 0x2f4), "contains after relocating");
+	mu_assert_false(rz_analysis_function_contains(fr, 0x324), "not contains after relocating");
+	assert_invariants(analysis);
+
+	// merging grows a block, the maximum ends in the block tree must follow
+	RzAnalysisFunction *fm = rz_analysis_create_function(analysis, "fm", 0x400, 0, NULL);
+	RzAnalysisBlock *merged[16];
+	int i;
+	for (i = 0; i < 16; i++) {
+		merged[i] = rz_analysis_create_block(analysis, 0x400 + i * 0x10, 0x10);
+		rz_analysis_function_add_block(fm, merged[i]);
+	}
+	ut64 max_end;
+	for (i = 1; i < 16; i++) {
+		mu_assert_true(rz_analysis_block_merge(merged[0], merged[i]), "merge");
+		mu_assert_true(block_tree_max_end_valid(analysis->bb_tree, &max_end), "max ends after merging");
+		ut64 addr = 0x400 + i * 0x10 + 0xc;
+		mu_assert_ptreq(rz_analysis_first_function_in(analysis, addr), fm, "first function in merged block");
+		mu_assert_true(rz_analysis_function_contains(fm, addr), "contains merged block");
+	}
+	assert_invariants(analysis);
+
+	// more functions than can be remembered without allocating
+	RzAnalysisBlock *shared = rz_analysis_create_block(analysis, 0x200, 0x10);
+	RzAnalysisBlock *inner = rz_analysis_create_block(analysis, 0x204, 0x4);
+	for (i = 0; i < 12; i++) {
+		char name[32];
+		snprintf(name, sizeof(name), "shared%d", i);
+		RzAnalysisFunction *f = rz_analysis_create_function(analysis, name, 0x1000 + i, 0, NULL);
+		rz_analysis_function_add_block(f, shared);
+		rz_analysis_function_add_block(f, inner);
+	}
+	count = 0;
+	rz_analysis_functions_foreach_in(analysis, 0x206, count_fcns_cb, &count);
+	mu_assert_eq(count, 12, "many functions in");
+
+	rz_analysis_block_unref(b1);
+	rz_analysis_block_unref(b2);
+	rz_analysis_block_unref(b3);
+	rz_analysis_block_unref(shared);
+	rz_analysis_block_unref(inner);
+	rz_analysis_block_unref(r1);
+	rz_analysis_block_unref(r2);
+	rz_analysis_block_unref(r3);
+	rz_analysis_block_unref(merged[0]);
+	assert_invariants(analysis);
+	assert_leaks(analysis);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 bool test_dll_names(void) {
 	RzTypeDB *typedb = rz_type_db_new();
 	mu_assert_notnull(typedb, "Couldn't create new RzTypeDB");
@@ -325,6 +449,7 @@ bool test_initial_underscore(void) {
 int all_tests() {
 	mu_run_test(test_rz_analysis_function_relocate);
 	mu_run_test(test_rz_analysis_function_labels);
+	mu_run_test(test_rz_analysis_functions_in);
 	mu_run_test(test_ignore_prefixes);
 	mu_run_test(test_remove_rz_prefixes);
 	mu_run_test(test_dll_names);
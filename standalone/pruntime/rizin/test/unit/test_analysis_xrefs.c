@@ -21,8 +21,43 @@ bool test_rz_analysis_xrefs_count() {
 	mu_end;
 }
 
+bool test_rz_analysis_xrefs_del_from() {
+	RzAnalysis *analysis = rz_analysis_new();
+
+	rz_analysis_xrefs_set(analysis, 0x1337, 42, RZ_ANALYSIS_REF_TYPE_DATA);
+	rz_analysis_xrefs_set(analysis, 0x1337, 43, RZ_ANALYSIS_REF_TYPE_CALL);
+	rz_analysis_xrefs_set(analysis, 0x1337, 44, RZ_ANALYSIS_REF_TYPE_STRING);
+	rz_analysis_xrefs_set(analysis, 1234, 43, RZ_ANALYSIS_REF_TYPE_CALL);
+
+	rz_analysis_xrefs_del_from(analysis, 0x1337, RZ_ANALYSIS_REF_TYPE_CALL);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 3, "only the call is deleted");
+	RzList *xrefs = rz_analysis_xrefs_get_to(analysis, 44);
+	mu_assert_eq(rz_list_length(xrefs), 1, "string xref kept");
+	rz_list_free(xrefs);
+
+	rz_analysis_xrefs_del_from(analysis, 0x1337, RZ_ANALYSIS_REF_TYPE_NULL);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 1, "xrefs count");
+
+	xrefs = rz_analysis_xrefs_get_from(analysis, 0x1337);
+	mu_assert_eq(rz_list_length(xrefs), 0, "no xrefs from 0x1337");
+	rz_list_free(xrefs);
+
+	xrefs = rz_analysis_xrefs_get_to(analysis, 43);
+	mu_assert_eq(rz_list_length(xrefs), 1, "one xref to 43 left");
+	RzAnalysisXRef *xref = rz_list_first(xrefs);
+	mu_assert_eq(xref->from, 1234, "xref from 1234 untouched");
+	rz_list_free(xrefs);
+
+	rz_analysis_xrefs_del_from(analysis, 0x1337, RZ_ANALYSIS_REF_TYPE_NULL);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 1, "deleting again is a no-op");
+
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_xrefs_count);
+	mu_run_test(test_rz_analysis_xrefs_del_from);
 	return tests_passed != tests_run;
 }
 
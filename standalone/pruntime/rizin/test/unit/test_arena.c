@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+bool test_arena_alloc(void) {
+	RzArena *arena = rz_arena_new(64);
+	ut64 *a = RZ_ARENA_NEW(arena, ut64);
+	mu_assert_notnull(a, "alloc");
+	mu_assert_eq((size_t)a % sizeof(ut64), 0, "aligned");
+	*a = 0x1337;
+	int *b = RZ_ARENA_NEW0(arena, int);
+	mu_assert_notnull(b, "alloc0");
+	mu_assert_eq(*b, 0, "zeroed");
+	mu_assert_eq(*a, 0x1337, "first allocation untouched");
+	char *s = rz_arena_strdup(arena, "hello");
+	mu_assert_streq(s, "hello", "strdup");
+	s = rz_arena_strndup(arena, "hello world", 5);
+	mu_assert_streq(s, "hello", "strndup");
+	s = rz_arena_newf(arena, "%s %d", "answer", 42);
+	mu_assert_streq(s, "answer 42", "newf");
+	mu_assert_true(rz_arena_contains(arena, a), "contains a");
+	mu_assert_true(rz_arena_contains(arena, s), "contains s");
+	int on_stack;
+	mu_assert_false(rz_arena_contains(arena, &on_stack), "does not contain a stack var");
+	mu_assert_eq(arena->stats.allocs, 5, "allocs");
+	mu_assert_eq(arena->stats.chunks, 2, "chunks");
+	rz_arena_free(arena);
+	mu_end;
+}
+
+bool test_arena_big(void) {
+	RzArena *arena = rz_arena_new(32);
+	ut8 *big = rz_arena_alloc(arena, 1000);
+	mu_assert_notnull(big, "bigger than a chunk");
+	memset(big, 0xaa, 1000);
+	ut8 *small = rz_arena_alloc(arena, 8);
+	mu_assert_notnull(small, "small after big");
+	mu_assert_true(small < big || small >= big + 1000, "no overlap");
+	rz_arena_free(arena);
+	mu_end;
+}
+
+bool test_arena_release(void) {
+	RzArena *arena = rz_arena_new(128);
+	char *keep = rz_arena_strdup(arena, "keep me");
+	RzArenaMark mark = rz_arena_mark(arena);
+	size_t in_use = arena->in_use;
+	int i;
+	void *first = NULL;
+	for (i = 0; i < 100; i++) {
+		void *p = rz_arena_alloc(arena, 24);
+		if (!first) {
+			first = p;
+		}
+	}
+	ut64 chunks = arena->stats.chunks;
+	mu_assert_true(chunks > 1, "more chunks were needed");
+	rz_arena_release(arena, mark);
+	mu_assert_eq(arena->in_use, in_use, "in use restored");
+	mu_assert_streq(keep, "keep me", "allocation before the mark survives");
+	void *again = rz_arena_alloc(arena, 24);
+	mu_assert_ptreq(again, first, "memory after the mark is reused");
+	for (i = 0; i < 99; i++) {
+		rz_arena_alloc(arena, 24);
+	}
+	mu_assert_eq(arena->stats.chunks, chunks, "chunks are recycled");
+	mu_assert_eq(arena->stats.releases, 1, "releases");
+
+	rz_arena_reset(arena);
+	mu_assert_eq(arena->in_use, 0, "nothing in use after reset");
+	mu_assert_true(arena->stats.peak >= 100 * 24, "peak");
+	rz_arena_free(arena);
+	mu_end;
+}
+
+bool test_arena_nested(void) {
+	RzArena *arena = rz_arena_new(0);
+	RzArenaMark outer = rz_arena_mark(arena);
+	char *a = rz_arena_strdup(arena, "outer");
+	RzArenaMark inner = rz_arena_mark(arena);
+	char *b = rz_arena_strdup(arena, "inner");
+	mu_assert_streq(b, "inner", "inner alloc");
+	rz_arena_release(arena, inner);
+	mu_assert_streq(a, "outer", "outer alloc survives inner release");
+	char *c = rz_arena_strdup(arena, "again");
+	mu_assert_ptreq(c, b, "inner memory reused");
+	rz_arena_release(arena, outer);
+	char *d = rz_arena_strdup(arena, "x");
+	mu_assert_ptreq(d, a, "outer memory reused");
+	rz_arena_free(arena);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_arena_alloc);
+	mu_run_test(test_arena_big);
+	mu_run_test(test_arena_release);
+	mu_run_test(test_arena_nested);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
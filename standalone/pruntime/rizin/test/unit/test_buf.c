@@ -1216,6 +1216,46 @@ bool test_rz_buf_whole_buf_alloc(void) {
 	mu_end;
 }
 
+bool test_rz_buf_view(void) {
+	const char *content = "AAAAAAAAAASomething To\nSay Here..BBBBBBBBBB";
+	const int length = strlen(content);
+	RzBuffer *buf = rz_buf_new_with_bytes((ut8 *)content, length);
+	RzBuffer *slice = rz_buf_new_slice(buf, 10, 23);
+	RzBuffer *sparse = rz_buf_new_sparse(0xff);
+	ut8 buffer[32];
+	ut64 size;
+
+	const ut8 *view = rz_buf_view(buf, &size);
+	mu_assert_notnull(view, "bytes are contiguous");
+	mu_assert_eq(size, length, "view size");
+	mu_assert_memeq(view, (ut8 *)content, length, "view content");
+
+	view = rz_buf_view(slice, &size);
+	mu_assert_notnull(view, "slice of bytes is contiguous");
+	mu_assert_eq(size, 23, "slice view size");
+	mu_assert_memeq(view, (ut8 *)"Something To\nSay Here..", 23, "slice view content");
+
+	mu_assert_null(rz_buf_view(sparse, &size), "sparse has no view");
+
+	rz_buf_seek(slice, 3, RZ_BUF_SET);
+	rz_buf_set_overflow_byte(slice, 0x42);
+	st64 r = rz_buf_read_at(slice, 20, buffer, 5);
+	mu_assert_eq(r, 3, "read up to the end");
+	mu_assert_memeq(buffer, (ut8 *)"e..\x42\x42", 5, "padded with the overflow byte");
+	mu_assert_eq(rz_buf_tell(slice), 3, "cursor is kept");
+	mu_assert_eq(rz_buf_read_at(slice, 30, buffer, 5), -1, "read past the end of a slice");
+
+	ut32 v;
+	mu_assert_true(rz_buf_read_be32_at(buf, 10, &v), "read be32");
+	mu_assert_eq(v, 0x536f6d65, "be32 from the view");
+	mu_assert_false(rz_buf_read_be32_at(buf, length - 2, &v), "be32 across the end");
+
+	rz_buf_free(sparse);
+	rz_buf_free(slice);
+	rz_buf_free(buf);
+	mu_end;
+}
+
 int all_tests() {
 	time_t seed = time(0);
 	printf("Jamie Seed: %llu\n", (unsigned long long)seed);
@@ -1250,6 +1290,7 @@ int all_tests() {
 	mu_run_test(test_rz_buf_with_methods);
 	mu_run_test(test_rz_buf_whole_buf);
 	mu_run_test(test_rz_buf_whole_buf_alloc);
+	mu_run_test(test_rz_buf_view);
 	return tests_passed != tests_run;
 }
 
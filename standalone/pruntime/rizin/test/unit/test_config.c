@@ -50,9 +50,37 @@ bool test_config_lock() {
 	mu_end;
 }
 
+bool test_config_generation() {
+	RzConfig *cfg = rz_config_new(NULL);
+	ut64 gen = cfg->generation;
+
+	rz_config_set(cfg, "foo.bar", "bla");
+	mu_assert_neq(cfg->generation, gen, "new variable");
+	gen = cfg->generation;
+	rz_config_get(cfg, "foo.bar");
+	rz_config_get_i(cfg, "foo.bar");
+	mu_assert_eq(cfg->generation, gen, "reading does not change the generation");
+
+	rz_config_set_i(cfg, "foo.bar", 42);
+	mu_assert_neq(cfg->generation, gen, "integer write");
+	gen = cfg->generation;
+	rz_config_set_b(cfg, "true.or.false", true);
+	mu_assert_neq(cfg->generation, gen, "boolean write");
+	gen = cfg->generation;
+	rz_config_toggle(cfg, "true.or.false");
+	mu_assert_neq(cfg->generation, gen, "toggle");
+	gen = cfg->generation;
+	rz_config_rm(cfg, "foo.bar");
+	mu_assert_neq(cfg->generation, gen, "removal");
+
+	rz_config_free(cfg);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_config);
 	mu_run_test(test_config_lock);
+	mu_run_test(test_config_generation);
 	return tests_passed != tests_run;
 }
 
@@ -306,6 +306,85 @@ bool test_line_kill_word(void) {
 	mu_end;
 }
 
+static void print_disasm(int n) {
+	int i;
+	for (i = 0; i < n; i++) {
+		rz_cons_printf("0x%08x      %s 0x%x\n", 0x1000 + i * 4, i % 1000 ? "mov eax," : "call", i);
+	}
+	// not a complete line
+	rz_cons_strcat("0x0 call");
+}
+
+static char *grep_stream(const char *expr, int n) {
+	rz_cons_reset();
+	if (!rz_cons_grep_stream_begin(expr)) {
+		return NULL;
+	}
+	print_disasm(n);
+	// most of the output has been filtered already
+	if (rz_cons_get_buffer_len() > RZ_CONS_GREP_STREAM * 2) {
+		return NULL;
+	}
+	rz_cons_grep_stream_end();
+	return rz_cons_get_buffer_dup();
+}
+
+static char *grep_after(const char *expr, int n) {
+	rz_cons_reset();
+	print_disasm(n);
+	rz_cons_grep(expr);
+	return rz_cons_get_buffer_dup();
+}
+
+bool test_cons_grep_stream(void) {
+	const char *exprs[] = { "call", "!mov", "call[0,2]", "&0x1,call", "^0x0000100", "0x14$", NULL };
+	rz_cons_new();
+	int i;
+	for (i = 0; exprs[i]; i++) {
+		char *stream = grep_stream(exprs[i], 100000);
+		char *after = grep_after(exprs[i], 100000);
+		mu_assert_notnull(stream, "streamed");
+		mu_assert_notnull(after, "grepped");
+		mu_assert_streq(stream, after, "same output as grepping the whole buffer");
+		free(stream);
+		free(after);
+	}
+	rz_cons_reset();
+	mu_assert_false(rz_cons_grep_stream_begin("$0call"), "sorting needs the whole output");
+	mu_assert_false(rz_cons_grep_stream_begin("call~?"), "counting needs the whole output");
+	mu_assert_false(rz_cons_grep_stream_begin("{}"), "json needs the whole output");
+	mu_assert_false(rz_cons_grep_stream_begin("call:3"), "line selection needs the whole output");
+	rz_cons_free();
+	mu_end;
+}
+
+bool test_cons_grep_stream_flush(void) {
+	RzCons *cons = rz_cons_new();
+	FILE *out = tmpfile();
+	mu_assert_notnull(out, "tmpfile");
+	int fdout = cons->fdout;
+	cons->fdout = fileno(out);
+	rz_cons_reset();
+	mu_assert_true(rz_cons_grep_stream_begin("call"), "streamed");
+	rz_cons_strcat("0x1000 mov eax, 1\n0x1004 call 0x2000\n0x1008 ca");
+	// flushed while the last line is printed
+	rz_cons_flush();
+	rz_cons_strcat("ll 0x3000\n0x100c mov eax, 2\n0x1010 ca");
+	rz_cons_flush();
+	rz_cons_strcat("ll 0x4000 ; mov\n");
+	rz_cons_grep_stream_end();
+	rz_cons_flush();
+	cons->fdout = fdout;
+	char buf[128] = { 0 };
+	rewind(out);
+	mu_assert_true(fread(buf, 1, sizeof(buf) - 1, out) > 0, "read the output");
+	fclose(out);
+	mu_assert_streq(buf, "0x1004 call 0x2000\n0x1008 call 0x3000\n0x1010 call 0x4000 ; mov\n",
+		"lines printed across flushes are filtered once complete");
+	rz_cons_free();
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_cons);
 	mu_run_test(test_cons_to_html);
@@ -313,6 +392,8 @@ bool all_tests() {
 	mu_run_test(test_line_onecompletion);
 	mu_run_test(test_line_multicompletion);
 	mu_run_test(test_line_kill_word);
+	mu_run_test(test_cons_grep_stream);
+	mu_run_test(test_cons_grep_stream_flush);
 	return tests_passed != tests_run;
 }
 
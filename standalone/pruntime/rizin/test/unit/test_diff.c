@@ -257,10 +257,110 @@ bool test_rz_diff_unified_bytes(void) {
 	mu_end;
 }
 
+bool test_rz_diff_large_bytes(void) {
+	const ut32 a_size = 0x100000;
+	ut8 *a = malloc(a_size);
+	ut8 *b = malloc(a_size + 0x100);
+	ut32 i, seed = 7, b_size = 0;
+	for (i = 0; i < a_size; i++) {
+		seed = seed * 1103515245 + 12345;
+		a[i] = seed >> 16;
+	}
+	// insert 0x80 bytes, change 0x40 bytes, delete 0x800 bytes and flip a byte
+	memcpy(b, a, 0x1000);
+	memset(b + 0x1000, 0x41, 0x80);
+	b_size = 0x1080;
+	memcpy(b + b_size, a + 0x1000, 0x60000 - 0x1000);
+	b_size += 0x60000 - 0x1000;
+	memset(b + 0x30000, 0x42, 0x40);
+	memcpy(b + b_size, a + 0x60800, a_size - 0x60800);
+	b_size += a_size - 0x60800;
+	b[0x90000] ^= 0xff;
+
+	RzDiff *diff = rz_diff_bytes_new(a, a_size, b, b_size, NULL);
+	mu_assert_notnull(diff, "large diff");
+	RzList *ops = rz_diff_opcodes_new(diff);
+	mu_assert_notnull(ops, "large diff opcodes");
+	RzListIter *it;
+	RzDiffOp *op;
+	st32 a_end = 0, b_end = 0;
+	ut32 changed = 0;
+	rz_list_foreach (ops, it, op) {
+		mu_assert_eq(op->a_beg, a_end, "contiguous opcodes in A");
+		mu_assert_eq(op->b_beg, b_end, "contiguous opcodes in B");
+		if (op->type == RZ_DIFF_OP_EQUAL) {
+			mu_assert_eq(RZ_DIFF_OP_SIZE_A(op), RZ_DIFF_OP_SIZE_B(op), "equal sizes");
+			mu_assert_memeq(a + op->a_beg, b + op->b_beg, RZ_DIFF_OP_SIZE_A(op), "equal bytes");
+		} else {
+			changed += RZ_DIFF_OP_SIZE_A(op) + RZ_DIFF_OP_SIZE_B(op);
+		}
+		a_end = op->a_end;
+		b_end = op->b_end;
+	}
+	mu_assert_eq(a_end, a_size, "all of A");
+	mu_assert_eq(b_end, b_size, "all of B");
+	mu_assert_true(changed < 0x1000, "only the changes are reported");
+	double ratio;
+	mu_assert_true(rz_diff_ratio(diff, &ratio) && ratio > 0.99, "ratio");
+
+	rz_list_free(ops);
+	rz_diff_free(diff);
+	free(a);
+	free(b);
+	mu_end;
+}
+
+bool test_rz_diff_large_bytes_scattered(void) {
+	// a byte changed every 0x40 leaves no chunk to anchor on and needs 0x2000 edits
+	const ut32 size = 0x40000;
+	ut8 *a = malloc(size);
+	ut8 *b = malloc(size);
+	ut32 i, seed = 11;
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		a[i] = seed >> 16;
+	}
+	memcpy(b, a, size);
+	for (i = 0x20; i < size; i += 0x40) {
+		b[i] ^= 0xff;
+	}
+
+	RzDiff *diff = rz_diff_bytes_new(a, size, b, size, NULL);
+	mu_assert_notnull(diff, "large diff");
+	RzList *ops = rz_diff_opcodes_new(diff);
+	mu_assert_notnull(ops, "large diff opcodes");
+	RzListIter *it;
+	RzDiffOp *op;
+	st32 a_end = 0, b_end = 0;
+	ut32 changed = 0;
+	rz_list_foreach (ops, it, op) {
+		mu_assert_eq(op->a_beg, a_end, "contiguous opcodes in A");
+		mu_assert_eq(op->b_beg, b_end, "contiguous opcodes in B");
+		if (op->type == RZ_DIFF_OP_EQUAL) {
+			mu_assert_memeq(a + op->a_beg, b + op->b_beg, RZ_DIFF_OP_SIZE_A(op), "equal bytes");
+		} else {
+			changed += RZ_DIFF_OP_SIZE_A(op) + RZ_DIFF_OP_SIZE_B(op);
+		}
+		a_end = op->a_end;
+		b_end = op->b_end;
+	}
+	mu_assert_eq(a_end, size, "all of A");
+	mu_assert_eq(b_end, size, "all of B");
+	mu_assert_eq(changed, size / 0x40 * 2, "only the changed bytes are reported");
+
+	rz_list_free(ops);
+	rz_diff_free(diff);
+	free(a);
+	free(b);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_diff_distances);
 	mu_run_test(test_rz_diff_unified_lines);
 	mu_run_test(test_rz_diff_unified_bytes);
+	mu_run_test(test_rz_diff_large_bytes);
+	mu_run_test(test_rz_diff_large_bytes_scattered);
 	return tests_passed != tests_run;
 }
 
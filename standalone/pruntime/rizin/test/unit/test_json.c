@@ -10,6 +10,7 @@
 typedef struct json_test_t {
 	const char *json;
 	int (*check)(RzJson *j);
+	bool reader_valid; ///< accepted by RzJsonReader although invalid, since strings are not decoded
 } JsonTest;
 
 static int check_expected_0(RzJson *j) {
@@ -1194,7 +1195,7 @@ JsonTest tests[] = {
 		check_expected_46 },
 	{ // 47
 		"/* invalid unicode surrogate */ \"\\ud800\"\n",
-		NULL },
+		NULL, true },
 	{ // 48
 		"\"\\u041F\\u0440\\u043E\\u0432\\u0435\\u0440\\u043a\\u0430\"",
 		check_expected_48 },
@@ -1267,6 +1268,174 @@ static int test_json(int test_number, char *input, int (*check)(RzJson *j)) {
 	mu_end;
 }
 
+static const char reader_doc[] =
+	"{\"name\": \"main\", /* comment */ \"offset\": 4096, \"sig\": \"int \\\"x\\\"\","
+	" \"xrefs\": [{\"to\": 1, \"type\": \"C\"}, {\"to\": -2}],"
+	" \"bbs\": [[1, 2.5e3], {}], \"ok\": true, \"none\": null}";
+
+static int test_json_reader(void) {
+	static const struct {
+		RzJsonEvent ev;
+		RzJsonType type;
+		const char *key;
+		const char *value;
+		size_t depth;
+	} expect[] = {
+		{ RZ_JSON_EVENT_OBJECT, RZ_JSON_OBJECT, NULL, "{", 0 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_STRING, "name", "main", 1 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_INTEGER, "offset", "4096", 1 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_STRING, "sig", "int \\\"x\\\"", 1 },
+		{ RZ_JSON_EVENT_ARRAY, RZ_JSON_ARRAY, "xrefs", "[", 1 },
+		{ RZ_JSON_EVENT_OBJECT, RZ_JSON_OBJECT, NULL, "{", 2 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_INTEGER, "to", "1", 3 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_STRING, "type", "C", 3 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_OBJECT, NULL, "{\"to\": 1, \"type\": \"C\"}", 2 },
+		{ RZ_JSON_EVENT_OBJECT, RZ_JSON_OBJECT, NULL, "{", 2 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_INTEGER, "to", "-2", 3 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_OBJECT, NULL, "{\"to\": -2}", 2 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_ARRAY, NULL, "[{\"to\": 1, \"type\": \"C\"}, {\"to\": -2}]", 1 },
+		{ RZ_JSON_EVENT_ARRAY, RZ_JSON_ARRAY, "bbs", "[", 1 },
+		{ RZ_JSON_EVENT_ARRAY, RZ_JSON_ARRAY, NULL, "[", 2 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_INTEGER, NULL, "1", 3 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_DOUBLE, NULL, "2.5e3", 3 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_ARRAY, NULL, "[1, 2.5e3]", 2 },
+		{ RZ_JSON_EVENT_OBJECT, RZ_JSON_OBJECT, NULL, "{", 2 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_OBJECT, NULL, "{}", 2 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_ARRAY, NULL, "[[1, 2.5e3], {}]", 1 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_BOOLEAN, "ok", "true", 1 },
+		{ RZ_JSON_EVENT_VALUE, RZ_JSON_NULL, "none", "null", 1 },
+		{ RZ_JSON_EVENT_CLOSE, RZ_JSON_OBJECT, NULL, reader_doc, 0 },
+		{ RZ_JSON_EVENT_END, RZ_JSON_OBJECT, NULL, reader_doc, 0 },
+	};
+	RzJsonReader r;
+	rz_json_reader_init(&r, reader_doc);
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE(expect); i++) {
+		mu_assert_eq(rz_json_reader_next(&r), expect[i].ev, "event");
+		if (expect[i].ev == RZ_JSON_EVENT_END) {
+			break;
+		}
+		mu_assert_eq(r.type, expect[i].type, "type");
+		mu_assert_eq(r.depth, expect[i].depth, "depth");
+		if (expect[i].key) {
+			mu_assert_true(rz_json_reader_key_eq(&r, expect[i].key), "key");
+		} else {
+			mu_assert_null(r.key, "no key");
+		}
+		mu_assert_eq(r.value_len, strlen(expect[i].value), "value length");
+		mu_assert_memeq((const ut8 *)r.value, (const ut8 *)expect[i].value, r.value_len, "value");
+	}
+	mu_assert_eq(rz_json_reader_num(&r), 0, "num of an object");
+	rz_json_reader_fini(&r);
+
+	// skipping lands on the closing of the same value
+	rz_json_reader_init(&r, "[{\"a\": [1, \"]\", {}]}, 2]");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_ARRAY, "array");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_OBJECT, "object");
+	mu_assert_true(rz_json_reader_skip(&r), "skip");
+	mu_assert_eq(r.value_len, strlen("{\"a\": [1, \"]\", {}]}"), "skipped object");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_VALUE, "value");
+	mu_assert_eq(rz_json_reader_num(&r), 2, "value after the skipped one");
+	mu_assert_eq(r.index, 1, "index");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_CLOSE, "close");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_END, "end");
+	rz_json_reader_fini(&r);
+
+	// same state as reading the closing bracket
+	rz_json_reader_init(&r, "{\"k\": {\"a\": [1]}, \"n\": 2}");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_OBJECT, "object");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_OBJECT, "inner object");
+	mu_assert_true(rz_json_reader_key_eq(&r, "k"), "key");
+	mu_assert_true(rz_json_reader_skip(&r), "skip");
+	mu_assert_eq(r.event, RZ_JSON_EVENT_CLOSE, "close");
+	mu_assert_eq(r.type, RZ_JSON_OBJECT, "closed object");
+	mu_assert_null(r.key, "no key on close");
+	mu_assert_eq(r.depth, 1, "depth after skip");
+	mu_assert_eq(r.index, 0, "index after skip");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_VALUE, "value");
+	mu_assert_true(rz_json_reader_key_eq(&r, "n"), "key after the skipped one");
+	mu_assert_eq(r.index, 1, "index");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_CLOSE, "close");
+	mu_assert_eq(r.depth, 0, "depth");
+	mu_assert_eq(rz_json_reader_next(&r), RZ_JSON_EVENT_END, "end");
+	rz_json_reader_fini(&r);
+	mu_end;
+}
+
+static int test_json_reader_invalid(void) {
+	size_t i;
+	for (i = 1; i < sizeof(tests) / sizeof(tests[0]); i++) {
+		RzJsonReader r;
+		rz_json_reader_init(&r, tests[i].json);
+		RzJsonEvent ev;
+		do {
+			ev = rz_json_reader_next(&r);
+		} while (ev != RZ_JSON_EVENT_END && ev != RZ_JSON_EVENT_ERROR);
+		rz_json_reader_fini(&r);
+		mu_assert_eq(ev == RZ_JSON_EVENT_END, tests[i].check || tests[i].reader_valid, tests[i].json);
+	}
+	mu_end;
+}
+
+typedef struct {
+	RzStrBuf sb;
+	size_t count;
+} PathScan;
+
+static bool path_scan_cb(void *user, size_t path, const RzJsonReader *r) {
+	PathScan *ps = user;
+	rz_strbuf_appendf(&ps->sb, "%u:%.*s;", (unsigned int)path, (int)r->value_len, r->value);
+	return ++ps->count < 5;
+}
+
+static int test_json_path(void) {
+	char *v = rz_json_path_get(reader_doc, "xrefs[1].to");
+	mu_assert_streq_free(v, "-2", "path");
+	v = rz_json_path_get(reader_doc, ".name");
+	mu_assert_streq_free(v, "main", "leading dot");
+	v = rz_json_path_get(reader_doc, "bbs[0]");
+	mu_assert_streq_free(v, "[1, 2.5e3]", "array");
+	v = rz_json_path_get(reader_doc, "xrefs[0]");
+	mu_assert_streq_free(v, "{\"to\": 1, \"type\": \"C\"}", "object");
+	mu_assert_null(rz_json_path_get(reader_doc, "xrefs[2]"), "out of bounds");
+	mu_assert_null(rz_json_path_get(reader_doc, "[0]"), "not an array");
+	mu_assert_null(rz_json_path_get(reader_doc, "xrefs[x]"), "bad path");
+	mu_assert_null(rz_json_path_get("[1, 2", "[2]"), "truncated");
+
+	RzJsonPath *paths[] = {
+		rz_json_path_new("xrefs[*].to"),
+		rz_json_path_new("xrefs[*]"),
+		rz_json_path_new("offset"),
+	};
+	PathScan ps = { 0 };
+	rz_strbuf_init(&ps.sb);
+	mu_assert_true(rz_json_path_scan(reader_doc, paths, RZ_ARRAY_SIZE(paths), path_scan_cb, &ps), "scan");
+	mu_assert_streq(rz_strbuf_get(&ps.sb), "2:4096;0:1;1:{\"to\": 1, \"type\": \"C\"};0:-2;1:{\"to\": -2};", "all values in one pass");
+	rz_strbuf_fini(&ps.sb);
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE(paths); i++) {
+		rz_json_path_free(paths[i]);
+	}
+	mu_end;
+}
+
+static int test_json_hashed_keys(void) {
+	char *text = strdup("{\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,\"k5\":5,\"k6\":6,\"k7\":7,\"k8\":8,\"k8\":9,\"k\":10}");
+	RzJson *json = rz_json_parse(text);
+	mu_assert_notnull(json, "parse");
+	mu_assert_notnull(json->children.keys, "keys are hashed");
+	const RzJson *v = rz_json_get(json, "k8");
+	mu_assert_eq(v ? v->num.u_value : -1, 8, "first one wins");
+	v = rz_json_get(json, "k");
+	mu_assert_eq(v ? v->num.u_value : -1, 10, "no prefix match");
+	mu_assert_null(rz_json_get(json, "k9"), "missing");
+	v = rz_json_get_path(json, ".k3");
+	mu_assert_eq(v ? v->num.u_value : -1, 3, "path");
+	rz_json_free(json);
+	free(text);
+	mu_end;
+}
+
 static int all_tests(void) {
 	size_t i;
 	for (i = 1; i < sizeof(tests) / sizeof(tests[0]); i++) {
@@ -1276,6 +1445,10 @@ static int all_tests(void) {
 		mu_run_test_named(test_json, testname, i, input, tests[i].check);
 		free(input);
 	}
+	mu_run_test(test_json_reader);
+	mu_run_test(test_json_reader_invalid);
+	mu_run_test(test_json_path);
+	mu_run_test(test_json_hashed_keys);
 	return tests_passed != tests_run;
 }
 
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_reg.h>
+#include <rz_util.h>
 #include "minunit.h"
 
 bool test_rz_reg_set_name(void) {
@@ -237,6 +238,60 @@ bool test_rz_reg_get_pack(void) {
 	mu_end;
 }
 
+bool test_rz_reg_handle(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_notnull(reg, "rz_reg_new () failed");
+
+	bool success = rz_reg_set_profile_string(reg,
+		"=PC	eip\n\
+		=SP	esp\n\
+		gpr	eip	.32	0	0\n\
+		gpr	esp	.32	4	0\n\
+		gpr	sp	.16	4	0\n\
+		gpr	cf	.1	.64	0\n\
+		fpu	st0	.80	0	0");
+	mu_assert_true(success, "set profile");
+
+	RzRegHandle pc = rz_reg_handle(reg, "PC");
+	mu_assert_neq(pc, RZ_REG_HANDLE_INVALID, "PC alias resolved");
+	mu_assert_eq(pc, rz_reg_handle(reg, "eip"), "alias and name share the handle");
+	mu_assert_streq(rz_reg_handle_item(reg, pc)->name, "eip", "handle item");
+	mu_assert_eq(rz_reg_handle(reg, "0x1234"), RZ_REG_HANDLE_INVALID, "not a register");
+	mu_assert_null(rz_reg_handle_item(reg, RZ_REG_HANDLE_INVALID), "invalid handle");
+
+	mu_assert_true(rz_reg_handle_set_value(reg, pc, 0x8048000), "set pc");
+	mu_assert_eq(rz_reg_getv(reg, "eip"), 0x8048000, "pc written in the arena");
+
+	RzRegHandle esp = rz_reg_handle(reg, "SP");
+	RzRegHandle sp = rz_reg_handle(reg, "sp");
+	rz_reg_setv(reg, "esp", 0x11223344);
+	mu_assert_eq(rz_reg_handle_get_value(reg, esp), 0x11223344, "get esp");
+	mu_assert_eq(rz_reg_handle_get_value(reg, sp), 0x3344, "get sp");
+	rz_reg_handle_set_value(reg, sp, 0xabcd);
+	mu_assert_eq(rz_reg_handle_get_value(reg, esp), 0x1122abcd, "sp aliases the low bits of esp");
+
+	RzRegHandle cf = rz_reg_handle(reg, "cf");
+	rz_reg_handle_set_value(reg, cf, 1);
+	mu_assert_eq(rz_reg_handle_get_value(reg, cf), 1, "bit registers go through the slow path");
+	mu_assert_eq(rz_reg_handle_get_value(reg, esp), 0x1122abcd, "cf does not overlap esp");
+
+	rz_reg_set_roregs(reg, rz_str_split_duplist("eip", ",", true));
+	mu_assert_true(rz_reg_handle_set_value(reg, pc, 0x1337), "writing a ro register is not an error");
+	mu_assert_eq(rz_reg_handle_get_value(reg, pc), 0x8048000, "ro register untouched");
+	mu_assert_true(rz_reg_is_readonly(reg, rz_reg_handle_item(reg, pc)), "eip is ro");
+	rz_reg_set_roregs(reg, NULL);
+	rz_reg_handle_set_value(reg, pc, 0x1337);
+	mu_assert_eq(rz_reg_handle_get_value(reg, pc), 0x1337, "eip writable again");
+
+	rz_reg_set_name(reg, RZ_REG_NAME_PC, "esp");
+	mu_assert_eq(rz_reg_handle(reg, "PC"), esp, "alias follows rz_reg_set_name");
+	rz_reg_set_name(reg, RZ_REG_NAME_PC, "nope");
+	mu_assert_null(rz_reg_get(reg, "PC", -1), "alias to a missing register");
+
+	rz_reg_free(reg);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_reg_set_name);
 	mu_run_test(test_rz_reg_set_profile_string);
@@ -245,6 +300,7 @@ int all_tests() {
 	mu_run_test(test_rz_reg_get);
 	mu_run_test(test_rz_reg_get_list);
 	mu_run_test(test_rz_reg_get_pack);
+	mu_run_test(test_rz_reg_handle);
 	return tests_passed != tests_run;
 }
 
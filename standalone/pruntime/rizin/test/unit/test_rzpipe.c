@@ -30,9 +30,147 @@ static bool test_rzpipe_404(void) {
 	mu_end;
 }
 
+static bool test_rzpipe_batch(void) {
+	RzPVector *cmds = rz_pvector_new(NULL);
+	rz_pvector_push(cmds, "?e a");
+	rz_pvector_push(cmds, "");
+	rz_pvector_push(cmds, "?e bc");
+	ut32 size = 0;
+	ut8 *buf = rzpipe_batch_pack(cmds, &size);
+	mu_assert_eq(size, 4 + 3 * 4 + 4 + 5, "batch size");
+	RzPVector *res = rzpipe_batch_unpack(buf, size);
+	mu_assert_eq(rz_pvector_len(res), 3, "batch count");
+	mu_assert_streq(rz_pvector_at(res, 0), "?e a", "first");
+	mu_assert_streq(rz_pvector_at(res, 1), "", "empty");
+	mu_assert_streq(rz_pvector_at(res, 2), "?e bc", "last");
+	rz_pvector_free(res);
+	mu_assert_null(rzpipe_batch_unpack(buf, size - 1), "truncated batch");
+	free(buf);
+	rz_pvector_free(cmds);
+	mu_end;
+}
+
+static char *echo_cmd(void *user, const char *cmd) {
+	(*(int *)user)++;
+	if (!strcmp(cmd, "big")) {
+		// one byte more than a frame can carry
+		char *res = malloc(RZPIPE_FRAME_MAX + 2);
+		if (res) {
+			memset(res, 'x', RZPIPE_FRAME_MAX + 1);
+			res[RZPIPE_FRAME_MAX + 1] = 0;
+		}
+		return res;
+	}
+	return rz_str_newf("<%s>", cmd);
+}
+
+static bool test_rzpipe_frame_serve(void) {
+#ifndef __WINDOWS__
+	int req[2], res[2];
+	mu_assert_eq(rz_sys_pipe(req, false), 0, "pipe");
+	mu_assert_eq(rz_sys_pipe(res, false), 0, "pipe");
+	// all the requests are in flight before the server reads any of them
+	mu_assert_true(rzpipe_frame_write(req[1], RZPIPE_FRAME_CMD, 7, (const ut8 *)"a", 1), "write");
+	mu_assert_true(rzpipe_frame_write(req[1], RZPIPE_FRAME_CMD, 8, (const ut8 *)"b", 1), "write");
+	RzPVector *cmds = rz_pvector_new(NULL);
+	rz_pvector_push(cmds, "c");
+	rz_pvector_push(cmds, "d");
+	ut32 size;
+	ut8 *payload = rzpipe_batch_pack(cmds, &size);
+	rz_pvector_free(cmds);
+	mu_assert_true(rzpipe_frame_write(req[1], RZPIPE_FRAME_BATCH, 9, payload, size), "write");
+	free(payload);
+	mu_assert_true(rzpipe_frame_write(req[1], 0x42, 10, NULL, 0), "write");
+	mu_assert_true(rzpipe_frame_write(req[1], RZPIPE_FRAME_CMD, 11, (const ut8 *)"big", 3), "write");
+	mu_assert_false(rzpipe_frame_write(req[1], RZPIPE_FRAME_RESULT, 12, (const ut8 *)"", RZPIPE_FRAME_MAX + 1), "frame too large");
+	rz_sys_pipe_close(req[1]);
+
+	int calls = 0;
+	mu_assert_true(rzpipe_frame_serve(req[0], res[1], echo_cmd, &calls), "served until eof");
+	rz_sys_pipe_close(req[0]);
+	rz_sys_pipe_close(res[1]);
+	mu_assert_eq(calls, 5, "commands run");
+
+	RzPipeFrame *f = rzpipe_frame_read(res[0]);
+	mu_assert_eq(f->type, RZPIPE_FRAME_RESULT, "result");
+	mu_assert_eq(f->id, 7, "id");
+	mu_assert_streq((char *)f->data, "<a>", "output");
+	rzpipe_frame_free(f);
+	f = rzpipe_frame_read(res[0]);
+	mu_assert_eq(f->id, 8, "id");
+	mu_assert_streq((char *)f->data, "<b>", "output");
+	rzpipe_frame_free(f);
+	f = rzpipe_frame_read(res[0]);
+	mu_assert_eq(f->type, RZPIPE_FRAME_BATCH_RESULT, "batch result");
+	mu_assert_eq(f->id, 9, "id");
+	RzPVector *outs = rzpipe_batch_unpack(f->data, f->size);
+	mu_assert_eq(rz_pvector_len(outs), 2, "batch outputs");
+	mu_assert_streq(rz_pvector_at(outs, 1), "<d>", "batch output");
+	rz_pvector_free(outs);
+	rzpipe_frame_free(f);
+	f = rzpipe_frame_read(res[0]);
+	mu_assert_eq(f->type, RZPIPE_FRAME_ERROR, "unknown request");
+	mu_assert_eq(f->id, 10, "id");
+	rzpipe_frame_free(f);
+	f = rzpipe_frame_read(res[0]);
+	mu_assert_eq(f->type, RZPIPE_FRAME_ERROR, "result too large");
+	mu_assert_eq(f->id, 11, "id");
+	rzpipe_frame_free(f);
+	mu_assert_null(rzpipe_frame_read(res[0]), "eof");
+	rz_sys_pipe_close(res[0]);
+#else
+	mu_test_status = MU_TEST_BROKEN;
+#endif
+	mu_end;
+}
+
+static bool test_rzpipe_framed(void) {
+#ifndef __WINDOWS__
+	RzPipe *r = rzpipe_open(RIZIN_BUILD_PATH " -q0 =");
+	mu_assert("rzpipe can spawn", r);
+	mu_assert_true(rzpipe_framed(r), "switch to frames");
+	ut32 a = rzpipe_send(r, "?e hello");
+	ut32 b = rzpipe_send(r, "?v 0x10+1");
+	RzPVector *cmds = rz_pvector_new(NULL);
+	rz_pvector_push(cmds, "?e one");
+	rz_pvector_push(cmds, "?e two");
+	ut32 c = rzpipe_send_batch(r, cmds);
+	rz_pvector_free(cmds);
+	mu_assert_true(a && b && c && a != b && b != c, "request ids");
+
+	RzPipeFrame *f = rzpipe_recv(r);
+	mu_assert_eq(f->id, a, "first answer");
+	mu_assert_streq((char *)f->data, "hello\n", "first output");
+	rzpipe_frame_free(f);
+	f = rzpipe_recv(r);
+	mu_assert_eq(f->id, b, "second answer");
+	mu_assert_streq((char *)f->data, "0x11\n", "second output");
+	rzpipe_frame_free(f);
+	f = rzpipe_recv(r);
+	mu_assert_eq(f->id, c, "batch answer");
+	RzPVector *outs = rzpipe_batch_unpack(f->data, f->size);
+	mu_assert_eq(rz_pvector_len(outs), 2, "batch outputs");
+	mu_assert_streq(rz_pvector_at(outs, 0), "one\n", "batch output");
+	mu_assert_streq(rz_pvector_at(outs, 1), "two\n", "batch output");
+	rz_pvector_free(outs);
+	rzpipe_frame_free(f);
+
+	char *s = rzpipe_cmd(r, "?e framed cmd");
+	mu_assert_streq(s, "framed cmd\n", "rzpipe_cmd over frames");
+	free(s);
+	rzpipe_close(r);
+#else
+	mu_test_status = MU_TEST_BROKEN;
+#endif
+	mu_end;
+}
+
 static int all_tests() {
 	mu_run_test(test_rzpipe);
 	mu_run_test(test_rzpipe_404);
+	mu_run_test(test_rzpipe_batch);
+	mu_run_test(test_rzpipe_frame_serve);
+	mu_run_test(test_rzpipe_framed);
 	return tests_passed != tests_run;
 }
 
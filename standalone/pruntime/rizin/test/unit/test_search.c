@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include "minunit.h"
+
+static const ut8 haystack[] =
+	"\x55\x48\x89\xe5\x90\x90Hello hello HELLO\x00\x55\x48\x89\xe5"
+	"\xc3\xcc\xcc\x55\x48\x89\xe5\x41\x41\x41\x41\x41world\xde\xad\xbe\xef";
+
+static void add_keywords(RzSearch *s) {
+	rz_search_kw_add(s, rz_search_keyword_new_hex("554889e5", NULL, NULL));
+	rz_search_kw_add(s, rz_search_keyword_new_str("hello", NULL, NULL, true));
+	rz_search_kw_add(s, rz_search_keyword_new_str("world", NULL, NULL, false));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("de00be", "ff00ff", NULL));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("4141", NULL, NULL));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("c3cc", "0f0f", NULL));
+}
+
+static int hit_cmp(const void *a, const void *b) {
+	const RzSearchHit *ha = a, *hb = b;
+	if (ha->kw->kwidx != hb->kw->kwidx) {
+		return ha->kw->kwidx - hb->kw->kwidx;
+	}
+	return ha->addr < hb->addr ? -1 : ha->addr > hb->addr;
+}
+
+/*
+ * Keywords sharing prefixes and suffixes, so that matches of the automaton go
+ * through the failure links of the states
+ */
+static void add_overlapping_keywords(RzSearch *s) {
+	static const char *kws[] = {
+		"ello", "llo", "lo h", "hell", "hello", "o hel", "lo HE", "LLO", "HELLO", "ELL",
+		"41414141", "414141", "41e5", "4889e5", "89e54141", "e590", "9090", "554889"
+	};
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE(kws); i++) {
+		RzSearchKeyword *kw = i < 10
+			? rz_search_keyword_new_str(kws[i], NULL, NULL, i % 3 == 0)
+			: rz_search_keyword_new_hex(kws[i], NULL, NULL);
+		rz_search_kw_add(s, kw);
+	}
+}
+
+/* Search haystack in blocks of bsize bytes and return the sorted hits */
+static RzList *search_blocks_with(void (*add)(RzSearch *), int mode, bool overlap, int bsize) {
+	RzSearch *s = rz_search_new(mode);
+	s->overlap = overlap;
+	add(s);
+	rz_search_begin(s);
+	int len = sizeof(haystack) - 1, off;
+	ut8 buf[sizeof(haystack)];
+	for (off = 0; off < len; off += bsize) {
+		int n = RZ_MIN(bsize, len - off);
+		memcpy(buf, haystack + off, n);
+		rz_search_update(s, off, buf, n);
+	}
+	RzList *hits = rz_list_newf(free);
+	RzListIter *it;
+	RzSearchHit *h;
+	rz_list_foreach (s->hits, it, h) {
+		RzSearchHit *c = RZ_NEW(RzSearchHit);
+		*c = *h;
+		c->kw = RZ_NEW0(RzSearchKeyword);
+		c->kw->kwidx = h->kw->kwidx;
+		rz_list_append(hits, c);
+	}
+	rz_search_free(s);
+	rz_list_sort(hits, hit_cmp);
+	return hits;
+}
+
+static RzList *search_blocks(int mode, bool overlap, int bsize) {
+	return search_blocks_with(add_keywords, mode, overlap, bsize);
+}
+
+static bool same_hits(RzList *a, RzList *b) {
+	if (rz_list_length(a) != rz_list_length(b)) {
+		return false;
+	}
+	RzListIter *ia, *ib;
+	for (ia = rz_list_iterator(a), ib = rz_list_iterator(b); ia && ib; ia = ia->n, ib = ib->n) {
+		if (hit_cmp(ia->data, ib->data)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void hits_free(RzList *hits) {
+	RzListIter *it;
+	RzSearchHit *h;
+	rz_list_foreach (hits, it, h) {
+		free(h->kw);
+	}
+	rz_list_free(hits);
+}
+
+bool test_search_multi_keywords(void) {
+	RzList *hits = search_blocks(RZ_SEARCH_MULTI, true, 0x100);
+	// 3 preludes, 3 hellos, 1 world, 1 deadbeef, 4 overlapping AA, 1 c3cc
+	mu_assert_eq(rz_list_length(hits), 13, "hits");
+	RzSearchHit *h = rz_list_first(hits);
+	mu_assert_eq(h->kw->kwidx, 0, "first keyword");
+	mu_assert_eq(h->addr, 0, "prelude at 0");
+	hits_free(hits);
+	mu_end;
+}
+
+bool test_search_multi_same_as_keyword(void) {
+	int overlap;
+	for (overlap = 0; overlap < 2; overlap++) {
+		RzList *expect = search_blocks(RZ_SEARCH_KEYWORD, overlap, sizeof(haystack));
+		RzList *hits = search_blocks(RZ_SEARCH_MULTI, overlap, sizeof(haystack));
+		bool same = same_hits(expect, hits);
+		hits_free(expect);
+		hits_free(hits);
+		mu_assert_true(same, "same hits as RZ_SEARCH_KEYWORD");
+	}
+	mu_end;
+}
+
+bool test_search_multi_blocks(void) {
+	int overlap, bsize;
+	for (overlap = 0; overlap < 2; overlap++) {
+		RzList *expect = search_blocks(RZ_SEARCH_MULTI, overlap, sizeof(haystack));
+		for (bsize = 3; bsize <= 0x40; bsize++) {
+			RzList *hits = search_blocks(RZ_SEARCH_MULTI, overlap, bsize);
+			bool same = same_hits(expect, hits);
+			hits_free(hits);
+			mu_assert_true(same, "matches across blocks are found once");
+		}
+		hits_free(expect);
+	}
+	mu_end;
+}
+
+bool test_search_multi_failure_links(void) {
+	int overlap, bsize;
+	for (overlap = 0; overlap < 2; overlap++) {
+		RzList *expect = search_blocks_with(add_overlapping_keywords, RZ_SEARCH_KEYWORD, overlap, sizeof(haystack));
+		for (bsize = 5; bsize <= sizeof(haystack); bsize += 7) {
+			RzList *hits = search_blocks_with(add_overlapping_keywords, RZ_SEARCH_MULTI, overlap, bsize);
+			bool same = same_hits(expect, hits);
+			hits_free(hits);
+			mu_assert_true(same, "same hits as RZ_SEARCH_KEYWORD");
+		}
+		mu_assert_true(rz_list_length(expect) > 20, "keywords found");
+		hits_free(expect);
+	}
+	mu_end;
+}
+
+static RzList *search_single(RzSearchKeyword *kw) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_MULTI);
+	s->overlap = false;
+	rz_search_kw_add(s, kw);
+	rz_search_begin(s);
+	ut8 buf[sizeof(haystack)];
+	memcpy(buf, haystack, sizeof(haystack));
+	rz_search_update(s, 0, buf, sizeof(haystack) - 1);
+	RzList *r = rz_list_newf(NULL);
+	RzListIter *it;
+	RzSearchHit *h;
+	rz_list_foreach (s->hits, it, h) {
+		rz_list_append(r, (void *)(size_t)h->addr);
+	}
+	rz_search_free(s);
+	return r;
+}
+
+bool test_search_multi_single(void) {
+	// the hit right after the first one is dropped as sequential, the one after is overlapping
+	RzList *hits = search_single(rz_search_keyword_new_hex("4141", NULL, NULL));
+	mu_assert_eq(rz_list_length(hits), 1, "non overlapping hits");
+	mu_assert_eq((size_t)rz_list_first(hits), 0x23, "hit");
+	rz_list_free(hits);
+
+	hits = search_single(rz_search_keyword_new_hex("55ff89e5", "ff00ffff", NULL));
+	mu_assert_eq(rz_list_length(hits), 3, "masked hits");
+	mu_assert_eq((size_t)rz_list_last(hits), 0x1f, "masked hit");
+	rz_list_free(hits);
+
+	// only letters, icase needs the automaton
+	hits = search_single(rz_search_keyword_new_str("hello", NULL, NULL, true));
+	mu_assert_eq(rz_list_length(hits), 3, "icase hits");
+	mu_assert_eq((size_t)rz_list_last(hits), 0x12, "icase hit");
+	rz_list_free(hits);
+	mu_end;
+}
+
+bool test_search_multi_maxhits(void) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_MULTI);
+	s->overlap = true;
+	s->maxhits = 2;
+	add_keywords(s);
+	rz_search_begin(s);
+	ut8 buf[sizeof(haystack)];
+	memcpy(buf, haystack, sizeof(haystack));
+	rz_search_update(s, 0, buf, sizeof(haystack) - 1);
+	mu_assert_eq(rz_list_length(s->hits), 2, "stopped at maxhits");
+	rz_search_free(s);
+	mu_end;
+}
+
+static RzList *search_regexp(const char *re, int bsize, RzPVector **compiled) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_REGEXP);
+	s->contiguous = true;
+	rz_search_kw_add(s, rz_search_keyword_new_regexp(re, NULL));
+	rz_search_begin(s);
+	int len = sizeof(haystack) - 1, off;
+	for (off = 0; off < len; off += bsize) {
+		rz_search_update(s, off, haystack + off, RZ_MIN(bsize, len - off));
+		if (compiled && off) {
+			mu_assert_ptreq(s->regexes, *compiled, "compiled once");
+		} else if (compiled) {
+			*compiled = s->regexes;
+		}
+	}
+	RzList *r = rz_list_newf(NULL);
+	RzListIter *it;
+	RzSearchHit *h;
+	rz_list_foreach (s->hits, it, h) {
+		rz_list_append(r, (void *)(size_t)h->addr);
+	}
+	rz_search_free(s);
+	return r;
+}
+
+bool test_search_regexp(void) {
+	int bsize;
+	for (bsize = 2; bsize <= 0x40; bsize++) {
+		RzPVector *compiled = NULL;
+		RzList *hits = search_regexp("/[hH]el+o/", bsize, &compiled);
+		mu_assert_eq(rz_list_length(hits), 2, "hits across chunks");
+		mu_assert_eq((size_t)rz_list_first(hits), 0x6, "first hit");
+		mu_assert_eq((size_t)rz_list_last(hits), 0xc, "second hit");
+		rz_list_free(hits);
+
+		hits = search_regexp("/A+w/", bsize, NULL);
+		mu_assert_eq(rz_list_length(hits), 1, "one hit");
+		mu_assert_eq((size_t)rz_list_first(hits), 0x23, "longest match across chunks");
+		rz_list_free(hits);
+	}
+	// empty matches used to loop forever
+	RzList *hits = search_regexp("/x*/", 0x10, NULL);
+	mu_assert_eq(rz_list_length(hits), 0, "empty matches are ignored");
+	rz_list_free(hits);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_search_multi_keywords);
+	mu_run_test(test_search_multi_same_as_keyword);
+	mu_run_test(test_search_multi_blocks);
+	mu_run_test(test_search_multi_failure_links);
+	mu_run_test(test_search_multi_single);
+	mu_run_test(test_search_multi_maxhits);
+	mu_run_test(test_search_regexp);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_socket.h>
+#include "minunit.h"
+
+#if __UNIX__
+static RzSocket *listen_any(char *port, size_t size) {
+	RzSocket *s = rz_socket_new(false);
+	int p;
+	for (p = 19190; s && p < 19290; p++) {
+		snprintf(port, size, "%d", p);
+		s->local = true;
+		if (rz_socket_listen(s, port, NULL)) {
+			return s;
+		}
+	}
+	rz_socket_free(s);
+	return NULL;
+}
+
+/* answer \p n requests with their path and exit */
+static void serve(RzSocket *s, int n) {
+	RzSocketHTTPOptions so = { 0 };
+	RzSocketHTTPServer *hs = rz_socket_http_server_new(s, &so);
+	while (n > 0) {
+		RzSocketHTTPRequest *rs = rz_socket_http_server_accept(hs, 1000);
+		if (!rs) {
+			continue;
+		}
+		rz_socket_http_response(rs, rs->keep_alive ? 200 : 403, rs->path, 0, NULL);
+		rz_socket_http_server_done(hs, rs);
+		n--;
+	}
+	rz_socket_http_server_free(hs);
+	rz_socket_free(s);
+	_exit(0);
+}
+#endif
+
+static bool test_http_server_keep_alive(void) {
+#if __UNIX__
+	char port[8];
+	RzSocket *s = listen_any(port, sizeof(port));
+	mu_assert_notnull(s, "listen");
+	int pid = rz_sys_fork();
+	if (!pid) {
+		serve(s, 3);
+	}
+
+	// two requests in flight on the same connection
+	RzSocket *c = rz_socket_new(false);
+	mu_assert_true(rz_socket_connect_tcp(c, "127.0.0.1", port, 0), "connect");
+	char req[] = "GET /a HTTP/1.1\r\nHost: x\r\n\r\nGET /bc HTTP/1.1\r\nConnection: close\r\n\r\n";
+	rz_socket_write(c, req, strlen(req));
+	int len = 0;
+	ut8 *out = NULL, *buf = malloc(4096);
+	while (buf) {
+		int r = rz_socket_read(c, buf + len, 4095 - len);
+		if (r <= 0) {
+			break;
+		}
+		len += r;
+	}
+	if (buf) {
+		buf[len] = 0;
+		out = buf;
+	}
+	mu_assert_notnull(out, "answers");
+	mu_assert_streq((char *)out,
+		"HTTP/1.1 200 ok\r\nConnection: keep-alive\r\nContent-Length: 2\r\n\r\n/a"
+		"HTTP/1.1 403 Permission denied\r\nConnection: close\r\nContent-Length: 3\r\n\r\n/bc",
+		"answers in order, the second one closes the connection");
+	free(out);
+	rz_socket_free(c);
+
+	// HTTP/1.0 clients are not kept
+	c = rz_socket_new(false);
+	mu_assert_true(rz_socket_connect_tcp(c, "127.0.0.1", port, 0), "connect");
+	rz_socket_puts(c, "GET /d HTTP/1.0\r\n\r\n");
+	char line[64];
+	rz_socket_gets(c, line, sizeof(line));
+	mu_assert_streq(line, "HTTP/1.0 403 Permission denied", "http 1.0");
+	rz_socket_free(c);
+	waitpid(pid, NULL, 0);
+	// closing shuts the listening socket down, only once the server is done
+	rz_socket_free(s);
+#endif
+	mu_end;
+}
+
+static bool test_http_server_idle_timeout(void) {
+#if __UNIX__
+	char port[8];
+	RzSocket *s = listen_any(port, sizeof(port));
+	mu_assert_notnull(s, "listen");
+	RzSocketHTTPOptions so = { .timeout = 1 };
+	RzSocketHTTPServer *hs = rz_socket_http_server_new(s, &so);
+	RzSocket *c = rz_socket_new(false);
+	mu_assert_true(rz_socket_connect_tcp(c, "127.0.0.1", port, 0), "connect");
+	rz_socket_puts(c, "GET /a HTTP/1.1\r\nHost: x\r\n\r\n");
+	RzSocketHTTPRequest *rs = rz_socket_http_server_accept(hs, 1000);
+	mu_assert_notnull(rs, "request");
+	rz_socket_http_response(rs, 200, rs->path, 0, NULL);
+	rz_socket_http_server_done(hs, rs);
+	mu_assert_eq(rz_vector_len(&hs->idle), 1, "connection kept");
+
+	// waiting for ever still closes the idle connection once its time is up
+	ut64 t0 = rz_time_now_mono();
+	mu_assert_null(rz_socket_http_server_accept(hs, -1), "no request");
+	mu_assert_eq(rz_vector_len(&hs->idle), 0, "connection closed");
+	mu_assert_true(rz_time_now_mono() - t0 < 3 * RZ_USEC_PER_SEC, "on time");
+	rz_socket_free(c);
+	rz_socket_http_server_free(hs);
+	rz_socket_free(s);
+#endif
+	mu_end;
+}
+
+static bool test_http_bench(void) {
+#if __UNIX__
+	char port[8];
+	RzSocket *s = listen_any(port, sizeof(port));
+	mu_assert_notnull(s, "listen");
+	int pid = rz_sys_fork();
+	if (!pid) {
+		serve(s, 20);
+	}
+	RzSocketHTTPBench res;
+	mu_assert_true(rz_socket_http_bench("127.0.0.1", port, "/x", 20, 4, &res), "bench");
+	mu_assert_eq(res.ok, 20, "all answered");
+	mu_assert_eq(res.failed, 0, "none failed");
+	waitpid(pid, NULL, 0);
+	rz_socket_free(s);
+#endif
+	mu_end;
+}
+
+static int all_tests() {
+	mu_run_test(test_http_server_keep_alive);
+	mu_run_test(test_http_server_idle_timeout);
+	mu_run_test(test_http_bench);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
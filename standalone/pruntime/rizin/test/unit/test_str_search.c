@@ -184,6 +184,24 @@ bool test_rz_scan_strings_utf16_be(void) {
 	mu_end;
 }
 
+bool test_rz_scan_strings_raw(void) {
+	static const unsigned char str[] = "\xff\xff\xffI am an ASCII string\xff\xff";
+
+	// the bytes start at address 0x1000
+	g_opt.prefer_big_endian = false;
+	RzList *str_list = rz_list_newf((RzListFree)rz_detected_string_free);
+	int n = rz_scan_strings_raw(str, str_list, &g_opt, 0x1000, 0x1000 + sizeof(str) - 1, RZ_STRING_ENC_GUESS);
+	mu_assert_eq(n, 1, "rz_scan_strings_raw, number of strings");
+
+	RzDetectedString *s = rz_list_get_n(str_list, 0);
+	mu_assert_streq(s->string, "I am an ASCII string", "rz_scan_strings_raw, different string");
+	mu_assert_eq(s->addr, 0x1003, "rz_scan_strings_raw, address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_LATIN1, "rz_scan_strings_raw, string type");
+	rz_list_free(str_list);
+
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_ascii);
 	mu_run_test(test_rz_scan_strings_detect_utf8);
@@ -193,6 +211,7 @@ bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_utf32_be);
 
 	mu_run_test(test_rz_scan_strings_utf16_be);
+	mu_run_test(test_rz_scan_strings_raw);
 	return tests_passed != tests_run;
 }
 
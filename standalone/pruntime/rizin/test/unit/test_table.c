@@ -114,6 +114,59 @@ bool test_rz_table_sort1(void) {
 	mu_end;
 }
 
+bool test_rz_table_sort_stable(void) {
+	RzTable *t = rz_table_new();
+	rz_table_add_column(t, rz_table_type("string"), "name", 0);
+	rz_table_add_column(t, rz_table_type("number"), "addr", 0);
+	rz_table_add_row(t, "b", "0x100000000", NULL);
+	rz_table_add_row(t, "a", "0x200000000", NULL);
+	rz_table_add_row(t, "b", "0x10", NULL);
+	rz_table_add_row(t, "a", "16", NULL);
+	rz_table_add_row(t, "c", "0x100000000", NULL);
+
+	// by name, then by address for the same name
+	rz_table_sort(t, 1, false);
+	rz_table_sort(t, 0, false);
+	char *s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr        \n"
+		"-----------------\n"
+		"a    16\n"
+		"a    0x200000000\n"
+		"b    0x10\n"
+		"b    0x100000000\n"
+		"c    0x100000000\n",
+		"multi-key sort");
+	free(s);
+
+	// equal rows keep their order when sorting in decreasing order too
+	rz_table_sort(t, 1, true);
+	s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr        \n"
+		"-----------------\n"
+		"a    0x200000000\n"
+		"b    0x100000000\n"
+		"c    0x100000000\n"
+		"a    16\n"
+		"b    0x10\n",
+		"decreasing sort by 64-bit numbers");
+	free(s);
+
+	rz_table_group(t, 1, NULL);
+	s = rz_table_tostring(t);
+	mu_assert_streq(s,
+		"name addr        \n"
+		"-----------------\n"
+		"a    0x200000000\n"
+		"b    0x100000000\n"
+		"a    16\n",
+		"numbers are grouped by value");
+	free(s);
+	rz_table_free(t);
+	mu_end;
+}
+
 bool test_rz_table_uniq(void) {
 	RzTable *t = __table_test_data1();
 
@@ -359,6 +412,7 @@ bool all_tests() {
 	mu_run_test(test_rz_table_column_type);
 	mu_run_test(test_rz_table_tostring);
 	mu_run_test(test_rz_table_sort1);
+	mu_run_test(test_rz_table_sort_stable);
 	mu_run_test(test_rz_table_uniq);
 	mu_run_test(test_rz_table_group);
 	mu_run_test(test_rz_table_columns);
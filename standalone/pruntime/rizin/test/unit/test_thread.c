@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_th.h>
+#include "minunit.h"
+
+typedef struct {
+	int *calls;
+	RZ_TH_TID main;
+	bool zero_on_main;
+} ParallelForTest;
+
+static void parallel_for_cb(void *user, size_t i) {
+	ParallelForTest *t = user;
+	t->calls[i]++;
+	if (!i) {
+#if HAVE_PTHREAD
+		t->zero_on_main = pthread_equal(rz_th_self(), t->main);
+#else
+		t->zero_on_main = true;
+#endif
+	}
+}
+
+bool test_th_parallel_for(void) {
+	const size_t n = 1000;
+	ParallelForTest t = { 0 };
+	t.calls = RZ_NEWS0(int, n);
+	t.main = rz_th_self();
+	rz_th_parallel_for(n, parallel_for_cb, &t);
+	size_t i;
+	for (i = 0; i < n; i++) {
+		mu_assert_eq(t.calls[i], 1, "every index once");
+	}
+	mu_assert_true(t.zero_on_main, "index 0 on the calling thread");
+	rz_th_parallel_for(0, parallel_for_cb, &t);
+	mu_assert_eq(t.calls[0], 1, "nothing to do");
+	rz_th_parallel_for(1, parallel_for_cb, &t);
+	mu_assert_eq(t.calls[0], 2, "a single index");
+	free(t.calls);
+	mu_end;
+}
+
+bool all_tests() {
+	mu_run_test(test_th_parallel_for);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)